@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+
+namespace t81::tisc {
+
+// Compact execution encoding of Program::insns. Each instruction is an 8-byte record
+// holding the opcode, two operands narrowed to a byte and one operand in a 32-bit field,
+// with a selector naming which operand took the 32-bit field. Register operands always
+// fit a byte, so typical instructions (register-only arithmetic, LoadImm with a 32-bit
+// immediate, Load/Store with an address, jumps with a target) pack whole. Instructions
+// that do not fit (two operands outside [0, 255], or one outside int32) are kept whole
+// in a sparse side table. Reads decode back to the logical Insn by value.
+class PackedCode {
+ public:
+  PackedCode() = default;
+
+  explicit PackedCode(const std::vector<Insn>& insns) {
+    records_.reserve(insns.size());
+    for (const auto& insn : insns) {
+      push_back(insn);
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const { return records_.size(); }
+  [[nodiscard]] bool empty() const { return records_.empty(); }
+  // Instructions held in the side table.
+  [[nodiscard]] std::size_t wide_count() const { return wide_.size(); }
+
+  void clear() {
+    records_.clear();
+    wide_.clear();
+  }
+
+  void push_back(const Insn& insn) {
+    const std::int64_t operands[3] = {insn.a, insn.b, insn.c};
+    std::uint8_t slot = kSlotC;  // all operands fit a byte: c takes the 32-bit field
+    int outside_byte = 0;
+    for (std::uint8_t i = 0; i < 3; ++i) {
+      if (!fits_byte(operands[i]) && outside_byte++ == 0) {
+        slot = i;
+      }
+    }
+    Record r{.opcode = insn.opcode, .slot = slot, .narrow = {0, 0}, .wide = 0};
+    if (outside_byte > 1 || !fits_wide(operands[slot])) {
+      r.slot = kSlotSide;
+      wide_.emplace_back(records_.size(), insn);
+    } else {
+      r.wide = static_cast<std::int32_t>(operands[slot]);
+      std::size_t n = 0;
+      for (std::uint8_t i = 0; i < 3; ++i) {
+        if (i != slot) {
+          r.narrow[n++] = static_cast<std::uint8_t>(operands[i]);
+        }
+      }
+    }
+    records_.push_back(r);
+  }
+
+  // Forced inline: the interpreter's fetch sits in a dispatch function too large for
+  // the inliner's own heuristics.
+  [[gnu::always_inline]] Insn operator[](std::size_t pc) const {
+    const Record& r = records_[pc];
+    if (r.slot == kSlotSide) [[unlikely]] {
+      return side(pc);
+    }
+    const std::int64_t wide = r.wide;
+    return Insn{
+        r.opcode,
+        r.slot == kSlotA ? wide : r.narrow[0],
+        r.slot == kSlotB ? wide : r.narrow[r.slot == kSlotA ? 0 : 1],
+        r.slot == kSlotC ? wide : r.narrow[1],
+    };
+  }
+
+  // Opcode alone, without decoding the operands.
+  Opcode opcode(std::size_t pc) const { return records_[pc].opcode; }
+
+ private:
+  static constexpr std::uint8_t kSlotA = 0;
+  static constexpr std::uint8_t kSlotB = 1;
+  static constexpr std::uint8_t kSlotC = 2;
+  static constexpr std::uint8_t kSlotSide = 3;
+
+  // Kept out of line so the inlined common path stays small.
+  [[gnu::noinline]] Insn side(std::size_t pc) const {
+    const auto it = std::lower_bound(wide_.begin(), wide_.end(), pc,
+                                     [](const auto& w, std::size_t i) { return w.first < i; });
+    return it->second;
+  }
+
+  static bool fits_byte(std::int64_t v) { return v >= 0 && v <= std::numeric_limits<std::uint8_t>::max(); }
+  static bool fits_wide(std::int64_t v) {
+    return v >= std::numeric_limits<std::int32_t>::min() && v <= std::numeric_limits<std::int32_t>::max();
+  }
+
+  struct Record {
+    Opcode opcode;
+    std::uint8_t slot;
+    std::uint8_t narrow[2];
+    std::int32_t wide;
+  };
+  static_assert(sizeof(Record) == 8);
+
+  std::vector<Record> records_;
+  std::vector<std::pair<std::size_t, Insn>> wide_;
+};
+
+}  // namespace t81::tisc
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/jit.hpp"
+
+namespace t81::vm {
+
+// Ahead-of-time compilation for fixed production programs. emit_cpp() translates the
+// JIT's segments (jit::plan_segments) into portable C++ against the jit::Context ABI;
+// the host compiler turns that into a shared object, and AotModule loads it with dlopen.
+// A VM built with ExecutionMode::Aot and a matching module runs those segments in place
+// of the JIT's, with the same replay of steps, trace entries and Axion events, so
+// STATE_HASH and trap behavior stay identical to interpreter mode.
+
+// Version of the generated-code ABI (jit::Context layout and the exported symbols).
+// Bump whenever either changes; modules built for another version are rejected.
+inline constexpr std::uint32_t kAotAbiVersion = 1;
+
+// FNV-1a over the instruction stream and Axion policy text. A module only runs the
+// program it was generated from.
+std::uint64_t program_fingerprint(const t81::tisc::Program& program);
+
+// C++ source for `program`'s native segments, traced and untraced variants.
+std::string emit_cpp(const t81::tisc::Program& program);
+
+struct AotBuildResult {
+  bool ok = false;
+  std::string error;
+};
+
+// Writes emit_cpp() to `<so_path>.cpp` and compiles it into the shared object `so_path`
+// with `compiler` (empty: $CXX, else `c++`).
+AotBuildResult compile_aot(const t81::tisc::Program& program, const std::string& so_path,
+                           const std::string& compiler = "");
+
+class AotModule;
+
+struct AotLoadResult {
+  bool ok = false;
+  std::shared_ptr<const AotModule> module;
+  std::string error;
+};
+
+// A dlopen'ed module from compile_aot(). Immutable and shareable between VMs; the
+// library stays loaded while any VM using it is alive.
+class AotModule {
+ public:
+  static AotLoadResult open(const std::string& path);
+
+  AotModule(const AotModule&) = delete;
+  AotModule& operator=(const AotModule&) = delete;
+  ~AotModule();
+
+  [[nodiscard]] std::uint64_t fingerprint() const { return fingerprint_; }
+  [[nodiscard]] bool matches(const t81::tisc::Program& program) const {
+    return program_fingerprint(program) == fingerprint_;
+  }
+  // Segments for `program` (which must match), with write logging for traced VMs.
+  [[nodiscard]] std::vector<jit::Segment> segments(const t81::tisc::Program& program, bool log_writes) const;
+
+ private:
+  AotModule() = default;
+
+  struct Entry {
+    std::size_t begin = 0;
+    std::size_t length = 0;
+    jit::SegmentFn traced = nullptr;
+    jit::SegmentFn untraced = nullptr;
+  };
+
+  void* handle_ = nullptr;
+  std::uint64_t fingerprint_ = 0;
+  std::vector<Entry> entries_;
+};
+
+}  // namespace t81::vm
@@ -15,6 +15,25 @@ typedef struct t81vm_trace_entry {
   int trap;  // -1 when no trap, otherwise t81::vm::Trap integral value.
 } t81vm_trace_entry;
 
+typedef struct t81vm_block_tier {
+  size_t begin;  // leader pc
+  size_t end;    // exclusive
+  uint64_t entries;
+  int tier;  // 0: reference interpreter, 1: pre-decoded handlers
+  uint64_t promoted_at_step;
+} t81vm_block_tier;
+
+typedef struct t81vm_program_cache_stats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t stores;   // images written after a miss
+  uint64_t invalid;  // images found but rejected (damaged or stale); also misses
+} t81vm_program_cache_stats;
+
+// Receives batches of committed trace entries, in program order, while the VM runs.
+// `entries` is only valid for the duration of the call.
+typedef void (*t81vm_trace_callback)(const t81vm_trace_entry* entries, size_t count, void* user_data);
+
 t81vm_handle* t81vm_create(void);
 void t81vm_destroy(t81vm_handle* handle);
 
@@ -26,10 +45,53 @@ int t81vm_last_trap(const t81vm_handle* handle);
 size_t t81vm_pc(const t81vm_handle* handle);
 int t81vm_halted(const t81vm_handle* handle);
 uint64_t t81vm_state_hash(const t81vm_handle* handle);
+// fnv1a64-v2 state hash: covers the trace through its rolling digest (O(registers + memory)).
+uint64_t t81vm_state_hash_v2(const t81vm_handle* handle);
 int64_t t81vm_register(const t81vm_handle* handle, size_t index);
 
 size_t t81vm_trace_len(const t81vm_handle* handle);
 int t81vm_trace_get(const t81vm_handle* handle, size_t index, t81vm_trace_entry* out);
+// Streams trace entries to `callback` as they are produced; NULL detaches.
+int t81vm_set_trace_callback(t81vm_handle* handle, t81vm_trace_callback callback, void* user_data);
+
+// Switches the handle to flight-recorder tracing: only the last `depth` entries are kept
+// (depth 0 restores the default full trace). Resets the VM, so call before loading.
+int t81vm_set_flight_recorder(t81vm_handle* handle, size_t depth);
+// Retained flight-recorder entries, oldest first (index 0).
+size_t t81vm_flight_recorder_len(const t81vm_handle* handle);
+int t81vm_flight_recorder_get(const t81vm_handle* handle, size_t index, t81vm_trace_entry* out);
+// Writes the NUL-terminated flight_recorder_dump() text into `buf` (truncated to `size`)
+// and returns the full text length, excluding the terminator.
+size_t t81vm_flight_recorder_dump(const t81vm_handle* handle, char* buf, size_t size);
+
+// Enables (non-zero) or disables per-opcode/per-pc profiling. Resets the VM, so call
+// before loading; the profile covers every instruction run after the next load.
+int t81vm_set_profiling(t81vm_handle* handle, int enabled);
+// Execution count and cycle total for the instruction at `pc`; returns non-zero when
+// profiling is off or `pc` is out of range.
+int t81vm_profile_pc(const t81vm_handle* handle, size_t pc, uint64_t* count, uint64_t* cycles);
+// Write the NUL-terminated profile_report() / profile_folded() text into `buf` (truncated
+// to `size`) and return the full text length, excluding the terminator.
+size_t t81vm_profile_report(const t81vm_handle* handle, char* buf, size_t size);
+size_t t81vm_profile_folded(const t81vm_handle* handle, char* buf, size_t size);
+
+// Switches the handle to tiered execution, promoting a basic block to the pre-decoded
+// engine after `threshold` entries (0 restores interpreter mode). Resets the VM, so call
+// before loading.
+int t81vm_set_tiering(t81vm_handle* handle, uint64_t threshold);
+// Per-block hotness counters of a tiered handle, in program order (0 blocks otherwise).
+size_t t81vm_block_tier_count(const t81vm_handle* handle);
+int t81vm_block_tier_get(const t81vm_handle* handle, size_t index, t81vm_block_tier* out);
+// Writes the NUL-terminated tier_report() text into `buf` (truncated to `size`) and
+// returns the full text length, excluding the terminator.
+size_t t81vm_tier_report(const t81vm_handle* handle, char* buf, size_t size);
+
+// Serves t81vm_load_file() from the validated program images cached in `dir` (created on
+// first use), keyed by the program file's contents; NULL or "" disables the cache.
+// Statistics start from zero whenever the directory is set.
+int t81vm_set_program_cache(t81vm_handle* handle, const char* dir);
+// Hit/miss counters of the handle's program cache; non-zero when no cache is set.
+int t81vm_program_cache_stats_get(const t81vm_handle* handle, t81vm_program_cache_stats* out);
 
 #ifdef __cplusplus
 }  // extern "C"
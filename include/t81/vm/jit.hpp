@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/state.hpp"
+
+namespace t81::vm::jit {
+
+// Deterministic JIT (SPEC §3.2) for the scalar integer subset. Straight-line runs of
+// supported instructions inside a basic block ("segments") are compiled to native
+// x86-64 code that updates registers, tags, memory, sp and flags in place. Everything
+// the native code does not do itself — trace entries, Axion segment events, the step
+// counter — is replayed by the VM from the segment's static shape after it returns, so
+// observable output matches the interpreter entry for entry.
+//
+// Native code never traps: where an instruction could fault at run time (Div/Mod by
+// zero, Push/Pop at a stack bound) it leaves the segment before touching any state, and
+// the VM re-executes that instruction through the reference path. Call, Ret, Halt, Trap
+// and tensor/structured-value ops are not compiled; they end a segment and run through
+// the pre-decoded handlers.
+
+// Registers and state the native code reads and writes; built by the VM before a run.
+struct Context {
+  std::int64_t* registers = nullptr;
+  ValueTag* register_tags = nullptr;
+  std::int64_t* memory = nullptr;
+  std::uint8_t* dirty_pages = nullptr;  // MemoryPages::dirty
+  std::size_t* sp = nullptr;
+  Flags* flags = nullptr;
+  // Per-instruction write log (indexed by position in the segment), filled only when the
+  // program was compiled with `log_writes`; see write_kind().
+  std::int64_t* write_values = nullptr;
+  ValueTag* write_tags = nullptr;
+  std::size_t budget = 0;   // steps the segment may run; at least its length
+  std::size_t next_pc = 0;  // set by the segment on return
+};
+
+// Runs one segment; returns how many instructions completed. A segment whose last
+// instruction jumps back to its start and that keeps no write log loops natively while
+// `budget` covers another full pass, so the count can exceed Segment::length; instruction
+// i of the run is at begin + i % length. A count that is not a multiple of the length
+// means the instruction at next_pc must run on the reference path.
+using SegmentFn = std::size_t (*)(Context*);
+
+struct Segment {
+  std::size_t begin = 0;
+  std::size_t length = 0;
+  bool stores = false;  // contains a Store (which logs an Axion segment event)
+  SegmentFn fn = nullptr;
+};
+
+// What the trace entry of a compiled instruction writes: nothing, an Int-tagged value,
+// or a value whose tag is copied from the source register (Mov and conversions).
+enum class WriteKind : std::uint8_t { None, Int, Copy };
+
+WriteKind write_kind(t81::tisc::Opcode opcode);
+
+// True when this build and host can emit and run native code (x86-64 with mmap).
+bool available();
+
+// Segment boundaries for `program` loaded into `state` (fn left null): maximal runs of
+// compilable instructions inside one basic block, each ending at the latest after a
+// jump. Shared by the JIT and the AOT emitter so both compile the same segments.
+std::vector<Segment> plan_segments(const t81::tisc::Program& program, const State& state);
+
+// Native code for one loaded program. Move-only; owns its executable mapping.
+class NativeProgram {
+ public:
+  NativeProgram() = default;
+  NativeProgram(const NativeProgram&) = delete;
+  NativeProgram& operator=(const NativeProgram&) = delete;
+  NativeProgram(NativeProgram&& other) noexcept;
+  NativeProgram& operator=(NativeProgram&& other) noexcept;
+  ~NativeProgram();
+
+  // Compiles every segment of `program`. `state` is the freshly loaded state: memory
+  // size and segment layout are fixed from then on, so Load/Store addresses are checked
+  // here. `log_writes` emits the per-instruction write log needed for tracing.
+  void compile(const t81::tisc::Program& program, const State& state, bool log_writes);
+  // Installs segments compiled elsewhere (an AOT module); `owner` keeps their code alive.
+  void adopt(std::vector<Segment> segments, std::size_t program_size, std::shared_ptr<const void> owner);
+  void clear();
+
+  [[nodiscard]] bool empty() const { return segments_.empty(); }
+  [[nodiscard]] std::size_t max_length() const { return max_length_; }
+  [[nodiscard]] const Segment* segment_at(std::size_t pc) const {
+    return pc < index_.size() && index_[pc] >= 0 ? &segments_[static_cast<std::size_t>(index_[pc])] : nullptr;
+  }
+
+ private:
+  void* code_ = nullptr;
+  std::size_t code_size_ = 0;
+  std::vector<Segment> segments_;
+  std::vector<std::int32_t> index_;  // pc -> segment starting there, or -1
+  std::size_t max_length_ = 0;
+  std::shared_ptr<const void> owner_;
+};
+
+}  // namespace t81::vm::jit
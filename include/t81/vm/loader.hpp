@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <string>
 
 #include "t81/tisc/program.hpp"
 #include "t81/vm/state.hpp"
@@ -14,6 +16,16 @@ struct LoadedProgram {
   std::optional<Trap> preload_trap;
 };
 
+// Default segments for a program of `code_size` instructions: code, then stack, heap,
+// tensor and meta regions of fixed size, contiguous from address 0.
+MemoryLayout default_layout(std::size_t code_size);
+
+// The Policy named by an Axion policy text's `(tier N)` form, if any.
+std::optional<Policy> parse_policy(const std::string& text);
+
+// Zeroed memory for `layout`, with sp at the stack top and heap_ptr at the heap base.
+State initial_state(const MemoryLayout& layout, const std::optional<Policy>& policy);
+
 LoadedProgram load_program_image(const t81::tisc::Program& program);
 
 }  // namespace t81::vm
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace t81::vm {
+
+// Number of workers for `work` units when each worker should get at least `min_per_worker`
+// of them: 1 for small inputs, otherwise up to `threads` (0: the hardware concurrency).
+inline std::size_t parallel_width(std::size_t work, std::size_t min_per_worker, std::size_t threads) {
+  if (threads == 0) {
+    threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  }
+  return std::clamp<std::size_t>(work / std::max<std::size_t>(1, min_per_worker), 1, threads);
+}
+
+// Calls fn(i) for every i in [0, n), each on its own thread; i = 0 runs on the caller.
+// Results are returned through per-index slots, so reductions over them are
+// deterministic whatever the scheduling.
+template <typename Fn>
+void parallel_invoke(std::size_t n, Fn&& fn) {
+  std::vector<std::thread> workers;
+  workers.reserve(n > 0 ? n - 1 : 0);
+  for (std::size_t i = 1; i < n; ++i) {
+    workers.emplace_back([&fn, i] { fn(i); });
+  }
+  if (n > 0) {
+    fn(0);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+// [begin, end) of chunk `i` when `count` items are split into `chunks` near-equal
+// contiguous ranges.
+inline std::pair<std::size_t, std::size_t> chunk_range(std::size_t count, std::size_t chunks, std::size_t i) {
+  return {count * i / chunks, count * (i + 1) / chunks};
+}
+
+}  // namespace t81::vm
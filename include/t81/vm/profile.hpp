@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/vm.hpp"
+
+namespace t81::vm {
+
+struct ProfileCounter {
+  std::uint64_t count = 0;
+  std::uint64_t cycles = 0;
+};
+
+// One call path in the shadow call tree: the frame entered at `entry_pc` from `parent`.
+// Cycles are split by the opcode that spent them (the folded-stack leaf).
+struct ProfilePath {
+  std::size_t parent = 0;
+  std::size_t entry_pc = 0;
+  std::array<std::uint64_t, 256> cycles{};
+};
+
+// Execution counts and cycle totals collected by ProfilingVm. Cycles are TSC ticks on
+// x86 hosts (`clock == "tsc"`) and steady-clock nanoseconds elsewhere (`clock == "ns"`);
+// they are host measurements and never feed back into VM state.
+struct ExecutionProfile {
+  const char* clock = "ns";
+  std::uint64_t steps = 0;
+  std::uint64_t cycles = 0;
+  std::array<ProfileCounter, 256> by_opcode{};
+  std::vector<ProfileCounter> by_pc;            // indexed by pc
+  std::vector<std::size_t> block_leaders;       // ascending basic-block start pcs
+  std::vector<ProfileCounter> by_block;         // parallel to block_leaders
+  std::vector<t81::tisc::Opcode> opcode_at_pc;  // program opcodes, for reports
+  std::vector<ProfilePath> paths;               // paths[0] is the root frame ("main")
+};
+
+// Opt-in profiling wrapper. Every instruction is run through the wrapped VM's step(),
+// bracketed by cycle-counter reads and attributed to its pc, opcode and basic block; a
+// shadow call stack (Call/Ret) keys the folded-stack totals. run_to_halt() keeps the
+// reference budget semantics, so profiled runs produce the same state and trace as
+// unprofiled ones, only slower.
+class ProfilingVm final : public IVirtualMachine {
+ public:
+  explicit ProfilingVm(std::unique_ptr<IVirtualMachine> inner);
+
+  void load_program(const t81::tisc::Program& program) override;
+  void load_image(const LoadedProgram& image) override;
+  std::expected<void, Trap> step() override;
+  std::expected<void, Trap> run_to_halt(std::size_t max_steps = 100000) override;
+  const State& state() const override { return inner_->state(); }
+  void set_register(int idx, std::int64_t value, ValueTag tag = ValueTag::Int) override {
+    inner_->set_register(idx, value, tag);
+  }
+  void set_trace_sink(ITraceSink* sink) override { inner_->set_trace_sink(sink); }
+
+  [[nodiscard]] const ExecutionProfile& profile() const { return profile_; }
+
+ private:
+  void reset_profile(const t81::tisc::Program& program);
+
+  std::unique_ptr<IVirtualMachine> inner_;
+  ExecutionProfile profile_;
+  std::size_t path_ = 0;  // index into profile_.paths of the active call path
+  std::map<std::pair<std::size_t, std::size_t>, std::size_t> children_;  // (parent, entry pc) -> path
+};
+
+// Hot-spot report: totals, then the top `limit` opcodes, pcs and basic blocks by cycles.
+std::string profile_report(const ExecutionProfile& profile, std::size_t limit = 20);
+// Folded stacks (one "frame;frame;leaf weight" line per path) for flamegraph tools.
+std::string profile_folded(const ExecutionProfile& profile);
+
+}  // namespace t81::vm
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "t81/vm/loader.hpp"
+#include "t81/vm/program_io.hpp"
+
+namespace t81::vm {
+
+// On-disk cache of load_program_image() results. An entry is keyed by the BLAKE2b-256
+// hash of the source file's bytes, the format it is read as and kProgramImageVersion;
+// it holds the validated image (segment layout, parsed policy, preload trap) in front
+// of the decoded instructions as a tisc-bin-v1 container. A hit maps the entry and
+// skips parsing and validation; a missing, stale or damaged entry is a miss, after
+// which the bytes that were hashed are parsed and the entry is (re)written. Entries are
+// written to a temporary file and renamed into place, so processes sharing a directory
+// never see a partial one.
+//
+// Only the loader's products are cached. A hit copies the instructions into
+// LoadedProgram::program, and IVirtualMachine::load_image() still derives each engine's
+// own structures from them (packed code, resolved memory operands, block leaders, tag
+// inference, fusion and JIT/tier plans), which are linear in the program and depend on
+// the engine options.
+//
+// Image file `<hash>-<format>-v<version>.t81img`, all integers little-endian:
+//
+//   offset  size   field
+//   0       8      magic "T81IMAGE"
+//   8       4      image version (kProgramImageVersion)
+//   12      4      header size (160)
+//   16      32     BLAKE2b-256 of the source bytes
+//   48      8      source size
+//   56      1      source ProgramFormat
+//   57      1      flags: bit 0 preload trap set, bit 1 policy set
+//   58      2      preload Trap (0 when unset)
+//   60      4      policy tier (0 when unset)
+//   64      80     layout: code, stack, heap, tensor, meta as (start, limit) pairs
+//   144     8      reserved (0)
+//   152     8      FNV-1a 64 of bytes [0, 152)
+//   160            tisc-bin-v1 container of the program
+
+// Version of the image record and of what it caches. Bump whenever the header changes
+// or load_program_image() would build a different image (default layout, policy
+// parsing, validation rules); entries of another version are never read.
+inline constexpr std::uint32_t kProgramImageVersion = 2;
+inline constexpr char kProgramImageMagic[8] = {'T', '8', '1', 'I', 'M', 'A', 'G', 'E'};
+inline constexpr std::size_t kProgramImageHeaderSize = 160;
+
+struct ProgramImageResult {
+  bool ok = false;
+  ProgramFormat format = ProgramFormat::TextV1;
+  std::string error;
+  LoadedProgram image;
+  bool cache_hit = false;
+};
+
+// load_program_from_file() followed by load_program_image(), without a cache.
+ProgramImageResult load_program_image_from_file(const std::string& path, const ProgramLoadOptions& options = {});
+
+struct ProgramCacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t stores = 0;  // entries written after a miss
+  std::uint64_t invalid = 0;  // entries found but rejected (damaged or mismatched); also misses
+};
+
+class ProgramCache {
+ public:
+  // Entries live directly in `dir`, which is created on the first store.
+  explicit ProgramCache(std::string dir);
+
+  // load_program_image_from_file(), served from the cache when an entry for the file's
+  // current contents exists. Sources that fail to load are not cached. Failing to
+  // write an entry only costs the next load a miss.
+  ProgramImageResult load(const std::string& path, const ProgramLoadOptions& options = {});
+
+  [[nodiscard]] const std::string& dir() const { return dir_; }
+  [[nodiscard]] const ProgramCacheStats& stats() const { return stats_; }
+
+ private:
+  std::string dir_;
+  ProgramCacheStats stats_;
+};
+
+}  // namespace t81::vm
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include "t81/tisc/program.hpp"
 
@@ -9,6 +14,7 @@ namespace t81::vm {
 enum class ProgramFormat {
   TextV1,
   TiscJsonV1,
+  TiscBinV1,
 };
 
 struct ProgramLoadResult {
@@ -18,6 +24,110 @@ struct ProgramLoadResult {
   std::string error;
 };
 
-ProgramLoadResult load_program_from_file(const std::string& path);
+struct ProgramLoadOptions {
+  // Worker threads for parsing Text V1 and TISC JSON V1; 0 uses the hardware concurrency.
+  std::size_t threads = 0;
+  // Minimum input bytes per worker; smaller files are parsed on the calling thread.
+  std::size_t min_chunk_bytes = std::size_t{1} << 20;
+};
+
+// Picks the format by magic number (`tisc-bin-v1`), then by extension (`.json`: TISC
+// JSON V1, otherwise Text V1). Large text inputs are split at line (Text V1) or insn
+// object (TISC JSON V1) boundaries, parsed in parallel and stitched in file order; the
+// result, including which error is reported, is the same for any thread count.
+ProgramLoadResult load_program_from_file(const std::string& path, const ProgramLoadOptions& options = {});
+
+// A program file's bytes, mapped read-only where possible so the loaders scan the page
+// cache directly. Pipes, empty files and hosts without mmap() read the file into memory.
+// Callers that also key on the contents (ProgramCache) parse the same bytes they hash.
+class ProgramFile {
+ public:
+  ProgramFile() = default;
+  ProgramFile(const ProgramFile&) = delete;
+  ProgramFile& operator=(const ProgramFile&) = delete;
+  ~ProgramFile();
+
+  bool open(const std::string& path);
+
+  [[nodiscard]] const std::string& path() const { return path_; }
+  [[nodiscard]] std::string_view bytes() const {
+    return map_ != nullptr ? std::string_view(static_cast<const char*>(map_), size_) : std::string_view(buffer_);
+  }
+  // The format load_program_from_file() reads the file as.
+  [[nodiscard]] ProgramFormat format() const;
+
+ private:
+  std::string path_;
+  void* map_ = nullptr;
+  std::size_t size_ = 0;
+  std::string buffer_;
+};
+
+// load_program_from_file() on an opened file.
+ProgramLoadResult parse_program_file(const ProgramFile& file, const ProgramLoadOptions& options = {});
+
+// Binary container `tisc-bin-v1` (`*.tiscb`), all integers little-endian:
+//
+//   offset  size   field
+//   0       8      magic "T81TISCB"
+//   8       4      container version (1)
+//   12      4      header size (64)
+//   16      16     spec_version the program requires, ASCII, NUL-padded
+//   32      8      instruction count n
+//   40      8      policy blob size p
+//   48      8      FNV-1a 64 of bytes [64, 64 + 32n + p)
+//   56      8      reserved (0)
+//   64      32n    instruction table: opcode byte, 7 zero bytes, then a, b, c as int64
+//   64+32n  p      Axion policy text (UTF-8, no terminator)
+//
+// Table entries have the in-memory layout of t81::tisc::Insn, so a mapped container is
+// read in place: opening one checks the header, checksum and opcode bytes, nothing is
+// parsed or copied.
+inline constexpr char kTiscBinMagic[8] = {'T', '8', '1', 'T', 'I', 'S', 'C', 'B'};
+inline constexpr std::uint32_t kTiscBinVersion = 1;
+inline constexpr std::size_t kTiscBinHeaderSize = 64;
+inline constexpr std::size_t kTiscBinInsnSize = 32;
+inline constexpr std::string_view kTiscSpecVersion = "tisc-v1";
+
+// The `tisc-bin-v1` bytes for `program`.
+std::string encode_tisc_bin_v1(const t81::tisc::Program& program);
+
+class MappedProgram;
+
+struct MappedProgramResult {
+  bool ok = false;
+  std::shared_ptr<const MappedProgram> program;
+  std::string error;
+};
+
+// A read-only mmap of a `tisc-bin-v1` file. Immutable and shareable; the mapping stays
+// valid while any reference is alive.
+class MappedProgram {
+ public:
+  // `offset` is where the container starts in the file (a multiple of 8, keeping the
+  // table aligned); the bytes before it are mapped too and exposed as prefix().
+  static MappedProgramResult open(const std::string& path, std::size_t offset = 0);
+
+  MappedProgram(const MappedProgram&) = delete;
+  MappedProgram& operator=(const MappedProgram&) = delete;
+  ~MappedProgram();
+
+  [[nodiscard]] std::span<const t81::tisc::Insn> insns() const { return insns_; }
+  [[nodiscard]] std::string_view axion_policy_text() const { return policy_; }
+  [[nodiscard]] std::string_view spec_version() const { return spec_version_; }
+  [[nodiscard]] std::string_view prefix() const { return prefix_; }
+  // An owning Program (one bulk copy of the table), for IVirtualMachine::load_program.
+  [[nodiscard]] t81::tisc::Program to_program() const;
+
+ private:
+  MappedProgram() = default;
+
+  void* base_ = nullptr;
+  std::size_t size_ = 0;
+  std::span<const t81::tisc::Insn> insns_;
+  std::string_view policy_;
+  std::string_view spec_version_;
+  std::string_view prefix_;
+};
 
 }  // namespace t81::vm
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <utility>
@@ -43,6 +45,17 @@ inline const char* to_string(ValueTag tag) {
   return "UnknownTag";
 }
 
+// How much per-step trace bookkeeping an interpreter instance performs. Selected when
+// the VM is created; disabled levels are compiled out of the execution loop.
+enum class TraceLevel : std::uint8_t {
+  Full = 0,  // every committed step is appended to State::trace (contract default)
+  Digest,    // entries are only folded into State::trace_digest (STATE_HASH_V2 only)
+  None,      // no trace is kept; STATE_HASH is not defined for such runs
+  // Only the most recent entries are kept, in State::flight_recorder (fixed depth,
+  // allocated once at load); entries are also folded into the digest.
+  FlightRecorder,
+};
+
 struct TraceEntry {
   std::size_t pc;
   t81::tisc::Opcode opcode;
@@ -52,6 +65,214 @@ struct TraceEntry {
   std::optional<Trap> trap;
 };
 
+// Packed storage for State::trace. Each step is a fixed 16-byte record appended to
+// fixed-size chunks, so long runs never reallocate or copy earlier entries. Entries that
+// do not fit a record (traps, pc >= 2^32, register index >= 2^16) are kept whole in a
+// sparse side table. Reads decode back to the logical TraceEntry by value.
+class TraceLog {
+ public:
+  static constexpr std::size_t kChunkShift = 16;
+  static constexpr std::size_t kChunkRecords = std::size_t{1} << kChunkShift;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TraceEntry;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = TraceEntry;
+
+    const_iterator() = default;
+    const_iterator(const TraceLog* log, std::size_t index) : log_(log), index_(index) {}
+
+    TraceEntry operator*() const { return (*log_)[index_]; }
+    const_iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto copy = *this;
+      ++index_;
+      return copy;
+    }
+    bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+
+   private:
+    const TraceLog* log_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size_}; }
+  TraceEntry back() const { return (*this)[size_ - 1]; }
+
+  void clear() {
+    chunks_.clear();
+    wide_.clear();
+    size_ = 0;
+  }
+
+  void push_back(const TraceEntry& e) {
+    if ((size_ & (kChunkRecords - 1)) == 0) {
+      chunks_.emplace_back();
+      chunks_.back().reserve(kChunkRecords);
+    }
+    Record r{};
+    r.pc = static_cast<std::uint32_t>(e.pc);
+    r.opcode = static_cast<std::uint8_t>(e.opcode);
+    if (e.write_reg.has_value()) {
+      r.bits |= kHasReg;
+      r.write_reg = static_cast<std::uint16_t>(*e.write_reg);
+    }
+    if (e.write_value.has_value()) {
+      r.bits |= kHasValue;
+      r.write_value = *e.write_value;
+    }
+    if (e.write_tag.has_value()) {
+      r.bits |= kHasTag;
+      r.tag = static_cast<std::uint8_t>(*e.write_tag);
+    }
+    if (e.trap.has_value() || e.pc > UINT32_MAX || (e.write_reg.has_value() && *e.write_reg > UINT16_MAX)) {
+      r.bits |= kWide;
+      wide_.emplace_back(size_, e);
+    }
+    chunks_.back().push_back(r);
+    ++size_;
+  }
+
+  TraceEntry operator[](std::size_t index) const {
+    const Record& r = chunks_[index >> kChunkShift][index & (kChunkRecords - 1)];
+    if ((r.bits & kWide) != 0) {
+      const auto it = std::lower_bound(wide_.begin(), wide_.end(), index,
+                                       [](const auto& w, std::size_t i) { return w.first < i; });
+      return it->second;
+    }
+    return TraceEntry{
+        .pc = r.pc,
+        .opcode = static_cast<t81::tisc::Opcode>(r.opcode),
+        .write_reg = (r.bits & kHasReg) != 0 ? std::optional<std::size_t>(r.write_reg) : std::nullopt,
+        .write_value = (r.bits & kHasValue) != 0 ? std::optional<std::int64_t>(r.write_value) : std::nullopt,
+        .write_tag = (r.bits & kHasTag) != 0 ? std::optional<ValueTag>(static_cast<ValueTag>(r.tag)) : std::nullopt,
+        .trap = std::nullopt,
+    };
+  }
+
+ private:
+  static constexpr std::uint8_t kHasReg = 1U << 0;
+  static constexpr std::uint8_t kHasValue = 1U << 1;
+  static constexpr std::uint8_t kHasTag = 1U << 2;
+  static constexpr std::uint8_t kWide = 1U << 3;
+
+  struct Record {
+    std::int64_t write_value;
+    std::uint32_t pc;
+    std::uint16_t write_reg;
+    std::uint8_t opcode;
+    std::uint8_t bits : 4;
+    std::uint8_t tag : 4;
+  };
+  static_assert(sizeof(Record) == 16);
+  static_assert(static_cast<unsigned>(ValueTag::EnumHandle) < 16, "ValueTag must fit the 4-bit record field");
+
+  std::vector<std::vector<Record>> chunks_;
+  std::vector<std::pair<std::size_t, TraceEntry>> wide_;
+  std::size_t size_ = 0;
+};
+
+// Rolling digest of the committed trace, folded by the interpreter as each entry is
+// produced (FNV-1a over the entry's 64-bit words, same word order state_hash() uses).
+// Lets STATE_HASH_V2 cover the whole trace without storing or re-walking it.
+struct TraceDigest {
+  static constexpr std::uint64_t kOffsetBasis = 1469598103934665603ULL;
+  static constexpr std::uint64_t kPrime = 1099511628211ULL;
+
+  std::uint64_t length = 0;
+  std::uint64_t value = kOffsetBasis;
+
+  void fold(const TraceEntry& e) {
+    mix(e.pc);
+    mix(static_cast<std::uint64_t>(e.opcode));
+    mix(e.write_reg.has_value() ? static_cast<std::uint64_t>(*e.write_reg + 1U) : 0ULL);
+    mix(e.write_value.has_value() ? static_cast<std::uint64_t>(*e.write_value) : 0ULL);
+    mix(e.write_tag.has_value() ? static_cast<std::uint64_t>(*e.write_tag) + 1ULL : 0ULL);
+    mix(e.trap.has_value() ? static_cast<std::uint64_t>(*e.trap) : 0ULL);
+    ++length;
+  }
+
+ private:
+  void mix(std::uint64_t word) {
+    value ^= word;
+    value *= kPrime;
+  }
+};
+
+// Fixed-capacity ring of the most recent trace entries for TraceLevel::FlightRecorder.
+// Slots are allocated by reset() when a program is loaded; push() never allocates.
+class FlightRecorder {
+ public:
+  void reset(std::size_t depth) {
+    slots_.assign(depth == 0 ? 1 : depth, TraceEntry{});
+    next_ = 0;
+    recorded_ = 0;
+  }
+
+  void push(const TraceEntry& entry) {
+    slots_[next_] = entry;
+    if (++next_ == slots_.size()) {
+      next_ = 0;
+    }
+    ++recorded_;
+  }
+
+  [[nodiscard]] std::size_t depth() const { return slots_.size(); }
+  // Entries committed since load, including those already overwritten.
+  [[nodiscard]] std::uint64_t recorded() const { return recorded_; }
+  [[nodiscard]] std::size_t size() const {
+    return recorded_ < slots_.size() ? static_cast<std::size_t>(recorded_) : slots_.size();
+  }
+  [[nodiscard]] bool empty() const { return recorded_ == 0; }
+
+  // Oldest retained entry first.
+  const TraceEntry& operator[](std::size_t index) const {
+    const std::size_t start = recorded_ < slots_.size() ? 0 : next_;
+    const std::size_t slot = start + index;
+    return slots_[slot < slots_.size() ? slot : slot - slots_.size()];
+  }
+
+ private:
+  std::vector<TraceEntry> slots_;
+  std::size_t next_ = 0;
+  std::uint64_t recorded_ = 0;
+};
+
+// Page-granular dirty tracking for State::memory. The interpreter marks the page of every
+// memory write; state_hash(V2) re-digests only dirty pages and combines the cached
+// per-page digests, so checkpoint hashing scales with pages touched since the last one.
+// The caches are mutable so hashing a const State can refresh them; hosts that write
+// State::memory directly must call invalidate_all().
+struct MemoryPages {
+  static constexpr std::size_t kPageWords = 64;
+
+  mutable std::vector<std::uint64_t> digests;
+  mutable std::vector<std::uint8_t> dirty;
+
+  void reset(std::size_t memory_words) {
+    const std::size_t pages = (memory_words + kPageWords - 1) / kPageWords;
+    digests.assign(pages, 0);
+    dirty.assign(pages, 1);
+  }
+
+  void mark(std::size_t addr) { dirty[addr / kPageWords] = 1; }
+
+  void invalidate_all() const { std::fill(dirty.begin(), dirty.end(), 1); }
+
+  [[nodiscard]] std::size_t dirty_pages() const {
+    return static_cast<std::size_t>(std::count(dirty.begin(), dirty.end(), 1));
+  }
+};
+
 struct Flags {
   bool zero = false;
   bool negative = false;
@@ -103,9 +324,101 @@ struct MemoryLayout {
   [[nodiscard]] std::size_t total_size() const { return meta.limit; }
 };
 
+// What an Axion event records. The stable reason text each code renders to is part of
+// the observation surface (see AxionEvent::reason()).
+enum class AxionReason : std::uint8_t {
+  SegmentAccess = 0,         // segment access <segment>
+  BoundsFault,               // bounds fault segment=<segment> addr=<addr> action=<action>
+  Guard,                     // <Op> guard segment=<segment> addr=<addr> [value=<value>] allow|deny=tier0
+  WeightsHandleLoaded,
+  StackFrameAllocated,
+  StackFrameFreed,
+  HeapBlockAllocated,
+  HeapBlockFreed,
+};
+
+// Action named by a BoundsFault event.
+enum class AxionAction : std::uint8_t {
+  None = 0,
+  MemoryLoad,
+  MemoryStore,
+  StackPush,
+  StackPop,
+  StackFrameAllocate,
+  HeapBlockAllocate,
+};
+
+inline const char* to_string(AxionAction action) {
+  switch (action) {
+    case AxionAction::MemoryLoad:
+      return "memory load";
+    case AxionAction::MemoryStore:
+      return "memory store";
+    case AxionAction::StackPush:
+      return "stack push";
+    case AxionAction::StackPop:
+      return "stack pop";
+    case AxionAction::StackFrameAllocate:
+      return "stack frame allocate";
+    case AxionAction::HeapBlockAllocate:
+      return "heap block allocate";
+    case AxionAction::None:
+      break;
+  }
+  return "none";
+}
+
+// Fixed-size Axion observation record. The interpreter only copies these fields into
+// State::axion_log; the reason text is rendered on demand by reason().
 struct AxionEvent {
   t81::tisc::Opcode opcode;
-  std::string reason;
+  AxionReason code = AxionReason::SegmentAccess;
+  AxionAction action = AxionAction::None;
+  MemorySegmentKind segment = MemorySegmentKind::Unknown;
+  bool denied = false;
+  bool has_value = false;
+  std::int64_t addr = 0;
+  std::int64_t value = 0;
+
+  [[nodiscard]] std::string reason() const {
+    switch (code) {
+      case AxionReason::SegmentAccess:
+        return std::string("segment access ") + to_string(segment);
+      case AxionReason::BoundsFault:
+        return std::string("bounds fault segment=") + to_string(segment) + " addr=" + std::to_string(addr) +
+               " action=" + to_string(action);
+      case AxionReason::Guard: {
+        std::string out = opcode == t81::tisc::Opcode::AxRead  ? "AxRead guard"
+                          : opcode == t81::tisc::Opcode::AxSet ? "AxSet guard"
+                                                               : "AxVerify guard";
+        out += std::string(" segment=") + to_string(segment) + " addr=" + std::to_string(addr);
+        if (has_value) {
+          out += " value=" + std::to_string(value);
+        }
+        out += denied ? " deny=tier0" : " allow";
+        return out;
+      }
+      case AxionReason::WeightsHandleLoaded:
+        return "weights handle loaded";
+      case AxionReason::StackFrameAllocated:
+        return "stack frame allocated";
+      case AxionReason::StackFrameFreed:
+        return "stack frame freed";
+      case AxionReason::HeapBlockAllocated:
+        return "heap block allocated";
+      case AxionReason::HeapBlockFreed:
+        return "heap block freed";
+    }
+    return {};
+  }
+};
+
+// Which Axion events an interpreter instance records. Selected when the VM is created;
+// dropped event classes are compiled out of the execution loop.
+enum class AxionLogLevel : std::uint8_t {
+  All = 0,          // every event (contract default)
+  NoSegmentAccess,  // everything except per-access SegmentAccess events
+  Off,              // State::axion_log stays empty
 };
 
 struct Policy {
@@ -147,17 +460,38 @@ struct TrapPayload {
   std::string detail;
 };
 
-struct State {
+// Hotness record of one basic block under ExecutionMode::Tiered. Entries count every
+// dispatch of the block's leader by run_to_halt(); single step() calls are not counted.
+struct BlockTier {
+  std::size_t begin = 0;  // leader pc
+  std::size_t end = 0;    // exclusive
+  std::uint64_t entries = 0;
+  std::uint8_t tier = 0;  // 0: reference interpreter, 1: pre-decoded handlers
+  std::uint64_t promoted_at_step = 0;  // step count when the block reached tier 1
+};
+
+// The fields the engines touch on nearly every step, grouped at the front of State:
+// pc, sp, flags, halted and the memory vector share the first cache line, followed by
+// the register file and its tags. Everything else in State (logs, value pools, trace,
+// policy) is only reached by the instructions that need it.
+struct alignas(64) ExecContext {
   std::size_t pc = 0;
+  std::size_t sp = 0;
+  std::vector<std::int64_t> memory;
+  Flags flags{};
   bool halted = false;
   std::array<std::int64_t, 243> registers{};
   std::array<ValueTag, 243> register_tags{};
-  std::vector<std::int64_t> memory;
-  std::vector<TraceEntry> trace;
-  std::vector<AxionEvent> axion_log;
-  Flags flags{};
+};
+
+// Hosts see one flat State; the hot fields are inherited from ExecContext.
+struct State : ExecContext {
+  MemoryPages memory_pages{};
   MemoryLayout layout{};
-  std::size_t sp = 0;
+  TraceLog trace;
+  TraceDigest trace_digest{};
+  FlightRecorder flight_recorder;
+  std::vector<AxionEvent> axion_log;
   std::size_t heap_ptr = 0;
   std::vector<std::pair<std::size_t, std::size_t>> stack_frames;
   std::vector<std::pair<std::size_t, std::size_t>> heap_frames;
@@ -169,6 +503,8 @@ struct State {
   std::optional<TrapPayload> last_trap_payload;
   std::optional<Policy> policy;
   std::size_t gc_cycles = 0;
+  TraceLevel trace_level = TraceLevel::Full;
+  std::vector<BlockTier> block_tiers;  // ExecutionMode::Tiered only, in program order
 };
 
 }  // namespace t81::vm
@@ -7,8 +7,29 @@
 
 namespace t81::vm {
 
+enum class StateHashVersion {
+  // fnv1a64-v1: walks every State::trace entry; the published STATE_HASH value.
+  V1 = 1,
+  // fnv1a64-v2: same header and registers, but memory contributes its size and the
+  // combined per-page digests (only dirty pages are re-hashed) and the trace contributes
+  // State::trace_digest (length + rolling value); cost tracks pages touched since the
+  // previous hash rather than trace or memory size.
+  V2 = 2,
+};
+
 std::uint64_t state_hash(const State& state);
+std::uint64_t state_hash(const State& state, StateHashVersion version);
 std::string snapshot_summary(const State& state);
+// One canonical `--trace` line (without the trailing newline).
+std::string trace_line(const TraceEntry& entry);
 std::string trap_payload_summary_line(const State& state);
+// Flight-recorder contents for TraceLevel::FlightRecorder runs: a
+// `FLIGHT_RECORDER depth=N recorded=N kept=N` header, then one canonical trace line per
+// retained entry, oldest first. Empty for other trace levels.
+std::string flight_recorder_dump(const State& state);
+// Tiered-execution counters: a `TIER_REPORT blocks=N promoted=N` header, then one
+// `TIER_BLOCK begin=N end=N entries=N tier=N [promoted_at_step=N]` line per basic block
+// in program order. Empty for other execution modes.
+std::string tier_report(const State& state);
 
 }  // namespace t81::vm
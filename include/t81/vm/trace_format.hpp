@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "t81/vm/state.hpp"
+#include "t81/vm/trace_sink.hpp"
+
+namespace t81::vm {
+
+// Binary trace format `trace-bin-v1`.
+//
+//   header:  "T81TRB" 0x01 0x00            (magic, format version, reserved)
+//   literal: flags byte (< 0x80), then      (one TraceEntry)
+//              [pc delta]     zigzag varint of pc - (previous pc + 1), unless flag 0x10
+//              opcode         one byte
+//              [write reg]    varint                                   (flag 0x01)
+//              [write value]  zigzag varint of value - last value written to that
+//                             register (0 for a register not yet written) (flag 0x02)
+//              [write tag]    one byte                                 (flag 0x04)
+//              [trap]         one byte                                 (flag 0x08)
+//   repeat:  0x80, varint offset, varint count
+//            replays `count` entries, each re-decoding the encoded bytes of the entry
+//            `offset` positions earlier (overlap allowed).
+//
+// Because pcs and write values are stored as deltas, every iteration of a steady-state
+// loop encodes to identical bytes, and the writer collapses it into one repeat record.
+inline constexpr char kBinaryTraceMagic[6] = {'T', '8', '1', 'T', 'R', 'B'};
+inline constexpr std::uint8_t kBinaryTraceVersion = 1;
+
+class BinaryTraceWriter final : public ITraceSink {
+ public:
+  // How far back (in entries) the writer looks for a repeated loop body.
+  static constexpr std::size_t kWindow = 64;
+
+  explicit BinaryTraceWriter(std::ostream& out);
+  ~BinaryTraceWriter() override;
+  BinaryTraceWriter(const BinaryTraceWriter&) = delete;
+  BinaryTraceWriter& operator=(const BinaryTraceWriter&) = delete;
+
+  void write(const TraceEntry& entry);
+  void on_entries(std::span<const TraceEntry> batch) override;
+  // Emits any pending repeat and flushes the stream. Idempotent; also run on destruction.
+  void finish();
+
+ private:
+  void emit_literal(const std::string& encoded);
+  void close_match();
+
+  std::ostream& out_;
+  std::size_t prev_pc_ = static_cast<std::size_t>(-1);
+  std::vector<std::int64_t> last_values_;
+  std::deque<std::string> history_;  // encoded bytes of the last kWindow entries
+  std::vector<std::size_t> candidates_;
+  std::size_t match_offset_ = 0;
+  std::size_t match_length_ = 0;
+  std::vector<std::string> pending_;  // entries covered by the open match
+  bool finished_ = false;
+};
+
+class BinaryTraceReader {
+ public:
+  explicit BinaryTraceReader(std::istream& in);
+
+  // Next decoded entry, or nullopt at end of stream or on a format error (see error()).
+  std::optional<TraceEntry> next();
+  [[nodiscard]] const std::string& error() const { return error_; }
+
+ private:
+  std::optional<TraceEntry> decode(const std::string& encoded);
+  bool read_literal(std::string* encoded);
+  bool fail(const std::string& message);
+
+  std::istream& in_;
+  std::size_t prev_pc_ = static_cast<std::size_t>(-1);
+  std::vector<std::int64_t> last_values_;
+  std::deque<std::string> history_;
+  std::size_t repeat_offset_ = 0;
+  std::size_t repeat_left_ = 0;
+  std::string error_;
+};
+
+// Decodes a trace-bin-v1 stream and writes the canonical `--trace` text to `out`.
+// Returns an empty string on success, otherwise the decode error.
+std::string convert_binary_trace_to_text(std::istream& in, std::ostream& out);
+
+}  // namespace t81::vm
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "t81/vm/state.hpp"
+
+namespace t81::vm {
+
+// Streaming consumer of committed trace entries. An attached VM hands over entries in
+// program order, in batches, as they are produced (a batch is delivered when it fills
+// and before step()/run_to_halt() return), independently of State::trace storage.
+// Entries are only produced when the VM's TraceLevel is not None.
+class ITraceSink {
+ public:
+  virtual ~ITraceSink() = default;
+  virtual void on_entries(std::span<const TraceEntry> batch) = 0;
+};
+
+enum class TraceFileFormat {
+  Text,    // canonical `--trace` lines
+  Binary,  // trace-bin-v1 (see trace_format.hpp)
+};
+
+// Built-in sink that writes the trace to `path` in `format` from a background thread.
+// The VM thread only copies entries into a bounded single-producer/single-consumer
+// lock-free ring of `capacity` entries (rounded up to a power of two) and waits for
+// space only when the writer falls that far behind. Destruction drains the ring and
+// closes the file.
+class FileTraceSink final : public ITraceSink {
+ public:
+  explicit FileTraceSink(const std::string& path, std::size_t capacity = 1U << 16,
+                         TraceFileFormat format = TraceFileFormat::Text);
+  ~FileTraceSink() override;
+  FileTraceSink(const FileTraceSink&) = delete;
+  FileTraceSink& operator=(const FileTraceSink&) = delete;
+
+  [[nodiscard]] bool ok() const;
+  void on_entries(std::span<const TraceEntry> batch) override;
+  // Blocks until every entry handed over so far has been written and flushed. In Binary
+  // format an open repeat record is only emitted when the sink is destroyed.
+  void flush();
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace t81::vm
@@ -1,13 +1,44 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <vector>
 
 #include "t81/tisc/program.hpp"
+#include "t81/vm/state.hpp"
 #include "t81/vm/traps.hpp"
 
 namespace t81::vm {
 
-// Performs static validation that does not require runtime state.
-std::optional<Trap> validate_program(const t81::tisc::Program& program);
+struct ValidateOptions {
+  // Worker threads; 0 uses the hardware concurrency.
+  std::size_t threads = 0;
+  // Minimum instructions per worker; smaller programs are checked on the calling thread.
+  std::size_t min_chunk_insns = std::size_t{1} << 16;
+};
+
+// Performs static validation that does not require runtime state. Large programs are
+// checked in parallel chunks; the result is the same for any chunking.
+std::optional<Trap> validate_program(const t81::tisc::Program& program, const ValidateOptions& options = {});
+
+// Start pcs of the program's basic blocks, ascending: pc 0, every in-range static jump
+// target, and the instruction after each jump, call, return, halt or trap. Call targets
+// are register-indirect and therefore not leaders unless reached by one of the above.
+std::vector<std::size_t> basic_block_leaders(const t81::tisc::Program& program);
+
+// Outcome of an instruction's operand tag checks (the TypeFault raised by tensor and
+// structured-value ops) on every path from pc 0 with all registers Int.
+enum class TagCheck : std::uint8_t {
+  None,     // the instruction checks no tags
+  Pass,     // every check passes whenever the instruction runs
+  Fail,     // a check fails whenever the instruction runs
+  Dynamic,  // depends on the path, or the instruction was not proven reachable
+};
+
+// Per-pc TagCheck from a forward dataflow pass inferring the ValueTags each register may
+// hold at each program point. Call targets are resolved from LoadImm constants; a Call
+// through a register without one leaves every check Dynamic. Proofs assume the host
+// does not write registers (IVirtualMachine::set_register) after load.
+std::vector<TagCheck> infer_tag_checks(const t81::tisc::Program& program);
 
 }  // namespace t81::vm
@@ -6,20 +6,67 @@
 #include <memory>
 
 #include "t81/tisc/program.hpp"
+#include "t81/vm/loader.hpp"
 #include "t81/vm/state.hpp"
+#include "t81/vm/trace_sink.hpp"
 
 namespace t81::vm {
 
+enum class ExecutionMode {
+  Interpreter,
+  // Opt-in preview backend: the program is pre-decoded once into a handler stream and
+  // run a basic block at a time, with budget checks at block boundaries. Must stay
+  // observably identical to Interpreter.
+  AcceleratedPreview,
+  // Deterministic JIT (SPEC §3.2): the AcceleratedPreview engine with straight-line runs
+  // of scalar integer/control instructions compiled to native x86-64 code (see jit.hpp).
+  // Hosts without JIT support run the AcceleratedPreview engine unchanged.
+  Jit,
+  // The Jit engine running segments from a precompiled module (VmOptions::aot_module,
+  // see aot.hpp) instead of compiling them at load. Programs the module was not built
+  // from run on the AcceleratedPreview engine.
+  Aot,
+  // Starts every basic block on the reference interpreter path and counts its entries;
+  // a block reaching VmOptions::tier_up_threshold is promoted to the AcceleratedPreview
+  // handlers. Promotion happens between instructions, so it is observably neutral. The
+  // counters are exported in State::block_tiers.
+  Tiered,
+};
+
+class AotModule;
+
+// Construction-time knobs. Trace and Axion bookkeeping are static properties of the
+// returned instance: disabled features are compiled out of its execution loop.
+struct VmOptions {
+  ExecutionMode mode = ExecutionMode::Interpreter;
+  TraceLevel trace = TraceLevel::Full;
+  // Ring depth for TraceLevel::FlightRecorder; ignored for other levels.
+  std::size_t flight_recorder_depth = 4096;
+  AxionLogLevel axion_log = AxionLogLevel::All;
+  // Native segments for ExecutionMode::Aot; ignored by other modes.
+  std::shared_ptr<const AotModule> aot_module = nullptr;
+  // Block entries after which ExecutionMode::Tiered promotes a block; ignored by other
+  // modes.
+  std::uint64_t tier_up_threshold = 64;
+};
+
 class IVirtualMachine {
  public:
   virtual ~IVirtualMachine() = default;
   virtual void load_program(const t81::tisc::Program& program) = 0;
+  // load_program() from an already built image (load_program_image() or a ProgramCache
+  // hit), without validating the program again.
+  virtual void load_image(const LoadedProgram& image) = 0;
   virtual std::expected<void, Trap> step() = 0;
   virtual std::expected<void, Trap> run_to_halt(std::size_t max_steps = 100000) = 0;
   virtual const State& state() const = 0;
   virtual void set_register(int idx, std::int64_t value, ValueTag tag = ValueTag::Int) = 0;
+  // Streams committed trace entries to `sink` (not owned; nullptr detaches). Pending
+  // entries are delivered to the previous sink before it is replaced.
+  virtual void set_trace_sink(ITraceSink* sink) = 0;
 };
 
 std::unique_ptr<IVirtualMachine> make_interpreter_vm();
+std::unique_ptr<IVirtualMachine> make_vm(const VmOptions& options);
 
 }  // namespace t81::vm
@@ -23,7 +23,7 @@ REQUIRED_TOP_LEVEL = {
     "host_abi",
 }
 
-REQUIRED_FORMATS = {"TextV1", "TiscJsonV1"}
+REQUIRED_FORMATS = {"TextV1", "TiscJsonV1", "TiscBinV1"}
 REQUIRED_TRAPS = {"DecodeFault", "TypeFault", "DivisionFault", "TrapInstruction"}
 REQUIRED_EXECUTION_MODES = {"interpreter", "accelerated-preview"}
 REQUIRED_PARITY_SIGNALS = {"STATE_HASH", "TRAP_CLASS", "TRAP_PAYLOAD"}
@@ -28,6 +28,11 @@ def parse_args() -> argparse.Namespace:
         default="docs/benchmarks/vm-perf-baseline.json",
         help="Baseline JSON file",
     )
+    parser.add_argument(
+        "--mode",
+        default="interpreter",
+        help="Execution mode passed to t81vm --mode",
+    )
     parser.add_argument(
         "--report-out",
         default="build/perf/runtime-bench-report.json",
@@ -50,10 +55,10 @@ def render_program(iterations: int) -> str:
     )
 
 
-def run_vm(vm_bin: str, program_path: str, max_steps: int) -> tuple[float, str]:
+def run_vm(vm_bin: str, program_path: str, max_steps: int, mode: str) -> tuple[float, str]:
     started = time.perf_counter()
     proc = subprocess.run(
-        [vm_bin, "--snapshot", "--max-steps", str(max_steps), program_path],
+        [vm_bin, "--snapshot", "--max-steps", str(max_steps), "--mode", mode, program_path],
         text=True,
         capture_output=True,
         check=False,
@@ -87,12 +92,12 @@ def main() -> int:
         program.write_text(render_program(iterations), encoding="utf-8")
 
         for _ in range(warmup_runs):
-            run_vm(args.vm_bin, str(program), max_steps)
+            run_vm(args.vm_bin, str(program), max_steps, args.mode)
 
         timings: list[float] = []
         hashes: list[str] = []
         for _ in range(measure_runs):
-            elapsed_s, state_hash = run_vm(args.vm_bin, str(program), max_steps)
+            elapsed_s, state_hash = run_vm(args.vm_bin, str(program), max_steps, args.mode)
             timings.append(elapsed_s)
             hashes.append(state_hash)
 
@@ -125,6 +130,7 @@ def main() -> int:
         "suite": baseline["suite"],
         "profile_id": baseline["profile_id"],
         "vm_bin": args.vm_bin,
+        "mode": args.mode,
         "iterations": iterations,
         "expected_steps": expected_steps,
         "max_steps": max_steps,
@@ -142,7 +148,7 @@ def main() -> int:
     out_path.write_text(json.dumps(report, indent=2, sort_keys=True) + "\n", encoding="utf-8")
     print(
         "perf-check: ok "
-        f"(median_ips={median_ips:.2f}, min_ips={min_observed_ips:.2f}, hash={unique_hashes[0]})"
+        f"(mode={args.mode}, median_ips={median_ips:.2f}, min_ips={min_observed_ips:.2f}, hash={unique_hashes[0]})"
     )
     return 0
 
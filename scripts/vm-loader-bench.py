@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Program loader throughput on generated programs.
+
+One program is written in each artifact format (Text V1, TISC JSON V1, and tisc-bin-v1
+when the binary supports it). Each file is loaded with `--emit-tisc-bin /dev/null`,
+which parses the file, re-encodes it (the same cost for every format) and exits
+without building a VM. The time for a one-instruction program in the same format is
+subtracted so process start-up is excluded.
+Several --vm-bin values compare builds against each other on the same files.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import pathlib
+import statistics
+import subprocess
+import tempfile
+import time
+
+
+FORMATS = ("text", "json", "bin")
+SUFFIX = {"text": ".t81vm", "json": ".tisc.json", "bin": ".tiscb"}
+OPCODES = ("LoadImm", "Add", "Sub", "Store", "Load", "Less", "Mov", "JumpIfNotZero")
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--vm-bin", action="append", help="t81vm binary (repeatable; default build/t81vm)")
+    parser.add_argument("--insns", type=int, default=1_000_000, help="instructions in the generated program")
+    parser.add_argument("--format", action="append", choices=FORMATS, help="artifact format (repeatable; default all)")
+    parser.add_argument("--runs", type=int, default=5, help="measured runs per configuration (median reported)")
+    return parser.parse_args()
+
+
+def generate(count: int) -> list[tuple[str, int, int, int]]:
+    insns = []
+    for i in range(count - 1):
+        op = OPCODES[i % len(OPCODES)]
+        insns.append((op, 1 + i % 240, (i * 7919) % 2_000_003 - 1_000_000, i % 97))
+    insns.append(("Halt", 0, 0, 0))
+    return insns
+
+
+def write_program(path: pathlib.Path, fmt: str, insns: list[tuple[str, int, int, int]], vm_bin: str) -> bool:
+    if fmt == "text":
+        path.write_text("".join(f"{op} {a} {b} {c}\n" for op, a, b, c in insns), encoding="utf-8")
+        return True
+    if fmt == "json":
+        doc = {
+            "format_version": "tisc-json-v1",
+            "axion_policy_text": "(policy (tier 1))",
+            "insns": [{"opcode": op, "a": a, "b": b, "c": c} for op, a, b, c in insns],
+        }
+        path.write_text(json.dumps(doc, indent=1) + "\n", encoding="utf-8")
+        return True
+    source = path.with_suffix(".json")
+    write_program(source, "json", insns, vm_bin)
+    proc = subprocess.run([vm_bin, "--emit-tisc-bin", str(path), str(source)], capture_output=True, check=False)
+    return proc.returncode == 0
+
+
+def load_seconds(vm_bin: str, program: pathlib.Path) -> float:
+    started = time.perf_counter()
+    proc = subprocess.run([vm_bin, "--emit-tisc-bin", "/dev/null", str(program)], capture_output=True, check=False)
+    elapsed = time.perf_counter() - started
+    if proc.returncode != 0:
+        raise SystemExit(f"{vm_bin} failed to load {program}:\n{proc.stderr.decode(errors='replace')[-2000:]}")
+    return elapsed
+
+
+def main() -> int:
+    args = parse_args()
+    vm_bins = args.vm_bin or ["build/t81vm"]
+    formats = args.format or list(FORMATS)
+    insns = generate(args.insns)
+    tiny = [("Halt", 0, 0, 0)]
+
+    with tempfile.TemporaryDirectory(prefix="t81-vm-loader-bench-") as td:
+        root = pathlib.Path(td)
+        print(f"insns={len(insns)}")
+        for fmt in formats:
+            big = root / f"program{SUFFIX[fmt]}"
+            small = root / f"tiny{SUFFIX[fmt]}"
+            # Files are produced once, by the first binary able to write the format.
+            writer = next((b for b in vm_bins if write_program(big, fmt, insns, b)), None)
+            if writer is None or not write_program(small, fmt, tiny, writer):
+                print(f"format={fmt} skipped (no binary writes it)")
+                continue
+            size = big.stat().st_size
+            for vm_bin in vm_bins:
+                full: list[float] = []
+                base: list[float] = []
+                for _ in range(args.runs):
+                    try:
+                        full.append(load_seconds(vm_bin, big))
+                        base.append(load_seconds(vm_bin, small))
+                    except SystemExit as err:
+                        print(f"{vm_bin} format={fmt} unsupported ({str(err).splitlines()[0]})")
+                        break
+                if len(full) < args.runs:
+                    continue
+                load_s = max(statistics.median(full) - statistics.median(base), 1e-9)
+                print(
+                    f"{vm_bin} format={fmt} bytes={size} load_seconds={load_s:.4f} "
+                    f"minsns_per_s={len(insns) / load_s / 1e6:.2f} mb_per_s={size / load_s / 1e6:.1f}"
+                )
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
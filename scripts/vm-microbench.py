@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Engine microbenchmarks on generated programs.
+
+Each workload is run to completion and again with a one-step budget; the difference
+is reported as execution time, so process start-up and program loading are excluded.
+Several --vm-bin values compare builds against each other on the same program.
+"""
+
+from __future__ import annotations
+
+import argparse
+import pathlib
+import re
+import statistics
+import subprocess
+import tempfile
+import time
+
+
+STATE_HASH_RE = re.compile(r"^STATE_HASH\s+(0x[0-9a-fA-F]+)\s*$", re.MULTILINE)
+STACK_WORDS = 256
+
+
+def parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--vm-bin", action="append", help="t81vm binary (repeatable; default build/t81vm)")
+    parser.add_argument("--workload", choices=sorted(WORKLOADS), default="large-code")
+    parser.add_argument("--mode", action="append", help="execution mode (repeatable; default interpreter)")
+    parser.add_argument("--body", type=int, help="loop body length in instructions (default per workload)")
+    parser.add_argument("--passes", type=int, help="loop iterations (default per workload)")
+    parser.add_argument("--runs", type=int, default=5, help="measured runs per configuration (median reported)")
+    parser.add_argument(
+        "--vm-arg",
+        action="append",
+        default=[],
+        help="extra t81vm argument (repeatable; default --trace-level none --no-axion-log)",
+    )
+    return parser.parse_args()
+
+
+def large_code(body: int, passes: int) -> list[str]:
+    """A loop over `body` distinct instructions, so the code footprint (not the
+    register file) dominates: register arithmetic, immediates and heap traffic."""
+    size = body + 4
+    heap = size + STACK_WORDS
+    lines = [f"LoadImm 0 {passes} 0"]
+    for i in range(body):
+        r = 1 + i % 240
+        s = 1 + (i * 7 + 3) % 240
+        t = 1 + (i * 13 + 5) % 240
+        kind = i % 8
+        if kind == 0:
+            lines.append(f"LoadImm {r} {100000 + i} 0")
+        elif kind in (1, 5):
+            lines.append(f"Add {r} {s} {t}")
+        elif kind == 2:
+            lines.append(f"Sub {r} {s} {t}")
+        elif kind == 3:
+            lines.append(f"Store {heap + i % 768} {s} 0")
+        elif kind == 4:
+            lines.append(f"Load {r} {heap + (i * 5) % 768} 0")
+        elif kind == 6:
+            lines.append(f"Less {r} {s} {t}")
+        else:
+            lines.append(f"Mov {r} {s} 0")
+    lines += ["Dec 0 0 0", "JumpIfNotZero 1 0 0", "Halt 0 0 0"]
+    return lines
+
+
+def register_heavy(body: int, passes: int) -> list[str]:
+    """A short loop that cycles through the whole register file with register-only
+    arithmetic, comparisons, moves and stack traffic, so per-step state access (pc,
+    flags, sp, registers and tags) dominates."""
+    lines = [f"LoadImm 0 {passes} 0"]
+    for i in range(body - body % 12):  # whole Push/Pop pairs
+        r = 1 + i % 242
+        s = 1 + (i * 11 + 7) % 242
+        t = 1 + (i * 29 + 3) % 242
+        kind = i % 6
+        if kind in (0, 3):
+            lines.append(f"Add {r} {s} {t}")
+        elif kind == 1:
+            lines.append(f"Sub {r} {s} {t}")
+        elif kind == 2:
+            lines.append(f"Cmp {s} {t} 0")
+        elif kind == 4:
+            lines.append(f"Mov {r} {s} 0")
+        else:
+            lines.append(f"Push {s} 0 0" if i % 12 == 5 else f"Pop {r} 0 0")
+    lines += ["Dec 0 0 0", "JumpIfNotZero 1 0 0", "Halt 0 0 0"]
+    return lines
+
+
+# name -> (generator, default body length, default passes)
+WORKLOADS = {
+    "large-code": (large_code, 65536, 400),
+    "register-heavy": (register_heavy, 720, 40000),
+}
+
+
+def run_vm(vm_bin: str, program: str, max_steps: int, mode: str, extra: list[str]) -> tuple[float, str]:
+    started = time.perf_counter()
+    proc = subprocess.run(
+        [vm_bin, "--snapshot", "--max-steps", str(max_steps), "--mode", mode, *extra, program],
+        text=True,
+        capture_output=True,
+        check=False,
+    )
+    elapsed = time.perf_counter() - started
+    if max_steps > 1 and "halted=1" not in proc.stdout:
+        raise SystemExit(f"{vm_bin} --mode {mode} did not halt:\n{proc.stdout[-2000:]}")
+    match = STATE_HASH_RE.search(proc.stdout)
+    return elapsed, match.group(1).lower() if match else ""
+
+
+def main() -> int:
+    args = parse_args()
+    vm_bins = args.vm_bin or ["build/t81vm"]
+    modes = args.mode or ["interpreter"]
+    extra = args.vm_arg or ["--trace-level", "none", "--no-axion-log"]
+    generate, default_body, default_passes = WORKLOADS[args.workload]
+    passes = args.passes or default_passes
+    lines = generate(args.body or default_body, passes)
+    steps = 1 + passes * (len(lines) - 2) + 1
+
+    with tempfile.TemporaryDirectory(prefix="t81-vm-microbench-") as td:
+        program = pathlib.Path(td) / f"{args.workload}.t81"
+        program.write_text("\n".join(lines) + "\n", encoding="utf-8")
+        print(f"workload={args.workload} insns={len(lines)} steps={steps}")
+        for vm_bin in vm_bins:
+            for mode in modes:
+                full: list[float] = []
+                load: list[float] = []
+                hashes: set[str] = set()
+                for _ in range(args.runs):
+                    elapsed, state_hash = run_vm(vm_bin, str(program), steps, mode, extra)
+                    full.append(elapsed)
+                    hashes.add(state_hash)
+                    load.append(run_vm(vm_bin, str(program), 1, mode, extra)[0])
+                exec_s = max(statistics.median(full) - statistics.median(load), 1e-9)
+                print(
+                    f"{vm_bin} mode={mode} exec_seconds={exec_s:.4f} "
+                    f"mips={steps / exec_s / 1e6:.1f} hashes={','.join(sorted(hashes)) or '-'}"
+                )
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
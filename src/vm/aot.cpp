@@ -0,0 +1,500 @@
+#include "t81/vm/aot.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+#include "t81/vm/loader.hpp"
+
+#if __has_include(<dlfcn.h>)
+#define T81_VM_AOT_DLOPEN 1
+#include <dlfcn.h>
+#endif
+
+namespace t81::vm {
+
+namespace {
+
+using t81::tisc::Opcode;
+
+// Layout of one t81aot_segments() entry; mirrored by the generated T81AotEntry.
+struct AotEntry {
+  std::uint64_t begin;
+  std::uint64_t length;
+  jit::SegmentFn traced;
+  jit::SegmentFn untraced;
+};
+
+// Types and helpers every generated module starts with. They mirror jit::Context
+// (kAotAbiVersion) without including VM headers, so modules build with any C++17
+// compiler. Register tags use an enum type rather than a char type so stores to them
+// do not force registers to be reloaded.
+constexpr const char* kPrelude = R"(#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+enum class Tag : std::uint8_t { Int = 0 };
+
+struct Flags {
+  bool zero;
+  bool negative;
+  bool positive;
+};
+
+struct Context {
+  std::int64_t* registers;
+  Tag* register_tags;
+  std::int64_t* memory;
+  std::uint8_t* dirty_pages;
+  std::size_t* sp;
+  Flags* flags;
+  std::int64_t* write_values;
+  Tag* write_tags;
+  std::size_t budget;
+  std::size_t next_pc;
+};
+
+using SegmentFn = std::size_t (*)(Context*);
+
+struct T81AotEntry {
+  std::uint64_t begin;
+  std::uint64_t length;
+  SegmentFn traced;
+  SegmentFn untraced;
+};
+
+inline std::int64_t wrap_add(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+}
+inline std::int64_t wrap_sub(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+}
+inline std::int64_t wrap_mul(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b));
+}
+inline std::int64_t trit(std::int64_t v) { return v > 1 ? 1 : (v < -1 ? -1 : v); }
+
+// Leaves a segment: publishes the pending flag value, the next pc and the step count.
+inline std::size_t leave(Context* c, std::int64_t f, bool pending, std::size_t next_pc, std::size_t done) {
+  if (pending) {
+    c->flags->zero = f == 0;
+    c->flags->negative = f < 0;
+    c->flags->positive = f > 0;
+  }
+  c->next_pc = next_pc;
+  return done;
+}
+
+)";
+
+bool is_jump(Opcode opcode) {
+  return opcode == Opcode::Jump || opcode == Opcode::JumpIfZero || opcode == Opcode::JumpIfNotZero ||
+         opcode == Opcode::JumpIfNegative || opcode == Opcode::JumpIfPositive;
+}
+
+// Writes the C++ body of one segment. Mirrors the JIT's SegmentCompiler instruction for
+// instruction: `f` holds the last flag-setting result while `pending_` is true, and
+// faulting instructions leave before touching state.
+class SegmentEmitter {
+ public:
+  SegmentEmitter(std::ostringstream& out, const t81::tisc::Program& program, const State& state)
+      : out_(out), program_(program), state_(state) {}
+
+  void emit(const jit::Segment& segment, bool log_writes, const std::string& name) {
+    const auto& last = program_.insns[segment.begin + segment.length - 1];
+    log_ = log_writes;
+    loops_ = !log_writes && is_jump(last.opcode) && last.a == static_cast<std::int64_t>(segment.begin);
+    begin_ = segment.begin;
+    length_ = segment.length;
+    pending_ = false;
+    out_ << "std::size_t " << name << "(Context* c) {\n"
+         << "  std::int64_t* const r = c->registers;\n"
+         << "  Tag* const t = c->register_tags;\n"
+         << "  std::int64_t* const m = c->memory;\n"
+         << "  std::int64_t f = 0;\n";
+    if (loops_) {
+      out_ << "  std::size_t done = 0;\n"
+           << "  std::size_t budget = c->budget;\n"
+           << "top:\n";
+    }
+    out_ << "  (void)r;\n  (void)t;\n  (void)m;\n";
+    for (std::size_t k = 0; k < segment.length; ++k) {
+      const std::size_t pc = segment.begin + k;
+      const auto& insn = program_.insns[pc];
+      out_ << "  {  // " << pc << ": " << t81::tisc::to_string(insn.opcode) << " " << insn.a << " " << insn.b
+           << " " << insn.c << "\n";
+      if (is_jump(insn.opcode)) {
+        emit_jump(insn, pc, k + 1);
+        out_ << "  }\n}\n\n";
+        return;
+      }
+      emit_insn(insn, pc, k);
+      out_ << "  }\n";
+    }
+    out_ << "  return " << leave(segment.begin + segment.length, segment.length) << ";\n}\n\n";
+  }
+
+ private:
+  std::string done(std::size_t k) const {
+    return loops_ ? "done + " + std::to_string(k) : std::to_string(k);
+  }
+
+  std::string leave(std::size_t next_pc, std::size_t completed) const {
+    return "leave(c, f, " + std::string(pending_ ? "true" : "false") + ", " + std::to_string(next_pc) + ", " +
+           done(completed) + ")";
+  }
+
+  static std::string literal(std::int64_t value) {
+    // -9223372036854775808 is not a literal: the negation applies to an unsigned value.
+    if (value == std::numeric_limits<std::int64_t>::min()) {
+      return "(-INT64_C(9223372036854775807) - 1)";
+    }
+    return "INT64_C(" + std::to_string(value) + ")";
+  }
+
+  static std::string reg(std::int64_t idx) { return "r[" + std::to_string(idx) + "]"; }
+
+  // Stores `v` (already computed) as an Int-tagged write to register `a`.
+  void write_int(std::int64_t a, std::size_t k, bool logged) {
+    out_ << "    " << reg(a) << " = v;\n    t[" << a << "] = Tag::Int;\n";
+    if (logged && log_) {
+      out_ << "    c->write_values[" << k << "] = v;\n";
+    }
+    set_flag();
+  }
+
+  void set_flag() {
+    out_ << "    f = v;\n";
+    pending_ = true;
+  }
+
+  void bail_if(const std::string& cond, std::size_t pc, std::size_t k) {
+    out_ << "    if (" << cond << ") return " << leave(pc, k) << ";\n";
+  }
+
+  void emit_insn(const t81::tisc::Insn& insn, std::size_t pc, std::size_t k) {
+    const auto& l = state_.layout;
+    switch (insn.opcode) {
+      case Opcode::Nop:
+        return;
+      case Opcode::LoadImm:
+        out_ << "    const std::int64_t v = " << literal(insn.b) << ";\n";
+        return write_int(insn.a, k, true);
+      case Opcode::Load:
+        out_ << "    const std::int64_t v = m[" << insn.b << "];\n";
+        return write_int(insn.a, k, true);
+      case Opcode::Store:
+        out_ << "    m[" << insn.a << "] = " << reg(insn.b) << ";\n"
+             << "    c->dirty_pages[" << insn.a / static_cast<std::int64_t>(MemoryPages::kPageWords) << "] = 1;\n";
+        return;
+      case Opcode::Add:
+      case Opcode::FAdd:
+      case Opcode::FracAdd:
+        out_ << "    const std::int64_t v = wrap_add(" << reg(insn.b) << ", " << reg(insn.c) << ");\n";
+        return write_int(insn.a, k, true);
+      case Opcode::Sub:
+      case Opcode::FSub:
+      case Opcode::FracSub:
+        out_ << "    const std::int64_t v = wrap_sub(" << reg(insn.b) << ", " << reg(insn.c) << ");\n";
+        return write_int(insn.a, k, true);
+      case Opcode::Mul:
+      case Opcode::FMul:
+      case Opcode::FracMul:
+        out_ << "    const std::int64_t v = wrap_mul(" << reg(insn.b) << ", " << reg(insn.c) << ");\n";
+        return write_int(insn.a, k, true);
+      case Opcode::Div:
+      case Opcode::FDiv:
+      case Opcode::FracDiv:
+      case Opcode::Mod:
+        bail_if(reg(insn.c) + " == 0", pc, k);
+        out_ << "    const std::int64_t v = " << reg(insn.b) << (insn.opcode == Opcode::Mod ? " % " : " / ")
+             << reg(insn.c) << ";\n";
+        return write_int(insn.a, k, true);
+      case Opcode::Mov:
+      case Opcode::I2F:
+      case Opcode::F2I:
+      case Opcode::I2Frac:
+      case Opcode::Frac2I:
+        out_ << "    const std::int64_t v = " << reg(insn.b) << ";\n"
+             << "    const Tag tag = t[" << insn.b << "];\n"
+             << "    " << reg(insn.a) << " = v;\n    t[" << insn.a << "] = tag;\n";
+        if (log_) {
+          out_ << "    c->write_values[" << k << "] = v;\n    c->write_tags[" << k << "] = tag;\n";
+        }
+        return set_flag();
+      case Opcode::Inc:
+      case Opcode::Dec:
+        out_ << "    const std::int64_t v = wrap_add(" << reg(insn.a) << ", "
+             << (insn.opcode == Opcode::Inc ? "1" : "-1") << ");\n";
+        return write_int(insn.a, k, false);
+      case Opcode::Cmp:
+        out_ << "    const std::int64_t v = wrap_sub(" << reg(insn.a) << ", " << reg(insn.b) << ");\n";
+        return set_flag();
+      case Opcode::Neg:
+        out_ << "    const std::int64_t v = wrap_sub(0, " << reg(insn.b) << ");\n";
+        return write_int(insn.a, k, true);
+      case Opcode::TNot:
+        out_ << "    const std::int64_t v = -trit(" << reg(insn.b) << ");\n";
+        return write_int(insn.a, k, true);
+      case Opcode::TAnd:
+      case Opcode::TOr:
+      case Opcode::TXor:
+        out_ << "    const std::int64_t lhs = trit(" << reg(insn.b) << ");\n"
+             << "    const std::int64_t rhs = trit(" << reg(insn.c) << ");\n";
+        if (insn.opcode == Opcode::TAnd) {
+          out_ << "    const std::int64_t v = lhs < rhs ? lhs : rhs;\n";
+        } else if (insn.opcode == Opcode::TOr) {
+          out_ << "    const std::int64_t v = lhs > rhs ? lhs : rhs;\n";
+        } else {
+          out_ << "    const std::int64_t d = lhs - rhs;\n"
+               << "    const std::int64_t v = d > 1 ? -1 : (d < -1 ? 1 : d);\n";
+        }
+        return write_int(insn.a, k, true);
+      case Opcode::Less:
+      case Opcode::LessEqual:
+      case Opcode::Greater:
+      case Opcode::GreaterEqual:
+      case Opcode::Equal:
+      case Opcode::NotEqual: {
+        const char* op = insn.opcode == Opcode::Less           ? " < "
+                         : insn.opcode == Opcode::LessEqual    ? " <= "
+                         : insn.opcode == Opcode::Greater      ? " > "
+                         : insn.opcode == Opcode::GreaterEqual ? " >= "
+                         : insn.opcode == Opcode::Equal        ? " == "
+                                                               : " != ";
+        out_ << "    const std::int64_t v = " << reg(insn.b) << op << reg(insn.c) << " ? 1 : 0;\n";
+        return write_int(insn.a, k, true);
+      }
+      case Opcode::Push:
+        out_ << "    std::size_t sp = *c->sp;\n";
+        bail_if("sp <= " + std::to_string(l.stack.start), pc, k);
+        out_ << "    --sp;\n    *c->sp = sp;\n    m[sp] = " << reg(insn.a) << ";\n"
+             << "    c->dirty_pages[sp / " << MemoryPages::kPageWords << "] = 1;\n";
+        return;
+      case Opcode::Pop:
+        out_ << "    const std::size_t sp = *c->sp;\n";
+        bail_if("sp >= " + std::to_string(l.stack.limit), pc, k);
+        out_ << "    const std::int64_t v = m[sp];\n";
+        write_int(insn.a, k, false);
+        out_ << "    *c->sp = sp + 1;\n";
+        return;
+      default:
+        return;
+    }
+  }
+
+  void emit_jump(const t81::tisc::Insn& insn, std::size_t pc, std::size_t completed) {
+    const auto target = static_cast<std::size_t>(insn.a);
+    if (insn.opcode == Opcode::Jump) {
+      return jump_to(target, completed, "    ");
+    }
+    std::string cond;
+    if (pending_) {
+      cond = insn.opcode == Opcode::JumpIfZero       ? "f == 0"
+             : insn.opcode == Opcode::JumpIfNotZero  ? "f != 0"
+             : insn.opcode == Opcode::JumpIfNegative ? "f < 0"
+                                                     : "f > 0";
+    } else {
+      cond = insn.opcode == Opcode::JumpIfZero       ? "c->flags->zero"
+             : insn.opcode == Opcode::JumpIfNotZero  ? "!c->flags->zero"
+             : insn.opcode == Opcode::JumpIfNegative ? "c->flags->negative"
+                                                     : "c->flags->positive";
+    }
+    const std::string fallthrough = leave(pc + 1, completed);
+    out_ << "    if (" << cond << ") {\n";
+    jump_to(target, completed, "      ");
+    out_ << "    }\n    return " << fallthrough << ";\n";
+  }
+
+  // A taken back edge of a looping segment commits the pass and re-enters the body
+  // while the budget covers another one.
+  void jump_to(std::size_t target, std::size_t completed, const char* indent) {
+    if (!loops_ || target != begin_) {
+      out_ << indent << "return " << leave(target, completed) << ";\n";
+      return;
+    }
+    out_ << indent << "leave(c, f, " << (pending_ ? "true" : "false") << ", " << target << ", 0);\n"
+         << indent << "done += " << length_ << ";\n"
+         << indent << "budget -= " << length_ << ";\n"
+         << indent << "if (budget >= " << length_ << ") goto top;\n"
+         << indent << "return done;\n";
+  }
+
+  std::ostringstream& out_;
+  const t81::tisc::Program& program_;
+  const State& state_;
+  bool log_ = false;
+  bool loops_ = false;
+  bool pending_ = false;
+  std::size_t begin_ = 0;
+  std::size_t length_ = 0;
+};
+
+std::string shell_quote(const std::string& text) {
+  std::string out = "'";
+  for (char ch : text) {
+    if (ch == '\'') {
+      out += "'\\''";
+    } else {
+      out.push_back(ch);
+    }
+  }
+  return out + "'";
+}
+
+}  // namespace
+
+std::uint64_t program_fingerprint(const t81::tisc::Program& program) {
+  std::uint64_t hash = 1469598103934665603ULL;
+  const auto mix = [&hash](std::uint64_t word) {
+    for (int i = 0; i < 8; ++i) {
+      hash ^= (word >> (i * 8)) & 0xFFU;
+      hash *= 1099511628211ULL;
+    }
+  };
+  mix(program.insns.size());
+  for (const auto& insn : program.insns) {
+    mix(static_cast<std::uint64_t>(insn.opcode));
+    mix(static_cast<std::uint64_t>(insn.a));
+    mix(static_cast<std::uint64_t>(insn.b));
+    mix(static_cast<std::uint64_t>(insn.c));
+  }
+  mix(program.axion_policy_text.size());
+  for (const char ch : program.axion_policy_text) {
+    mix(static_cast<unsigned char>(ch));
+  }
+  return hash;
+}
+
+std::string emit_cpp(const t81::tisc::Program& program) {
+  const auto loaded = load_program_image(program);
+  std::vector<jit::Segment> segments;
+  if (!loaded.preload_trap.has_value()) {
+    segments = jit::plan_segments(loaded.program, loaded.initial_state);
+  }
+
+  std::ostringstream out;
+  out << "// Generated by t81vm emit_cpp(); do not edit.\n"
+      << "// Program fingerprint 0x" << std::hex << program_fingerprint(program) << std::dec << ", "
+      << segments.size() << " native segments.\n"
+      << kPrelude;
+  SegmentEmitter emitter(out, loaded.program, loaded.initial_state);
+  for (const auto& segment : segments) {
+    emitter.emit(segment, true, "seg" + std::to_string(segment.begin) + "_traced");
+    emitter.emit(segment, false, "seg" + std::to_string(segment.begin));
+  }
+  out << "const T81AotEntry kSegments[] = {\n";
+  for (const auto& segment : segments) {
+    out << "    {" << segment.begin << ", " << segment.length << ", &seg" << segment.begin << "_traced, &seg"
+        << segment.begin << "},\n";
+  }
+  // A zero-length array is ill-formed; the sentinel is not counted.
+  out << "    {0, 0, nullptr, nullptr},\n};\n\n"
+      << "}  // namespace\n\n"
+      << "extern \"C\" std::uint32_t t81aot_abi_version() { return " << kAotAbiVersion << "; }\n"
+      << "extern \"C\" std::uint64_t t81aot_fingerprint() { return UINT64_C(" << program_fingerprint(program)
+      << "); }\n"
+      << "extern \"C\" const T81AotEntry* t81aot_segments(std::size_t* count) {\n"
+      << "  *count = " << segments.size() << ";\n"
+      << "  return kSegments;\n"
+      << "}\n";
+  return out.str();
+}
+
+AotBuildResult compile_aot(const t81::tisc::Program& program, const std::string& so_path,
+                           const std::string& compiler) {
+  const std::string source_path = so_path + ".cpp";
+  {
+    std::ofstream source(source_path, std::ios::binary);
+    source << emit_cpp(program);
+    if (!source) {
+      return AotBuildResult{.ok = false, .error = "unable to write file: " + source_path};
+    }
+  }
+  std::string cxx = compiler;
+  if (cxx.empty()) {
+    const char* env = std::getenv("CXX");
+    cxx = env != nullptr && *env != '\0' ? env : "c++";
+  }
+  const std::string command = cxx + " -std=c++17 -O2 -fPIC -shared -o " + shell_quote(so_path) + " " +
+                              shell_quote(source_path);
+  const int status = std::system(command.c_str());
+  if (status != 0) {
+    return AotBuildResult{.ok = false, .error = "compiler failed (status " + std::to_string(status) + "): " + command};
+  }
+  return AotBuildResult{.ok = true, .error = ""};
+}
+
+AotLoadResult AotModule::open(const std::string& path) {
+#ifdef T81_VM_AOT_DLOPEN
+  // dlopen() searches the library path for bare names; modules are always files.
+  const std::string file = path.find('/') == std::string::npos ? "./" + path : path;
+  void* handle = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle == nullptr) {
+    const char* error = dlerror();
+    return AotLoadResult{.ok = false, .module = nullptr, .error = error != nullptr ? error : "dlopen failed"};
+  }
+  std::shared_ptr<AotModule> module(new AotModule());
+  module->handle_ = handle;
+  const auto abi = reinterpret_cast<std::uint32_t (*)()>(dlsym(handle, "t81aot_abi_version"));
+  const auto fingerprint = reinterpret_cast<std::uint64_t (*)()>(dlsym(handle, "t81aot_fingerprint"));
+  const auto table = reinterpret_cast<const AotEntry* (*)(std::size_t*)>(dlsym(handle, "t81aot_segments"));
+  if (abi == nullptr || fingerprint == nullptr || table == nullptr) {
+    return AotLoadResult{.ok = false, .module = nullptr, .error = "not a t81vm AOT module: " + path};
+  }
+  if (abi() != kAotAbiVersion) {
+    return AotLoadResult{.ok = false,
+                         .module = nullptr,
+                         .error = "AOT module ABI version " + std::to_string(abi()) + " (expected " +
+                                  std::to_string(kAotAbiVersion) + "): " + path};
+  }
+  module->fingerprint_ = fingerprint();
+  std::size_t count = 0;
+  const AotEntry* entries = table(&count);
+  for (std::size_t i = 0; i < count; ++i) {
+    module->entries_.push_back(Entry{
+        .begin = static_cast<std::size_t>(entries[i].begin),
+        .length = static_cast<std::size_t>(entries[i].length),
+        .traced = entries[i].traced,
+        .untraced = entries[i].untraced,
+    });
+  }
+  return AotLoadResult{.ok = true, .module = std::move(module), .error = ""};
+#else
+  return AotLoadResult{.ok = false, .module = nullptr, .error = "AOT modules need dlopen(), unavailable here: " + path};
+#endif
+}
+
+AotModule::~AotModule() {
+#ifdef T81_VM_AOT_DLOPEN
+  if (handle_ != nullptr) {
+    dlclose(handle_);
+  }
+#endif
+}
+
+std::vector<jit::Segment> AotModule::segments(const t81::tisc::Program& program, bool log_writes) const {
+  std::vector<jit::Segment> out;
+  out.reserve(entries_.size());
+  for (const auto& entry : entries_) {
+    if (entry.begin + entry.length > program.insns.size()) {
+      return {};
+    }
+    const auto first = program.insns.begin() + static_cast<std::ptrdiff_t>(entry.begin);
+    const bool stores = std::any_of(first, first + static_cast<std::ptrdiff_t>(entry.length),
+                                    [](const auto& insn) { return insn.opcode == Opcode::Store; });
+    out.push_back(jit::Segment{
+        .begin = entry.begin,
+        .length = entry.length,
+        .stores = stores,
+        .fn = log_writes ? entry.traced : entry.untraced,
+    });
+  }
+  return out;
+}
+
+}  // namespace t81::vm
@@ -1,15 +1,57 @@
 #include "t81/vm/c_api.h"
 
+#include <algorithm>
+#include <cstring>
 #include <expected>
 #include <memory>
 #include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
 
-#include "t81/vm/program_io.hpp"
+#include "t81/vm/profile.hpp"
+#include "t81/vm/program_cache.hpp"
 #include "t81/vm/summary.hpp"
 #include "t81/vm/vm.hpp"
 
+namespace {
+
+t81vm_trace_entry to_c_entry(const t81::vm::TraceEntry& e) {
+  return t81vm_trace_entry{
+      .pc = e.pc,
+      .opcode = static_cast<uint8_t>(e.opcode),
+      .trap = e.trap.has_value() ? static_cast<int>(*e.trap) : -1,
+  };
+}
+
+// Adapts ITraceSink batches to the C callback's flat entry array.
+class CallbackTraceSink final : public t81::vm::ITraceSink {
+ public:
+  CallbackTraceSink(t81vm_trace_callback callback, void* user_data) : callback_(callback), user_data_(user_data) {}
+
+  void on_entries(std::span<const t81::vm::TraceEntry> batch) override {
+    entries_.clear();
+    for (const auto& e : batch) {
+      entries_.push_back(to_c_entry(e));
+    }
+    callback_(entries_.data(), entries_.size(), user_data_);
+  }
+
+ private:
+  t81vm_trace_callback callback_;
+  void* user_data_;
+  std::vector<t81vm_trace_entry> entries_;
+};
+
+}  // namespace
+
 struct t81vm_handle {
   std::unique_ptr<t81::vm::IVirtualMachine> vm;
+  std::unique_ptr<CallbackTraceSink> trace_sink;
+  t81::vm::ProfilingVm* profiler = nullptr;  // owned by `vm` when profiling is on
+  t81::vm::VmOptions options;
+  std::optional<t81::vm::ProgramCache> program_cache;
   int last_trap = 0;
 };
 
@@ -24,6 +66,34 @@ int trap_to_status(t81::vm::Trap trap) {
   return static_cast<int>(trap);
 }
 
+size_t copy_text(const std::string& text, char* buf, size_t size) {
+  if (buf != nullptr && size > 0) {
+    const size_t n = std::min(text.size(), size - 1);
+    std::memcpy(buf, text.data(), n);
+    buf[n] = '\0';
+  }
+  return text.size();
+}
+
+// Rebuilds the handle's VM from its options and profiling flag, keeping the trace callback.
+int rebuild_vm(t81vm_handle* handle, bool profiling) {
+  auto vm = t81::vm::make_vm(handle->options);
+  if (!vm) {
+    return kStatusInvalidArg;
+  }
+  t81::vm::ProfilingVm* profiler = nullptr;
+  if (profiling) {
+    auto wrapped = std::make_unique<t81::vm::ProfilingVm>(std::move(vm));
+    profiler = wrapped.get();
+    vm = std::move(wrapped);
+  }
+  vm->set_trace_sink(handle->trace_sink.get());
+  handle->vm = std::move(vm);
+  handle->profiler = profiler;
+  handle->last_trap = trap_to_status(t81::vm::Trap::None);
+  return kStatusOk;
+}
+
 }  // namespace
 
 t81vm_handle* t81vm_create(void) {
@@ -47,12 +117,13 @@ int t81vm_load_file(t81vm_handle* handle, const char* path) {
   if (handle == nullptr || handle->vm == nullptr || path == nullptr) {
     return kStatusInvalidArg;
   }
-  const auto loaded = t81::vm::load_program_from_file(path);
+  const auto loaded =
+      handle->program_cache ? handle->program_cache->load(path) : t81::vm::load_program_image_from_file(path);
   if (!loaded.ok) {
     handle->last_trap = trap_to_status(t81::vm::Trap::DecodeFault);
     return kStatusParseFault;
   }
-  handle->vm->load_program(loaded.program);
+  handle->vm->load_image(loaded.image);
   handle->last_trap = trap_to_status(t81::vm::Trap::None);
   return kStatusOk;
 }
@@ -112,6 +183,13 @@ uint64_t t81vm_state_hash(const t81vm_handle* handle) {
   return t81::vm::state_hash(handle->vm->state());
 }
 
+uint64_t t81vm_state_hash_v2(const t81vm_handle* handle) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return 0;
+  }
+  return t81::vm::state_hash(handle->vm->state(), t81::vm::StateHashVersion::V2);
+}
+
 int64_t t81vm_register(const t81vm_handle* handle, size_t index) {
   if (handle == nullptr || handle->vm == nullptr) {
     return 0;
@@ -138,8 +216,161 @@ int t81vm_trace_get(const t81vm_handle* handle, size_t index, t81vm_trace_entry*
   if (index >= trace.size()) {
     return kStatusInvalidArg;
   }
-  out->pc = trace[index].pc;
-  out->opcode = static_cast<uint8_t>(trace[index].opcode);
-  out->trap = trace[index].trap.has_value() ? static_cast<int>(*trace[index].trap) : -1;
+  *out = to_c_entry(trace[index]);
+  return kStatusOk;
+}
+
+int t81vm_set_trace_callback(t81vm_handle* handle, t81vm_trace_callback callback, void* user_data) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return kStatusInvalidArg;
+  }
+  auto sink = callback != nullptr ? std::make_unique<CallbackTraceSink>(callback, user_data) : nullptr;
+  handle->vm->set_trace_sink(sink.get());
+  handle->trace_sink = std::move(sink);
+  return kStatusOk;
+}
+
+int t81vm_set_flight_recorder(t81vm_handle* handle, size_t depth) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return kStatusInvalidArg;
+  }
+  handle->options.trace = depth > 0 ? t81::vm::TraceLevel::FlightRecorder : t81::vm::TraceLevel::Full;
+  if (depth > 0) {
+    handle->options.flight_recorder_depth = depth;
+  }
+  return rebuild_vm(handle, handle->profiler != nullptr);
+}
+
+size_t t81vm_flight_recorder_len(const t81vm_handle* handle) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return 0;
+  }
+  return handle->vm->state().flight_recorder.size();
+}
+
+int t81vm_flight_recorder_get(const t81vm_handle* handle, size_t index, t81vm_trace_entry* out) {
+  if (handle == nullptr || handle->vm == nullptr || out == nullptr) {
+    return kStatusInvalidArg;
+  }
+  const auto& ring = handle->vm->state().flight_recorder;
+  if (index >= ring.size()) {
+    return kStatusInvalidArg;
+  }
+  *out = to_c_entry(ring[index]);
+  return kStatusOk;
+}
+
+size_t t81vm_flight_recorder_dump(const t81vm_handle* handle, char* buf, size_t size) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return 0;
+  }
+  return copy_text(t81::vm::flight_recorder_dump(handle->vm->state()), buf, size);
+}
+
+int t81vm_set_profiling(t81vm_handle* handle, int enabled) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return kStatusInvalidArg;
+  }
+  return rebuild_vm(handle, enabled != 0);
+}
+
+int t81vm_profile_pc(const t81vm_handle* handle, size_t pc, uint64_t* count, uint64_t* cycles) {
+  if (handle == nullptr || handle->profiler == nullptr) {
+    return kStatusInvalidArg;
+  }
+  const auto& by_pc = handle->profiler->profile().by_pc;
+  if (pc >= by_pc.size()) {
+    return kStatusInvalidArg;
+  }
+  if (count != nullptr) {
+    *count = by_pc[pc].count;
+  }
+  if (cycles != nullptr) {
+    *cycles = by_pc[pc].cycles;
+  }
+  return kStatusOk;
+}
+
+size_t t81vm_profile_report(const t81vm_handle* handle, char* buf, size_t size) {
+  if (handle == nullptr || handle->profiler == nullptr) {
+    return copy_text({}, buf, size);
+  }
+  return copy_text(t81::vm::profile_report(handle->profiler->profile()), buf, size);
+}
+
+size_t t81vm_profile_folded(const t81vm_handle* handle, char* buf, size_t size) {
+  if (handle == nullptr || handle->profiler == nullptr) {
+    return copy_text({}, buf, size);
+  }
+  return copy_text(t81::vm::profile_folded(handle->profiler->profile()), buf, size);
+}
+
+int t81vm_set_tiering(t81vm_handle* handle, uint64_t threshold) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return kStatusInvalidArg;
+  }
+  handle->options.mode = threshold > 0 ? t81::vm::ExecutionMode::Tiered : t81::vm::ExecutionMode::Interpreter;
+  if (threshold > 0) {
+    handle->options.tier_up_threshold = threshold;
+  }
+  return rebuild_vm(handle, handle->profiler != nullptr);
+}
+
+size_t t81vm_block_tier_count(const t81vm_handle* handle) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return 0;
+  }
+  return handle->vm->state().block_tiers.size();
+}
+
+int t81vm_block_tier_get(const t81vm_handle* handle, size_t index, t81vm_block_tier* out) {
+  if (handle == nullptr || handle->vm == nullptr || out == nullptr) {
+    return kStatusInvalidArg;
+  }
+  const auto& blocks = handle->vm->state().block_tiers;
+  if (index >= blocks.size()) {
+    return kStatusInvalidArg;
+  }
+  const auto& block = blocks[index];
+  *out = t81vm_block_tier{
+      .begin = block.begin,
+      .end = block.end,
+      .entries = block.entries,
+      .tier = block.tier,
+      .promoted_at_step = block.promoted_at_step,
+  };
+  return kStatusOk;
+}
+
+size_t t81vm_tier_report(const t81vm_handle* handle, char* buf, size_t size) {
+  if (handle == nullptr || handle->vm == nullptr) {
+    return copy_text({}, buf, size);
+  }
+  return copy_text(t81::vm::tier_report(handle->vm->state()), buf, size);
+}
+
+int t81vm_set_program_cache(t81vm_handle* handle, const char* dir) {
+  if (handle == nullptr) {
+    return kStatusInvalidArg;
+  }
+  if (dir == nullptr || *dir == '\0') {
+    handle->program_cache.reset();
+  } else {
+    handle->program_cache.emplace(dir);
+  }
+  return kStatusOk;
+}
+
+int t81vm_program_cache_stats_get(const t81vm_handle* handle, t81vm_program_cache_stats* out) {
+  if (handle == nullptr || out == nullptr || !handle->program_cache) {
+    return kStatusInvalidArg;
+  }
+  const auto& stats = handle->program_cache->stats();
+  *out = t81vm_program_cache_stats{
+      .hits = stats.hits,
+      .misses = stats.misses,
+      .stores = stats.stores,
+      .invalid = stats.invalid,
+  };
   return kStatusOk;
 }
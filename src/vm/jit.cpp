@@ -0,0 +1,808 @@
+#include "t81/vm/jit.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "t81/vm/validator.hpp"
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__))
+#define T81_VM_JIT_X86_64 1
+#include <sys/mman.h>
+#endif
+
+namespace t81::vm::jit {
+
+namespace {
+
+using t81::tisc::Opcode;
+
+bool compiled(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::Nop:
+    case Opcode::LoadImm:
+    case Opcode::Load:
+    case Opcode::Store:
+    case Opcode::Add:
+    case Opcode::Sub:
+    case Opcode::Mul:
+    case Opcode::Div:
+    case Opcode::Mod:
+    case Opcode::FAdd:
+    case Opcode::FSub:
+    case Opcode::FMul:
+    case Opcode::FDiv:
+    case Opcode::FracAdd:
+    case Opcode::FracSub:
+    case Opcode::FracMul:
+    case Opcode::FracDiv:
+    case Opcode::Mov:
+    case Opcode::I2F:
+    case Opcode::F2I:
+    case Opcode::I2Frac:
+    case Opcode::Frac2I:
+    case Opcode::Inc:
+    case Opcode::Dec:
+    case Opcode::Cmp:
+    case Opcode::Neg:
+    case Opcode::TNot:
+    case Opcode::TAnd:
+    case Opcode::TOr:
+    case Opcode::TXor:
+    case Opcode::Less:
+    case Opcode::LessEqual:
+    case Opcode::Greater:
+    case Opcode::GreaterEqual:
+    case Opcode::Equal:
+    case Opcode::NotEqual:
+    case Opcode::Push:
+    case Opcode::Pop:
+    case Opcode::Jump:
+    case Opcode::JumpIfZero:
+    case Opcode::JumpIfNotZero:
+    case Opcode::JumpIfNegative:
+    case Opcode::JumpIfPositive:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool is_jump(Opcode opcode) {
+  return opcode == Opcode::Jump || opcode == Opcode::JumpIfZero || opcode == Opcode::JumpIfNotZero ||
+         opcode == Opcode::JumpIfNegative || opcode == Opcode::JumpIfPositive;
+}
+
+// Mirrors the interpreter's valid_mem(): in bounds and inside a mapped segment.
+bool valid_mem(const State& state, std::int64_t addr) {
+  if (addr < 0 || static_cast<std::size_t>(addr) >= state.memory.size()) {
+    return false;
+  }
+  const auto a = static_cast<std::size_t>(addr);
+  const auto& l = state.layout;
+  return l.code.contains(a) || l.stack.contains(a) || l.heap.contains(a) || l.tensor.contains(a) ||
+         l.meta.contains(a);
+}
+
+// Memory and dirty-page displacements are encoded as disp32.
+bool fits_disp(std::int64_t addr) {
+  return addr >= 0 && addr < std::numeric_limits<std::int32_t>::max() / 8;
+}
+
+bool compilable(const t81::tisc::Insn& insn, const State& state) {
+  if (!compiled(insn.opcode)) {
+    return false;
+  }
+  if (insn.opcode == Opcode::Load) {
+    return valid_mem(state, insn.b) && fits_disp(insn.b);
+  }
+  if (insn.opcode == Opcode::Store) {
+    return valid_mem(state, insn.a) && fits_disp(insn.a);
+  }
+  return true;
+}
+
+#ifdef T81_VM_JIT_X86_64
+
+bool sets_flags(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::Nop:
+    case Opcode::Store:
+    case Opcode::Push:
+    case Opcode::Jump:
+    case Opcode::JumpIfZero:
+    case Opcode::JumpIfNotZero:
+    case Opcode::JumpIfNegative:
+    case Opcode::JumpIfPositive:
+      return false;
+    default:
+      return true;
+  }
+}
+
+enum Reg : std::uint8_t { RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+// Condition codes (the low nibble of Jcc/SETcc/CMOVcc).
+enum Cond : std::uint8_t { kB = 0x2, kAE = 0x3, kE = 0x4, kNE = 0x5, kBE = 0x6, kS = 0x8, kL = 0xC, kGE = 0xD,
+                           kLE = 0xE, kG = 0xF };
+
+// Minimal x86-64 encoder for the instruction forms the segment compiler uses. Memory
+// operands are always [base + disp32].
+class Assembler {
+ public:
+  std::vector<std::uint8_t> code;
+
+  void byte(std::uint8_t b) { code.push_back(b); }
+  void u32(std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) byte(static_cast<std::uint8_t>(v >> (8 * i)));
+  }
+  void u64(std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) byte(static_cast<std::uint8_t>(v >> (8 * i)));
+  }
+
+  void rex(bool w, std::uint8_t reg, std::uint8_t base) {
+    const std::uint8_t r = static_cast<std::uint8_t>(0x40 | (w ? 0x08 : 0) | ((reg >> 3) << 2) | (base >> 3));
+    if (r != 0x40) byte(r);
+  }
+  void mem(std::uint8_t reg, Reg base, std::int32_t disp) {
+    byte(static_cast<std::uint8_t>(0x80 | ((reg & 7) << 3) | (base & 7)));
+    if ((base & 7) == RSP) byte(0x24);
+    u32(static_cast<std::uint32_t>(disp));
+  }
+  void direct(std::uint8_t reg, Reg rm) { byte(static_cast<std::uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7))); }
+
+  // op r64, [base + disp]: 0x8B mov, 0x03 add, 0x2B sub, 0x3B cmp.
+  void load(std::uint8_t op, Reg reg, Reg base, std::int32_t disp) {
+    rex(true, reg, base);
+    byte(op);
+    mem(reg, base, disp);
+  }
+  void mov_load(Reg reg, Reg base, std::int32_t disp) { load(0x8B, reg, base, disp); }
+  void mov_store(Reg base, std::int32_t disp, Reg src) {
+    rex(true, src, base);
+    byte(0x89);
+    mem(src, base, disp);
+  }
+  void imul_load(Reg reg, Reg base, std::int32_t disp) {
+    rex(true, reg, base);
+    byte(0x0F);
+    byte(0xAF);
+    mem(reg, base, disp);
+  }
+  void movzx_load(Reg reg, Reg base, std::int32_t disp) {
+    rex(false, reg, base);
+    byte(0x0F);
+    byte(0xB6);
+    mem(reg, base, disp);
+  }
+  void store8(Reg base, std::int32_t disp, Reg src) {  // src is AL/CL/DL
+    rex(false, src, base);
+    byte(0x88);
+    mem(src, base, disp);
+  }
+  void store8_imm(Reg base, std::int32_t disp, std::uint8_t value) {
+    rex(false, 0, base);
+    byte(0xC6);
+    mem(0, base, disp);
+    byte(value);
+  }
+  void mov_imm(Reg reg, std::int64_t value) {
+    rex(true, 0, reg);
+    byte(static_cast<std::uint8_t>(0xB8 + (reg & 7)));
+    u64(static_cast<std::uint64_t>(value));
+  }
+  // op r/m64, r64 (register form): 0x01 add, 0x29 sub, 0x39 cmp, 0x85 test, 0x89 mov.
+  void rr(std::uint8_t op, Reg dst, Reg src) {
+    rex(true, src, dst);
+    byte(op);
+    direct(src, dst);
+  }
+  void add_imm8(Reg reg, std::int8_t value) {
+    rex(true, 0, reg);
+    byte(0x83);
+    direct(0, reg);
+    byte(static_cast<std::uint8_t>(value));
+  }
+  void cmp_imm8(Reg reg, std::int8_t value) {
+    rex(true, 0, reg);
+    byte(0x83);
+    direct(7, reg);
+    byte(static_cast<std::uint8_t>(value));
+  }
+  void shift(std::uint8_t ext, Reg reg, std::uint8_t count) {  // ext 4 shl, 5 shr
+    rex(true, 0, reg);
+    byte(0xC1);
+    direct(ext, reg);
+    byte(count);
+  }
+  void neg(Reg reg) {
+    rex(true, 0, reg);
+    byte(0xF7);
+    direct(3, reg);
+  }
+  void idiv(Reg reg) {
+    rex(true, 0, reg);
+    byte(0xF7);
+    direct(7, reg);
+  }
+  void cqo() {
+    byte(0x48);
+    byte(0x99);
+  }
+  void setcc(Cond cc, Reg reg) {  // reg is AL/CL/DL
+    byte(0x0F);
+    byte(static_cast<std::uint8_t>(0x90 | cc));
+    direct(0, reg);
+  }
+  void movzx8(Reg dst, Reg src) {
+    rex(false, dst, src);
+    byte(0x0F);
+    byte(0xB6);
+    direct(dst, src);
+  }
+  void cmov(Cond cc, Reg dst, Reg src) {
+    rex(true, dst, src);
+    byte(0x0F);
+    byte(static_cast<std::uint8_t>(0x40 | cc));
+    direct(dst, src);
+  }
+  void push(Reg reg) {
+    if (reg >= R8) byte(0x41);
+    byte(static_cast<std::uint8_t>(0x50 + (reg & 7)));
+  }
+  void pop(Reg reg) {
+    if (reg >= R8) byte(0x41);
+    byte(static_cast<std::uint8_t>(0x58 + (reg & 7)));
+  }
+  void ret() { byte(0xC3); }
+
+  // Forward branches: emit with a zero rel32 and patch once the target is bound.
+  std::size_t jcc(Cond cc) {
+    byte(0x0F);
+    byte(static_cast<std::uint8_t>(0x80 | cc));
+    u32(0);
+    return code.size() - 4;
+  }
+  // Conditional backward branch to an already emitted offset.
+  void jmp_back(Cond cc, std::size_t target) {
+    byte(0x0F);
+    byte(static_cast<std::uint8_t>(0x80 | cc));
+    const auto rel = static_cast<std::int32_t>(static_cast<std::int64_t>(target) -
+                                               static_cast<std::int64_t>(code.size() + 4));
+    u32(static_cast<std::uint32_t>(rel));
+  }
+  void bind(std::size_t patch) {
+    const auto rel = static_cast<std::int32_t>(code.size() - (patch + 4));
+    std::memcpy(code.data() + patch, &rel, sizeof(rel));
+  }
+};
+
+constexpr std::int32_t kRegistersOff = static_cast<std::int32_t>(offsetof(Context, registers));
+constexpr std::int32_t kTagsOff = static_cast<std::int32_t>(offsetof(Context, register_tags));
+constexpr std::int32_t kMemoryOff = static_cast<std::int32_t>(offsetof(Context, memory));
+constexpr std::int32_t kDirtyOff = static_cast<std::int32_t>(offsetof(Context, dirty_pages));
+constexpr std::int32_t kSpOff = static_cast<std::int32_t>(offsetof(Context, sp));
+constexpr std::int32_t kFlagsOff = static_cast<std::int32_t>(offsetof(Context, flags));
+constexpr std::int32_t kValuesOff = static_cast<std::int32_t>(offsetof(Context, write_values));
+constexpr std::int32_t kWriteTagsOff = static_cast<std::int32_t>(offsetof(Context, write_tags));
+constexpr std::int32_t kBudgetOff = static_cast<std::int32_t>(offsetof(Context, budget));
+constexpr std::int32_t kNextPcOff = static_cast<std::int32_t>(offsetof(Context, next_pc));
+constexpr std::int32_t kZeroOff = static_cast<std::int32_t>(offsetof(Flags, zero));
+constexpr std::int32_t kNegativeOff = static_cast<std::int32_t>(offsetof(Flags, negative));
+constexpr std::int32_t kPositiveOff = static_cast<std::int32_t>(offsetof(Flags, positive));
+
+constexpr Reg kCtx = RDI;
+constexpr Reg kRegs = RBX;
+constexpr Reg kTags = R12;
+constexpr Reg kMem = R13;
+constexpr Reg kValues = R14;
+constexpr Reg kWriteTags = R15;
+constexpr Reg kFlagValue = R11;  // last flag-setting result, valid once `flag_value` is true
+constexpr Reg kSaved[] = {RBX, R12, R13, R14, R15};
+
+std::int32_t reg_disp(std::int64_t idx) {
+  return static_cast<std::int32_t>(idx * 8);
+}
+
+// Emits the native body of one segment. Register layout: RDI context, RBX registers,
+// R12 tags, R13 memory, R14/R15 write log, R11 pending flag value, R9/R10 steps done in
+// earlier loop passes / budget left.
+class SegmentCompiler {
+ public:
+  SegmentCompiler(Assembler& as, const State& state, bool log_writes)
+      : as_(as), state_(state), log_writes_(log_writes) {}
+
+  void compile(const t81::tisc::Program& program, std::size_t begin, std::size_t length) {
+    for (const auto reg : kSaved) {
+      as_.push(reg);
+    }
+    as_.mov_load(kRegs, kCtx, kRegistersOff);
+    as_.mov_load(kTags, kCtx, kTagsOff);
+    as_.mov_load(kMem, kCtx, kMemoryOff);
+    if (log_writes_) {
+      as_.mov_load(kValues, kCtx, kValuesOff);
+      as_.mov_load(kWriteTags, kCtx, kWriteTagsOff);
+    }
+    // Without a write log to fill, a segment that jumps back to its own start (a loop
+    // body) iterates natively while the budget covers another full pass.
+    const auto& last = program.insns[begin + length - 1];
+    loops_ = !log_writes_ && is_jump(last.opcode) && last.a == static_cast<std::int64_t>(begin);
+    begin_ = begin;
+    length_ = length;
+    if (loops_) {
+      as_.mov_imm(R9, 0);
+      as_.mov_load(R10, kCtx, kBudgetOff);
+      loop_top_ = as_.code.size();
+    }
+    flag_value_ = false;
+    for (std::size_t k = 0; k < length; ++k) {
+      const auto& insn = program.insns[begin + k];
+      if (is_jump(insn.opcode)) {
+        emit_jump(insn, begin + k, k + 1);
+        return;
+      }
+      emit(insn, begin + k, k);
+      if (sets_flags(insn.opcode)) {
+        flag_value_ = true;
+      }
+    }
+    exit(begin + length, length);
+  }
+
+ private:
+  void store_flags() {
+    if (flag_value_) {
+      as_.mov_load(RSI, kCtx, kFlagsOff);
+      as_.rr(0x85, kFlagValue, kFlagValue);
+      as_.setcc(kE, RAX);
+      as_.store8(RSI, kZeroOff, RAX);
+      as_.setcc(kS, RAX);
+      as_.store8(RSI, kNegativeOff, RAX);
+      as_.setcc(kG, RAX);
+      as_.store8(RSI, kPositiveOff, RAX);
+    }
+  }
+
+  // Leaves the segment: publishes pending flags, next pc and the completed count
+  // (`completed` in this pass plus R9 from earlier passes of a loop).
+  void exit(std::size_t next_pc, std::size_t completed) {
+    store_flags();
+    as_.mov_imm(RAX, static_cast<std::int64_t>(next_pc));
+    as_.mov_store(kCtx, kNextPcOff, RAX);
+    as_.mov_imm(RAX, static_cast<std::int64_t>(completed));
+    if (loops_) {
+      as_.rr(0x01, RAX, R9);
+    }
+    for (auto it = std::rbegin(kSaved); it != std::rend(kSaved); ++it) {
+      as_.pop(*it);
+    }
+    as_.ret();
+  }
+
+  // Exit taken when instruction `k` (at `pc`) has to run on the reference path.
+  void bail_if(Cond cc, std::size_t pc, std::size_t k) {
+    const auto skip = as_.jcc(static_cast<Cond>(cc ^ 1));
+    exit(pc, k);
+    as_.bind(skip);
+  }
+
+  void write_int(std::int64_t reg, std::size_t k, bool logged) {
+    as_.mov_store(kRegs, reg_disp(reg), RAX);
+    as_.store8_imm(kTags, static_cast<std::int32_t>(reg), static_cast<std::uint8_t>(ValueTag::Int));
+    if (logged && log_writes_) {
+      as_.mov_store(kValues, reg_disp(static_cast<std::int64_t>(k)), RAX);
+    }
+  }
+
+  void set_flag_value() { as_.rr(0x89, kFlagValue, RAX); }
+
+  void clamp_trit(Reg reg) {
+    as_.mov_imm(RDX, 1);
+    as_.rr(0x39, reg, RDX);
+    as_.cmov(kG, reg, RDX);
+    as_.mov_imm(RDX, -1);
+    as_.rr(0x39, reg, RDX);
+    as_.cmov(kL, reg, RDX);
+  }
+
+  void mark_dirty(Reg addr) {
+    as_.shift(5, addr, 6);
+    static_assert(MemoryPages::kPageWords == 64);
+    as_.load(0x03, addr, kCtx, kDirtyOff);
+    as_.store8_imm(addr, 0, 1);
+  }
+
+  void emit(const t81::tisc::Insn& insn, std::size_t pc, std::size_t k) {
+    switch (insn.opcode) {
+      case Opcode::Nop:
+        return;
+      case Opcode::LoadImm:
+        as_.mov_imm(RAX, insn.b);
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Load:
+        as_.mov_load(RAX, kMem, reg_disp(insn.b));
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Store:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.mov_store(kMem, reg_disp(insn.a), RAX);
+        as_.mov_load(RDX, kCtx, kDirtyOff);
+        as_.store8_imm(RDX, static_cast<std::int32_t>(insn.a / static_cast<std::int64_t>(MemoryPages::kPageWords)), 1);
+        return;
+      case Opcode::Add:
+      case Opcode::FAdd:
+      case Opcode::FracAdd:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.load(0x03, RAX, kRegs, reg_disp(insn.c));
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Sub:
+      case Opcode::FSub:
+      case Opcode::FracSub:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.load(0x2B, RAX, kRegs, reg_disp(insn.c));
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Mul:
+      case Opcode::FMul:
+      case Opcode::FracMul:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.imul_load(RAX, kRegs, reg_disp(insn.c));
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Div:
+      case Opcode::FDiv:
+      case Opcode::FracDiv:
+      case Opcode::Mod:
+        as_.mov_load(RCX, kRegs, reg_disp(insn.c));
+        as_.rr(0x85, RCX, RCX);
+        bail_if(kE, pc, k);
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.cqo();
+        as_.idiv(RCX);
+        if (insn.opcode == Opcode::Mod) {
+          as_.rr(0x89, RAX, RDX);
+        }
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Mov:
+      case Opcode::I2F:
+      case Opcode::F2I:
+      case Opcode::I2Frac:
+      case Opcode::Frac2I:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.movzx_load(RCX, kTags, static_cast<std::int32_t>(insn.b));
+        as_.mov_store(kRegs, reg_disp(insn.a), RAX);
+        as_.store8(kTags, static_cast<std::int32_t>(insn.a), RCX);
+        if (log_writes_) {
+          as_.mov_store(kValues, reg_disp(static_cast<std::int64_t>(k)), RAX);
+          as_.store8(kWriteTags, static_cast<std::int32_t>(k), RCX);
+        }
+        return set_flag_value();
+      case Opcode::Inc:
+      case Opcode::Dec:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.a));
+        as_.add_imm8(RAX, insn.opcode == Opcode::Inc ? 1 : -1);
+        write_int(insn.a, k, false);
+        return set_flag_value();
+      case Opcode::Cmp:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.a));
+        as_.load(0x2B, RAX, kRegs, reg_disp(insn.b));
+        return set_flag_value();
+      case Opcode::Neg:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        as_.neg(RAX);
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::TNot:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        clamp_trit(RAX);
+        as_.neg(RAX);
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::TAnd:
+      case Opcode::TOr:
+      case Opcode::TXor:
+        as_.mov_load(RAX, kRegs, reg_disp(insn.b));
+        clamp_trit(RAX);
+        as_.mov_load(RCX, kRegs, reg_disp(insn.c));
+        clamp_trit(RCX);
+        if (insn.opcode == Opcode::TXor) {
+          as_.rr(0x29, RAX, RCX);
+          as_.mov_imm(RDX, -1);
+          as_.cmp_imm8(RAX, 1);
+          as_.cmov(kG, RAX, RDX);
+          as_.mov_imm(RDX, 1);
+          as_.cmp_imm8(RAX, -1);
+          as_.cmov(kL, RAX, RDX);
+        } else {
+          as_.rr(0x39, RAX, RCX);
+          as_.cmov(insn.opcode == Opcode::TAnd ? kG : kL, RAX, RCX);
+        }
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      case Opcode::Less:
+      case Opcode::LessEqual:
+      case Opcode::Greater:
+      case Opcode::GreaterEqual:
+      case Opcode::Equal:
+      case Opcode::NotEqual: {
+        const Cond cc = insn.opcode == Opcode::Less           ? kL
+                        : insn.opcode == Opcode::LessEqual    ? kLE
+                        : insn.opcode == Opcode::Greater      ? kG
+                        : insn.opcode == Opcode::GreaterEqual ? kGE
+                        : insn.opcode == Opcode::Equal        ? kE
+                                                              : kNE;
+        as_.mov_load(RCX, kRegs, reg_disp(insn.b));
+        as_.load(0x3B, RCX, kRegs, reg_disp(insn.c));
+        as_.setcc(cc, RAX);
+        as_.movzx8(RAX, RAX);
+        write_int(insn.a, k, true);
+        return set_flag_value();
+      }
+      case Opcode::Push:
+        // Faults unless stack.start < sp (which also excludes sp == 0).
+        as_.mov_load(RSI, kCtx, kSpOff);
+        as_.mov_load(RCX, RSI, 0);
+        as_.mov_imm(RDX, static_cast<std::int64_t>(state_.layout.stack.start));
+        as_.rr(0x39, RCX, RDX);
+        bail_if(kBE, pc, k);
+        as_.add_imm8(RCX, -1);
+        as_.mov_store(RSI, 0, RCX);
+        as_.mov_load(RAX, kRegs, reg_disp(insn.a));
+        as_.rr(0x89, RDX, RCX);
+        as_.shift(4, RDX, 3);
+        as_.rr(0x01, RDX, kMem);
+        as_.mov_store(RDX, 0, RAX);
+        return mark_dirty(RCX);
+      case Opcode::Pop:
+        as_.mov_load(RSI, kCtx, kSpOff);
+        as_.mov_load(RCX, RSI, 0);
+        as_.mov_imm(RDX, static_cast<std::int64_t>(state_.layout.stack.limit));
+        as_.rr(0x39, RCX, RDX);
+        bail_if(kAE, pc, k);
+        as_.rr(0x89, RDX, RCX);
+        as_.shift(4, RDX, 3);
+        as_.rr(0x01, RDX, kMem);
+        as_.mov_load(RAX, RDX, 0);
+        write_int(insn.a, k, false);
+        as_.add_imm8(RCX, 1);
+        as_.mov_store(RSI, 0, RCX);
+        return set_flag_value();
+      default:
+        return;
+    }
+  }
+
+  // Ends the segment with a (conditional) jump; `completed` includes the jump itself.
+  void emit_jump(const t81::tisc::Insn& insn, std::size_t pc, std::size_t completed) {
+    const auto target = static_cast<std::size_t>(insn.a);
+    if (insn.opcode == Opcode::Jump) {
+      return jump_to(target, completed);
+    }
+    Cond taken = kNE;
+    if (flag_value_) {
+      as_.rr(0x85, kFlagValue, kFlagValue);
+      taken = insn.opcode == Opcode::JumpIfZero       ? kE
+              : insn.opcode == Opcode::JumpIfNotZero  ? kNE
+              : insn.opcode == Opcode::JumpIfNegative ? kS
+                                                      : kG;
+    } else {
+      // No flag setter ran in this segment: test the committed flags.
+      const std::int32_t off = insn.opcode == Opcode::JumpIfNegative   ? kNegativeOff
+                               : insn.opcode == Opcode::JumpIfPositive ? kPositiveOff
+                                                                       : kZeroOff;
+      as_.mov_load(RSI, kCtx, kFlagsOff);
+      as_.movzx_load(RAX, RSI, off);
+      as_.rr(0x85, RAX, RAX);
+      taken = insn.opcode == Opcode::JumpIfNotZero ? kE : kNE;
+    }
+    const auto branch = as_.jcc(taken);
+    exit(pc + 1, completed);
+    as_.bind(branch);
+    jump_to(target, completed);
+  }
+
+  // Taken jump. In a looping segment the back edge commits the pass (flags to memory,
+  // R9 += length, R10 -= length) and re-enters the body if R10 still covers a pass.
+  void jump_to(std::size_t target, std::size_t completed) {
+    if (!loops_ || target != begin_) {
+      return exit(target, completed);
+    }
+    store_flags();
+    as_.mov_imm(RDX, static_cast<std::int64_t>(length_));
+    as_.rr(0x01, R9, RDX);
+    as_.rr(0x29, R10, RDX);
+    as_.rr(0x39, R10, RDX);
+    as_.jmp_back(kAE, loop_top_);
+    flag_value_ = false;
+    exit(target, 0);
+  }
+
+  Assembler& as_;
+  const State& state_;
+  bool log_writes_;
+  bool flag_value_ = false;
+  bool loops_ = false;
+  std::size_t begin_ = 0;
+  std::size_t length_ = 0;
+  std::size_t loop_top_ = 0;
+};
+
+#endif  // T81_VM_JIT_X86_64
+
+}  // namespace
+
+WriteKind write_kind(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::LoadImm:
+    case Opcode::Load:
+    case Opcode::Add:
+    case Opcode::Sub:
+    case Opcode::Mul:
+    case Opcode::Div:
+    case Opcode::Mod:
+    case Opcode::FAdd:
+    case Opcode::FSub:
+    case Opcode::FMul:
+    case Opcode::FDiv:
+    case Opcode::FracAdd:
+    case Opcode::FracSub:
+    case Opcode::FracMul:
+    case Opcode::FracDiv:
+    case Opcode::Neg:
+    case Opcode::TNot:
+    case Opcode::TAnd:
+    case Opcode::TOr:
+    case Opcode::TXor:
+    case Opcode::Less:
+    case Opcode::LessEqual:
+    case Opcode::Greater:
+    case Opcode::GreaterEqual:
+    case Opcode::Equal:
+    case Opcode::NotEqual:
+      return WriteKind::Int;
+    case Opcode::Mov:
+    case Opcode::I2F:
+    case Opcode::F2I:
+    case Opcode::I2Frac:
+    case Opcode::Frac2I:
+      return WriteKind::Copy;
+    default:
+      return WriteKind::None;
+  }
+}
+
+bool available() {
+#ifdef T81_VM_JIT_X86_64
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::vector<Segment> plan_segments(const t81::tisc::Program& program, const State& state) {
+  // Segments are maximal runs of compilable instructions that stay inside one basic
+  // block; a jump can therefore only be the last instruction of a segment.
+  std::vector<bool> is_leader(program.insns.size(), false);
+  for (const auto pc : basic_block_leaders(program)) {
+    is_leader[pc] = true;
+  }
+  std::vector<Segment> segments;
+  std::size_t pc = 0;
+  while (pc < program.insns.size()) {
+    if (!compilable(program.insns[pc], state)) {
+      ++pc;
+      continue;
+    }
+    std::size_t end = pc + 1;
+    while (end < program.insns.size() && !is_leader[end] && !is_jump(program.insns[end - 1].opcode) &&
+           compilable(program.insns[end], state)) {
+      ++end;
+    }
+    const bool stores = std::any_of(program.insns.begin() + static_cast<std::ptrdiff_t>(pc),
+                                    program.insns.begin() + static_cast<std::ptrdiff_t>(end),
+                                    [](const auto& insn) { return insn.opcode == Opcode::Store; });
+    segments.push_back(Segment{.begin = pc, .length = end - pc, .stores = stores, .fn = nullptr});
+    pc = end;
+  }
+  return segments;
+}
+
+NativeProgram::NativeProgram(NativeProgram&& other) noexcept
+    : code_(std::exchange(other.code_, nullptr)),
+      code_size_(std::exchange(other.code_size_, 0)),
+      segments_(std::move(other.segments_)),
+      index_(std::move(other.index_)),
+      max_length_(std::exchange(other.max_length_, 0)),
+      owner_(std::move(other.owner_)) {}
+
+NativeProgram& NativeProgram::operator=(NativeProgram&& other) noexcept {
+  if (this != &other) {
+    clear();
+    code_ = std::exchange(other.code_, nullptr);
+    code_size_ = std::exchange(other.code_size_, 0);
+    segments_ = std::move(other.segments_);
+    index_ = std::move(other.index_);
+    max_length_ = std::exchange(other.max_length_, 0);
+    owner_ = std::move(other.owner_);
+  }
+  return *this;
+}
+
+NativeProgram::~NativeProgram() {
+  clear();
+}
+
+void NativeProgram::clear() {
+#ifdef T81_VM_JIT_X86_64
+  if (code_ != nullptr) {
+    munmap(code_, code_size_);
+  }
+#endif
+  code_ = nullptr;
+  code_size_ = 0;
+  segments_.clear();
+  index_.clear();
+  max_length_ = 0;
+  owner_.reset();
+}
+
+void NativeProgram::adopt(std::vector<Segment> segments, std::size_t program_size, std::shared_ptr<const void> owner) {
+  clear();
+  segments_ = std::move(segments);
+  owner_ = std::move(owner);
+  index_.assign(program_size, -1);
+  for (std::size_t i = 0; i < segments_.size(); ++i) {
+    index_[segments_[i].begin] = static_cast<std::int32_t>(i);
+    max_length_ = std::max(max_length_, segments_[i].length);
+  }
+}
+
+void NativeProgram::compile(const t81::tisc::Program& program, const State& state, bool log_writes) {
+  clear();
+#ifdef T81_VM_JIT_X86_64
+  Assembler as;
+  std::vector<std::size_t> offsets;
+  segments_ = plan_segments(program, state);
+  for (const auto& segment : segments_) {
+    offsets.push_back(as.code.size());
+    SegmentCompiler(as, state, log_writes).compile(program, segment.begin, segment.length);
+    max_length_ = std::max(max_length_, segment.length);
+  }
+  if (segments_.empty()) {
+    return;
+  }
+
+  void* mapping = mmap(nullptr, as.code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    segments_.clear();
+    max_length_ = 0;
+    return;
+  }
+  std::memcpy(mapping, as.code.data(), as.code.size());
+  if (mprotect(mapping, as.code.size(), PROT_READ | PROT_EXEC) != 0) {
+    munmap(mapping, as.code.size());
+    segments_.clear();
+    max_length_ = 0;
+    return;
+  }
+  code_ = mapping;
+  code_size_ = as.code.size();
+  index_.assign(program.insns.size(), -1);
+  for (std::size_t i = 0; i < segments_.size(); ++i) {
+    segments_[i].fn = reinterpret_cast<SegmentFn>(static_cast<std::uint8_t*>(code_) + offsets[i]);
+    index_[segments_[i].begin] = static_cast<std::int32_t>(i);
+  }
+#else
+  (void)program;
+  (void)state;
+  (void)log_writes;
+#endif
+}
+
+}  // namespace t81::vm::jit
@@ -1,11 +1,20 @@
 #include <cctype>
 #include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "t81/vm/aot.hpp"
+#include "t81/vm/jit.hpp"
+#include "t81/vm/profile.hpp"
+#include "t81/vm/program_cache.hpp"
 #include "t81/vm/program_io.hpp"
 #include "t81/vm/summary.hpp"
+#include "t81/vm/trace_format.hpp"
+#include "t81/vm/trace_sink.hpp"
 #include "t81/vm/traps.hpp"
 #include "t81/vm/vm.hpp"
 
@@ -13,14 +22,7 @@ namespace {
 
 void print_trace(const t81::vm::State& s) {
   for (const auto& e : s.trace) {
-    std::cout << e.pc << ":" << static_cast<int>(e.opcode);
-    if (e.write_reg.has_value() && e.write_value.has_value() && e.write_tag.has_value()) {
-      std::cout << ":write=r" << *e.write_reg << "=" << *e.write_value << ":" << t81::vm::to_string(*e.write_tag);
-    }
-    if (e.trap.has_value()) {
-      std::cout << ":trap=" << t81::vm::to_string(*e.trap);
-    }
-    std::cout << "\n";
+    std::cout << t81::vm::trace_line(e) << "\n";
   }
 }
 
@@ -42,8 +44,14 @@ std::string canonical_passthrough(const std::string& in) {
 
 void usage() {
   std::cerr
-      << "usage: t81vm [--trace] [--snapshot] [--max-steps N] [--mode interpreter|accelerated-preview] "
-         "<program.t81vm|program.tisc.json>\n";
+      << "usage: t81vm [--trace] [--snapshot] [--max-steps N] [--mode interpreter|accelerated-preview|jit|tiered] "
+         "[--trace-level full|digest|none|flight-recorder] [--flight-recorder-depth N] [--trace-file PATH] "
+         "[--trace-format text|binary] [--axion-log all|no-segment-access|off] [--no-axion-log] "
+         "[--profile] [--profile-folded PATH] [--aot-module PATH] [--tier-threshold N] [--tier-report] "
+         "[--program-cache DIR] <program.t81vm|program.tisc.json|program.tiscb>\n"
+      << "       t81vm --emit-tisc-bin OUT.tiscb <program.t81vm|program.tisc.json>\n"
+      << "       t81vm --emit-cpp OUT.cpp|--aot-build OUT.so <program.t81vm|program.tisc.json>\n"
+      << "       t81vm --trace-to-text <trace.bin>\n";
 }
 
 }  // namespace
@@ -69,10 +77,35 @@ int main(int argc, char** argv) {
     return 0;
   }
 
+  if (args.size() == 2 && args[0] == "--trace-to-text") {
+    std::ifstream in(args[1], std::ios::binary);
+    if (!in) {
+      std::cerr << "FAULT TraceFileError: unable to open file: " << args[1] << "\n";
+      return 1;
+    }
+    const auto error = t81::vm::convert_binary_trace_to_text(in, std::cout);
+    if (!error.empty()) {
+      std::cerr << "FAULT TraceFileError: " << error << "\n";
+      return 1;
+    }
+    return 0;
+  }
+
   bool emit_trace = false;
   bool emit_snapshot = false;
   std::size_t max_steps = 100000;
   std::string mode = "interpreter";
+  t81::vm::VmOptions options;
+  std::string trace_file;
+  auto trace_format = t81::vm::TraceFileFormat::Text;
+  bool emit_profile = false;
+  bool emit_tier_report = false;
+  std::string profile_folded_path;
+  std::string emit_tisc_bin_path;
+  std::string emit_cpp_path;
+  std::string aot_build_path;
+  std::string aot_module_path;
+  std::string program_cache_dir;
   std::string program_path;
 
   for (std::size_t i = 0; i < args.size(); ++i) {
@@ -103,10 +136,119 @@ int main(int argc, char** argv) {
         return 2;
       }
       mode = args[++i];
-      if (mode != "interpreter" && mode != "accelerated-preview") {
+      if (mode != "interpreter" && mode != "accelerated-preview" && mode != "jit" && mode != "tiered") {
         usage();
         return 2;
       }
+    } else if (arg == "--trace-level") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      const auto& level = args[++i];
+      if (level == "full") {
+        options.trace = t81::vm::TraceLevel::Full;
+      } else if (level == "digest") {
+        options.trace = t81::vm::TraceLevel::Digest;
+      } else if (level == "none") {
+        options.trace = t81::vm::TraceLevel::None;
+      } else if (level == "flight-recorder") {
+        options.trace = t81::vm::TraceLevel::FlightRecorder;
+      } else {
+        usage();
+        return 2;
+      }
+    } else if (arg == "--flight-recorder-depth") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      try {
+        options.flight_recorder_depth = static_cast<std::size_t>(std::stoull(args[++i]));
+      } catch (...) {
+        usage();
+        return 2;
+      }
+      if (options.flight_recorder_depth == 0) {
+        usage();
+        return 2;
+      }
+    } else if (arg == "--trace-file") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      trace_file = args[++i];
+    } else if (arg == "--trace-format") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      const auto& format = args[++i];
+      if (format == "text") {
+        trace_format = t81::vm::TraceFileFormat::Text;
+      } else if (format == "binary") {
+        trace_format = t81::vm::TraceFileFormat::Binary;
+      } else {
+        usage();
+        return 2;
+      }
+    } else if (arg == "--no-axion-log") {
+      options.axion_log = t81::vm::AxionLogLevel::Off;
+    } else if (arg == "--axion-log") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      const auto& level = args[++i];
+      if (level == "all") {
+        options.axion_log = t81::vm::AxionLogLevel::All;
+      } else if (level == "no-segment-access") {
+        options.axion_log = t81::vm::AxionLogLevel::NoSegmentAccess;
+      } else if (level == "off") {
+        options.axion_log = t81::vm::AxionLogLevel::Off;
+      } else {
+        usage();
+        return 2;
+      }
+    } else if (arg == "--tier-threshold") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      try {
+        options.tier_up_threshold = std::stoull(args[++i]);
+      } catch (...) {
+        usage();
+        return 2;
+      }
+      if (options.tier_up_threshold == 0) {
+        usage();
+        return 2;
+      }
+    } else if (arg == "--tier-report") {
+      emit_tier_report = true;
+    } else if (arg == "--profile") {
+      emit_profile = true;
+    } else if (arg == "--profile-folded") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      profile_folded_path = args[++i];
+      emit_profile = true;
+    } else if (arg == "--emit-tisc-bin" || arg == "--emit-cpp" || arg == "--aot-build" || arg == "--aot-module" ||
+               arg == "--program-cache") {
+      if (i + 1 >= args.size()) {
+        usage();
+        return 2;
+      }
+      auto& path = arg == "--emit-tisc-bin" ? emit_tisc_bin_path
+                   : arg == "--emit-cpp"    ? emit_cpp_path
+                   : arg == "--aot-build"   ? aot_build_path
+                   : arg == "--aot-module"  ? aot_module_path
+                                            : program_cache_dir;
+      path = args[++i];
     } else if (!arg.empty() && arg[0] == '-') {
       usage();
       return 2;
@@ -124,23 +266,136 @@ int main(int argc, char** argv) {
     return 2;
   }
 
+  if ((!trace_file.empty() && options.trace == t81::vm::TraceLevel::None) ||
+      (trace_file.empty() && trace_format != t81::vm::TraceFileFormat::Text)) {
+    usage();
+    return 2;
+  }
+  if (options.trace != t81::vm::TraceLevel::Full) {
+    if (emit_trace) {
+      usage();
+      return 2;
+    }
+    emit_snapshot = true;
+  }
   if (!emit_trace && !emit_snapshot) {
     emit_trace = true;
   }
 
-  const auto loaded = t81::vm::load_program_from_file(program_path);
+  std::optional<t81::vm::ProgramCache> cache;
+  if (!program_cache_dir.empty()) {
+    cache.emplace(program_cache_dir);
+  }
+  const auto loaded = cache ? cache->load(program_path) : t81::vm::load_program_image_from_file(program_path);
+  if (cache) {
+    const auto& stats = cache->stats();
+    std::cerr << "PROGRAM_CACHE " << (loaded.cache_hit ? "hit" : "miss") << " hits=" << stats.hits
+              << " misses=" << stats.misses << " stores=" << stats.stores << " invalid=" << stats.invalid << "\n";
+  }
   if (!loaded.ok) {
     std::cerr << "FAULT ParseError: " << loaded.error << "\n";
     return 1;
   }
+  const auto& program = loaded.image.program;
+
+  if (!emit_tisc_bin_path.empty()) {
+    std::ofstream bin(emit_tisc_bin_path, std::ios::binary);
+    bin << t81::vm::encode_tisc_bin_v1(program);
+    if (!bin) {
+      std::cerr << "FAULT ProgramFileError: unable to write file: " << emit_tisc_bin_path << "\n";
+      return 1;
+    }
+    return 0;
+  }
+  if (!emit_cpp_path.empty()) {
+    std::ofstream source(emit_cpp_path, std::ios::binary);
+    source << t81::vm::emit_cpp(program);
+    if (!source) {
+      std::cerr << "FAULT AotBuildError: unable to write file: " << emit_cpp_path << "\n";
+      return 1;
+    }
+    return 0;
+  }
+  if (!aot_build_path.empty()) {
+    const auto built = t81::vm::compile_aot(program, aot_build_path);
+    if (!built.ok) {
+      std::cerr << "FAULT AotBuildError: " << built.error << "\n";
+      return 1;
+    }
+    return 0;
+  }
 
-  auto vm = t81::vm::make_interpreter_vm();
   if (mode == "accelerated-preview") {
-    // Acceleration mode is intentionally preview-only; behavior remains contract-compatible interpreter execution.
-    std::cerr << "MODE accelerated-preview (preview): using interpreter backend\n";
+    options.mode = t81::vm::ExecutionMode::AcceleratedPreview;
+  } else if (mode == "jit") {
+    options.mode = t81::vm::ExecutionMode::Jit;
+  } else if (mode == "tiered") {
+    options.mode = t81::vm::ExecutionMode::Tiered;
+  }
+  if (!aot_module_path.empty()) {
+    auto opened = t81::vm::AotModule::open(aot_module_path);
+    if (!opened.ok) {
+      std::cerr << "FAULT AotLoadError: " << opened.error << "\n";
+      return 1;
+    }
+    if (!opened.module->matches(program)) {
+      std::cerr << "FAULT AotLoadError: module was built for a different program: " << aot_module_path << "\n";
+      return 1;
+    }
+    options.mode = t81::vm::ExecutionMode::Aot;
+    options.aot_module = std::move(opened.module);
+  }
+  std::unique_ptr<t81::vm::IVirtualMachine> vm = t81::vm::make_vm(options);
+  t81::vm::ProfilingVm* profiler = nullptr;
+  if (emit_profile) {
+    auto wrapped = std::make_unique<t81::vm::ProfilingVm>(std::move(vm));
+    profiler = wrapped.get();
+    vm = std::move(wrapped);
+  }
+  if (options.mode == t81::vm::ExecutionMode::AcceleratedPreview) {
+    // Acceleration mode is intentionally preview-only; behavior must remain contract-compatible with interpreter mode.
+    std::cerr << "MODE accelerated-preview (preview): using pre-decoded basic-block backend\n";
+  } else if (options.mode == t81::vm::ExecutionMode::Jit) {
+    std::cerr << (t81::vm::jit::available()
+                      ? "MODE jit (preview): compiling scalar segments to native x86-64 code\n"
+                      : "MODE jit (preview): native code unavailable on this host; using pre-decoded backend\n");
+  } else if (options.mode == t81::vm::ExecutionMode::Aot) {
+    std::cerr << "MODE aot (preview): running native segments from " << aot_module_path << "\n";
+  } else if (options.mode == t81::vm::ExecutionMode::Tiered) {
+    std::cerr << "MODE tiered (preview): promoting basic blocks to the pre-decoded backend after "
+              << options.tier_up_threshold << " entries\n";
   }
-  vm->load_program(loaded.program);
+  std::unique_ptr<t81::vm::FileTraceSink> sink;
+  if (!trace_file.empty()) {
+    sink = std::make_unique<t81::vm::FileTraceSink>(trace_file, std::size_t{1} << 16, trace_format);
+    if (!sink->ok()) {
+      std::cerr << "FAULT TraceFileError: unable to open file: " << trace_file << "\n";
+      return 1;
+    }
+    vm->set_trace_sink(sink.get());
+  }
+  vm->load_image(loaded.image);
   auto res = vm->run_to_halt(max_steps);
+  if (sink) {
+    vm->set_trace_sink(nullptr);
+    sink.reset();
+  }
+
+  if (profiler != nullptr) {
+    std::cerr << t81::vm::profile_report(profiler->profile());
+    if (!profile_folded_path.empty()) {
+      std::ofstream folded(profile_folded_path, std::ios::binary);
+      folded << t81::vm::profile_folded(profiler->profile());
+      if (!folded) {
+        std::cerr << "FAULT ProfileFileError: unable to write file: " << profile_folded_path << "\n";
+        return 1;
+      }
+    }
+  }
+
+  if (emit_tier_report) {
+    std::cerr << t81::vm::tier_report(vm->state());
+  }
 
   if (emit_trace) {
     print_trace(vm->state());
@@ -155,6 +410,7 @@ int main(int argc, char** argv) {
     if (!payload_line.empty()) {
       std::cerr << payload_line << "\n";
     }
+    std::cerr << t81::vm::flight_recorder_dump(vm->state());
     return 1;
   }
 
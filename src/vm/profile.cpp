@@ -0,0 +1,188 @@
+#include "t81/vm/profile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "t81/vm/validator.hpp"
+
+namespace t81::vm {
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+constexpr const char* kClock = "tsc";
+inline std::uint64_t read_cycles() {
+  return __rdtsc();
+}
+#else
+constexpr const char* kClock = "ns";
+inline std::uint64_t read_cycles() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+#endif
+
+std::string frame_name(const ExecutionProfile& profile, std::size_t path) {
+  return path == 0 ? "main" : "fn@" + std::to_string(profile.paths[path].entry_pc);
+}
+
+std::string percent(std::uint64_t part, std::uint64_t total) {
+  std::ostringstream out;
+  out.setf(std::ios::fixed);
+  out.precision(1);
+  out << (total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total));
+  return out.str();
+}
+
+// Indices of `counters` with a nonzero count, hottest (by cycles, then lowest index) first.
+std::vector<std::size_t> hottest(const std::vector<ProfileCounter>& counters, std::size_t limit) {
+  std::vector<std::size_t> order;
+  for (std::size_t i = 0; i < counters.size(); ++i) {
+    if (counters[i].count != 0) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t a, std::size_t b) { return counters[a].cycles > counters[b].cycles; });
+  if (order.size() > limit) {
+    order.resize(limit);
+  }
+  return order;
+}
+
+}  // namespace
+
+ProfilingVm::ProfilingVm(std::unique_ptr<IVirtualMachine> inner) : inner_(std::move(inner)) {
+  profile_.clock = kClock;
+}
+
+void ProfilingVm::load_program(const t81::tisc::Program& program) {
+  inner_->load_program(program);
+  reset_profile(program);
+}
+
+void ProfilingVm::load_image(const LoadedProgram& image) {
+  inner_->load_image(image);
+  reset_profile(image.program);
+}
+
+void ProfilingVm::reset_profile(const t81::tisc::Program& program) {
+  profile_ = ExecutionProfile{};
+  profile_.clock = kClock;
+  profile_.by_pc.assign(program.insns.size(), ProfileCounter{});
+  profile_.block_leaders = basic_block_leaders(program);
+  profile_.by_block.assign(profile_.block_leaders.size(), ProfileCounter{});
+  profile_.opcode_at_pc.reserve(program.insns.size());
+  for (const auto& insn : program.insns) {
+    profile_.opcode_at_pc.push_back(insn.opcode);
+  }
+  profile_.paths.assign(1, ProfilePath{});
+  path_ = 0;
+  children_.clear();
+}
+
+std::expected<void, Trap> ProfilingVm::step() {
+  const auto& s = inner_->state();
+  const std::size_t pc = s.pc;
+  const bool running = !s.halted;
+  const auto opcode = pc < profile_.opcode_at_pc.size() ? profile_.opcode_at_pc[pc] : t81::tisc::Opcode::Nop;
+
+  const std::uint64_t begin = read_cycles();
+  auto res = inner_->step();
+  const std::uint64_t spent = read_cycles() - begin;
+
+  if (!running) {
+    return res;
+  }
+  ++profile_.steps;
+  profile_.cycles += spent;
+  auto bump = [&](ProfileCounter& c) {
+    ++c.count;
+    c.cycles += spent;
+  };
+  // Running off the end of the program traps without an instruction to charge.
+  if (pc < profile_.by_pc.size()) {
+    bump(profile_.by_opcode[static_cast<std::size_t>(opcode)]);
+    profile_.paths[path_].cycles[static_cast<std::size_t>(opcode)] += spent;
+    bump(profile_.by_pc[pc]);
+    const auto leader = std::upper_bound(profile_.block_leaders.begin(), profile_.block_leaders.end(), pc);
+    bump(profile_.by_block[static_cast<std::size_t>(leader - profile_.block_leaders.begin()) - 1]);
+  }
+
+  if (res.has_value() && opcode == t81::tisc::Opcode::Call) {
+    const auto key = std::make_pair(path_, inner_->state().pc);
+    auto it = children_.find(key);
+    if (it == children_.end()) {
+      profile_.paths.push_back(ProfilePath{.parent = path_, .entry_pc = key.second});
+      it = children_.emplace(key, profile_.paths.size() - 1).first;
+    }
+    path_ = it->second;
+  } else if (res.has_value() && opcode == t81::tisc::Opcode::Ret) {
+    path_ = profile_.paths[path_].parent;
+  }
+  return res;
+}
+
+std::expected<void, Trap> ProfilingVm::run_to_halt(std::size_t max_steps) {
+  for (std::size_t i = 0; i < max_steps; ++i) {
+    auto res = step();
+    if (!res.has_value()) {
+      return std::unexpected(res.error());
+    }
+    if (inner_->state().halted) {
+      return {};
+    }
+  }
+  return std::unexpected(Trap::TrapInstruction);
+}
+
+std::string profile_report(const ExecutionProfile& profile, std::size_t limit) {
+  std::ostringstream out;
+  out << "PROFILE steps=" << profile.steps << " cycles=" << profile.cycles << " clock=" << profile.clock << "\n";
+
+  const std::vector<ProfileCounter> by_opcode(profile.by_opcode.begin(), profile.by_opcode.end());
+  for (const auto op : hottest(by_opcode, limit)) {
+    const auto& c = by_opcode[op];
+    out << "PROFILE_OPCODE " << t81::tisc::to_string(static_cast<t81::tisc::Opcode>(op)) << " count=" << c.count
+        << " cycles=" << c.cycles << " share=" << percent(c.cycles, profile.cycles) << "%\n";
+  }
+  for (const auto pc : hottest(profile.by_pc, limit)) {
+    const auto& c = profile.by_pc[pc];
+    out << "PROFILE_PC " << pc << " " << t81::tisc::to_string(profile.opcode_at_pc[pc]) << " count=" << c.count
+        << " cycles=" << c.cycles << " share=" << percent(c.cycles, profile.cycles) << "%\n";
+  }
+  for (const auto b : hottest(profile.by_block, limit)) {
+    const auto& c = profile.by_block[b];
+    const std::size_t end = b + 1 < profile.block_leaders.size() ? profile.block_leaders[b + 1]
+                                                                  : profile.opcode_at_pc.size();
+    out << "PROFILE_BLOCK " << profile.block_leaders[b] << "-" << end - 1 << " count=" << c.count
+        << " cycles=" << c.cycles << " share=" << percent(c.cycles, profile.cycles) << "%\n";
+  }
+  return out.str();
+}
+
+std::string profile_folded(const ExecutionProfile& profile) {
+  std::string out;
+  for (std::size_t path = 0; path < profile.paths.size(); ++path) {
+    std::string stack = frame_name(profile, path);
+    for (std::size_t p = path; p != 0;) {
+      p = profile.paths[p].parent;
+      stack = frame_name(profile, p) + ";" + stack;
+    }
+    for (std::size_t op = 0; op < profile.paths[path].cycles.size(); ++op) {
+      const auto cycles = profile.paths[path].cycles[op];
+      if (cycles != 0) {
+        out += "t81vm;" + stack + ";" + t81::tisc::to_string(static_cast<t81::tisc::Opcode>(op)) + " " +
+               std::to_string(cycles) + "\n";
+      }
+    }
+  }
+  return out;
+}
+
+}  // namespace t81::vm
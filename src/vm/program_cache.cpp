@@ -0,0 +1,290 @@
+#include "t81/vm/program_cache.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace t81::vm {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "program images are read in place on little-endian hosts");
+
+constexpr std::size_t kHashOffset = 16;
+constexpr std::size_t kChecksumOffset = 152;
+constexpr std::uint8_t kFlagPreloadTrap = 1;
+constexpr std::uint8_t kFlagPolicy = 2;
+
+using SourceHash = std::array<std::uint8_t, 32>;
+
+// BLAKE2b (RFC 7693), unkeyed, with a 32-byte digest. Sources are keyed by a
+// cryptographic hash so no edit to a program can land on another program's entry.
+SourceHash blake2b_256(std::string_view bytes) {
+  static constexpr std::uint64_t kIv[8] = {
+      0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+      0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+  };
+  static constexpr std::uint8_t kSigma[10][16] = {
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+      {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4}, {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+      {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13}, {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+      {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11}, {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+      {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5}, {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+  };
+  std::uint64_t h[8];
+  std::memcpy(h, kIv, sizeof(h));
+  h[0] ^= 0x01010000ULL ^ sizeof(SourceHash);
+
+  auto compress = [&h](const unsigned char* block, std::uint64_t counter, bool last) {
+    std::uint64_t m[16];
+    std::memcpy(m, block, sizeof(m));
+    std::uint64_t v[16];
+    std::memcpy(v, h, sizeof(h));
+    std::memcpy(v + 8, kIv, sizeof(kIv));
+    v[12] ^= counter;
+    if (last) {
+      v[14] = ~v[14];
+    }
+    auto g = [&v](int a, int b, int c, int d, std::uint64_t x, std::uint64_t y) {
+      v[a] += v[b] + x;
+      v[d] = std::rotr(v[d] ^ v[a], 32);
+      v[c] += v[d];
+      v[b] = std::rotr(v[b] ^ v[c], 24);
+      v[a] += v[b] + y;
+      v[d] = std::rotr(v[d] ^ v[a], 16);
+      v[c] += v[d];
+      v[b] = std::rotr(v[b] ^ v[c], 63);
+    };
+    for (int round = 0; round < 12; ++round) {
+      const auto* s = kSigma[round % 10];
+      g(0, 4, 8, 12, m[s[0]], m[s[1]]);
+      g(1, 5, 9, 13, m[s[2]], m[s[3]]);
+      g(2, 6, 10, 14, m[s[4]], m[s[5]]);
+      g(3, 7, 11, 15, m[s[6]], m[s[7]]);
+      g(0, 5, 10, 15, m[s[8]], m[s[9]]);
+      g(1, 6, 11, 12, m[s[10]], m[s[11]]);
+      g(2, 7, 8, 13, m[s[12]], m[s[13]]);
+      g(3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+    for (int i = 0; i < 8; ++i) {
+      h[i] ^= v[i] ^ v[i + 8];
+    }
+  };
+
+  constexpr std::size_t kBlock = 128;
+  const auto* data = reinterpret_cast<const unsigned char*>(bytes.data());
+  std::size_t done = 0;
+  while (bytes.size() - done > kBlock) {
+    compress(data + done, done + kBlock, false);
+    done += kBlock;
+  }
+  unsigned char tail[kBlock] = {};
+  std::memcpy(tail, data + done, bytes.size() - done);
+  compress(tail, bytes.size(), true);
+
+  SourceHash out;
+  std::memcpy(out.data(), h, out.size());
+  return out;
+}
+
+// What an entry is keyed on: the bytes of the source and the format they are read as.
+struct SourceKey {
+  SourceHash hash{};
+  std::uint64_t size = 0;
+  ProgramFormat format = ProgramFormat::TextV1;
+};
+
+std::uint64_t fnv1a(std::string_view bytes) {
+  std::uint64_t hash = 1469598103934665603ULL;
+  for (const char ch : bytes) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+template <typename T>
+T read_le(std::string_view bytes, std::size_t at) {
+  T value;
+  std::memcpy(&value, bytes.data() + at, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void append_le(std::string& out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+std::array<MemorySegment*, 5> segments(MemoryLayout& layout) {
+  return {&layout.code, &layout.stack, &layout.heap, &layout.tensor, &layout.meta};
+}
+
+std::string_view format_tag(ProgramFormat format) {
+  switch (format) {
+    case ProgramFormat::TextV1:
+      return "text";
+    case ProgramFormat::TiscJsonV1:
+      return "json";
+    case ProgramFormat::TiscBinV1:
+      return "bin";
+  }
+  return "unknown";
+}
+
+std::filesystem::path entry_path(const std::string& dir, const SourceKey& key) {
+  std::string name;
+  for (const auto byte : key.hash) {
+    name += "0123456789abcdef"[byte >> 4];
+    name += "0123456789abcdef"[byte & 0xF];
+  }
+  name += "-" + std::string(format_tag(key.format)) + "-v" + std::to_string(kProgramImageVersion) + ".t81img";
+  return std::filesystem::path(dir) / name;
+}
+
+std::string encode_image(const SourceKey& key, const LoadedProgram& image) {
+  std::string out(kProgramImageMagic, sizeof(kProgramImageMagic));
+  append_le(out, kProgramImageVersion);
+  append_le(out, static_cast<std::uint32_t>(kProgramImageHeaderSize));
+  out.append(reinterpret_cast<const char*>(key.hash.data()), key.hash.size());
+  append_le(out, key.size);
+  const auto& state = image.initial_state;
+  append_le(out, static_cast<std::uint8_t>(key.format));
+  append_le(out, static_cast<std::uint8_t>((image.preload_trap.has_value() ? kFlagPreloadTrap : 0) |
+                                           (state.policy.has_value() ? kFlagPolicy : 0)));
+  append_le(out, static_cast<std::uint16_t>(image.preload_trap.value_or(Trap::None)));
+  append_le(out, static_cast<std::int32_t>(state.policy.has_value() ? state.policy->tier : 0));
+  auto layout = state.layout;
+  for (const auto* segment : segments(layout)) {
+    append_le(out, static_cast<std::uint64_t>(segment->start));
+    append_le(out, static_cast<std::uint64_t>(segment->limit));
+  }
+  append_le(out, std::uint64_t{0});
+  append_le(out, fnv1a(out));
+  return out + encode_tisc_bin_v1(image.program);
+}
+
+// The image in `entry` if it was built from the source `key` describes by this version
+// of the loader.
+std::optional<LoadedProgram> read_image(const std::filesystem::path& entry, const SourceKey& key) {
+  const auto mapped = MappedProgram::open(entry.string(), kProgramImageHeaderSize);
+  if (!mapped.ok) {
+    return std::nullopt;
+  }
+  const auto header = mapped.program->prefix();
+  if (!header.starts_with(std::string_view(kProgramImageMagic, sizeof(kProgramImageMagic))) ||
+      read_le<std::uint32_t>(header, 8) != kProgramImageVersion ||
+      read_le<std::uint32_t>(header, 12) != kProgramImageHeaderSize ||
+      read_le<std::uint64_t>(header, kChecksumOffset) != fnv1a(header.substr(0, kChecksumOffset)) ||
+      header.substr(kHashOffset, key.hash.size()) !=
+          std::string_view(reinterpret_cast<const char*>(key.hash.data()), key.hash.size()) ||
+      read_le<std::uint64_t>(header, 48) != key.size ||
+      read_le<std::uint8_t>(header, 56) != static_cast<std::uint8_t>(key.format)) {
+    return std::nullopt;
+  }
+  MemoryLayout layout;
+  std::size_t at = 64;
+  for (auto* segment : segments(layout)) {
+    segment->start = read_le<std::uint64_t>(header, at);
+    segment->limit = read_le<std::uint64_t>(header, at + 8);
+    at += 16;
+  }
+  if (layout.code.start != 0 || layout.code.limit != mapped.program->insns().size()) {
+    return std::nullopt;
+  }
+  const auto flags = read_le<std::uint8_t>(header, 57);
+  std::optional<Policy> policy;
+  if ((flags & kFlagPolicy) != 0) {
+    policy = Policy{read_le<std::int32_t>(header, 60)};
+  }
+
+  LoadedProgram image;
+  image.program = mapped.program->to_program();
+  image.initial_state = initial_state(layout, policy);
+  if ((flags & kFlagPreloadTrap) != 0) {
+    image.preload_trap = static_cast<Trap>(read_le<std::uint16_t>(header, 58));
+  }
+  return image;
+}
+
+bool write_image(const std::string& dir, const std::filesystem::path& entry, const std::string& bytes) {
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  auto tmp = entry;
+  tmp += ".tmp" + std::to_string(std::random_device{}());
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out.flush()) {
+      std::filesystem::remove(tmp, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(tmp, entry, ec);
+  if (ec) {
+    std::filesystem::remove(tmp, ec);
+    return false;
+  }
+  return true;
+}
+
+ProgramImageResult to_image_result(ProgramLoadResult loaded) {
+  ProgramImageResult out;
+  out.ok = loaded.ok;
+  out.format = loaded.format;
+  out.error = std::move(loaded.error);
+  if (out.ok) {
+    out.image = load_program_image(loaded.program);
+  }
+  return out;
+}
+
+}  // namespace
+
+ProgramImageResult load_program_image_from_file(const std::string& path, const ProgramLoadOptions& options) {
+  return to_image_result(load_program_from_file(path, options));
+}
+
+ProgramCache::ProgramCache(std::string dir) : dir_(std::move(dir)) {}
+
+ProgramImageResult ProgramCache::load(const std::string& path, const ProgramLoadOptions& options) {
+  // One view of the file is both hashed and parsed, so a concurrent rewrite can never
+  // store one program under another's key.
+  ProgramFile file;
+  if (!file.open(path)) {
+    return ProgramImageResult{.ok = false,
+                              .format = ProgramFormat::TextV1,
+                              .error = "unable to open file: " + path,
+                              .image = {},
+                              .cache_hit = false};
+  }
+  const SourceKey key{.hash = blake2b_256(file.bytes()), .size = file.bytes().size(), .format = file.format()};
+  const auto entry = entry_path(dir_, key);
+  std::error_code ec;
+  const bool present = std::filesystem::exists(entry, ec);
+  if (present) {
+    if (auto image = read_image(entry, key)) {
+      ++stats_.hits;
+      return ProgramImageResult{
+          .ok = true, .format = key.format, .error = "", .image = std::move(*image), .cache_hit = true};
+    }
+    ++stats_.invalid;
+  }
+
+  ++stats_.misses;
+  auto out = to_image_result(parse_program_file(file, options));
+  if (out.ok && write_image(dir_, entry, encode_image(key, out.image))) {
+    ++stats_.stores;
+  }
+  return out;
+}
+
+}  // namespace t81::vm
@@ -1,274 +1,527 @@
 #include "t81/vm/program_io.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cctype>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <limits>
 #include <optional>
-#include <regex>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 #include "t81/tisc/opcodes.hpp"
+#include "t81/vm/parallel.hpp"
+
+#if __has_include(<sys/mman.h>)
+#define T81_VM_PROGRAM_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace t81::vm {
 namespace {
 
-std::optional<t81::tisc::Opcode> opcode_from_string(const std::string& raw) {
-  std::string s;
-  s.reserve(raw.size());
-  for (char ch : raw) {
+using t81::tisc::Opcode;
+
+// Opcode mnemonics accepted by both text formats, normalized (upper case, no '_' or
+// '-'), aliases included.
+struct Mnemonic {
+  std::string_view name;
+  Opcode opcode;
+};
+
+constexpr Mnemonic kMnemonics[] = {
+    {"NOP", Opcode::Nop},
+    {"HALT", Opcode::Halt},
+    {"LOADIMM", Opcode::LoadImm},
+    {"LOAD", Opcode::Load},
+    {"STORE", Opcode::Store},
+    {"ADD", Opcode::Add},
+    {"SUB", Opcode::Sub},
+    {"MUL", Opcode::Mul},
+    {"DIV", Opcode::Div},
+    {"MOD", Opcode::Mod},
+    {"JUMP", Opcode::Jump},
+    {"JMP", Opcode::Jump},
+    {"JUMPIFZERO", Opcode::JumpIfZero},
+    {"JZ", Opcode::JumpIfZero},
+    {"JUMPIFNOTZERO", Opcode::JumpIfNotZero},
+    {"JNZ", Opcode::JumpIfNotZero},
+    {"JUMPIFNEGATIVE", Opcode::JumpIfNegative},
+    {"JN", Opcode::JumpIfNegative},
+    {"JUMPIFPOSITIVE", Opcode::JumpIfPositive},
+    {"JP", Opcode::JumpIfPositive},
+    {"MOV", Opcode::Mov},
+    {"INC", Opcode::Inc},
+    {"DEC", Opcode::Dec},
+    {"CMP", Opcode::Cmp},
+    {"PUSH", Opcode::Push},
+    {"POP", Opcode::Pop},
+    {"CALL", Opcode::Call},
+    {"RET", Opcode::Ret},
+    {"TRAP", Opcode::Trap},
+    {"NEG", Opcode::Neg},
+    {"I2F", Opcode::I2F},
+    {"F2I", Opcode::F2I},
+    {"I2FRAC", Opcode::I2Frac},
+    {"FRAC2I", Opcode::Frac2I},
+    {"FADD", Opcode::FAdd},
+    {"FSUB", Opcode::FSub},
+    {"FMUL", Opcode::FMul},
+    {"FDIV", Opcode::FDiv},
+    {"FRACADD", Opcode::FracAdd},
+    {"FRACSUB", Opcode::FracSub},
+    {"FRACMUL", Opcode::FracMul},
+    {"FRACDIV", Opcode::FracDiv},
+    {"LESS", Opcode::Less},
+    {"LT", Opcode::Less},
+    {"LESSEQUAL", Opcode::LessEqual},
+    {"LE", Opcode::LessEqual},
+    {"GREATER", Opcode::Greater},
+    {"GT", Opcode::Greater},
+    {"GREATEREQUAL", Opcode::GreaterEqual},
+    {"GE", Opcode::GreaterEqual},
+    {"EQUAL", Opcode::Equal},
+    {"EQ", Opcode::Equal},
+    {"NOTEQUAL", Opcode::NotEqual},
+    {"NEQ", Opcode::NotEqual},
+    {"STACKALLOC", Opcode::StackAlloc},
+    {"STACKFREE", Opcode::StackFree},
+    {"HEAPALLOC", Opcode::HeapAlloc},
+    {"HEAPFREE", Opcode::HeapFree},
+    {"TNOT", Opcode::TNot},
+    {"TAND", Opcode::TAnd},
+    {"TOR", Opcode::TOr},
+    {"TXOR", Opcode::TXor},
+    {"AXREAD", Opcode::AxRead},
+    {"AXSET", Opcode::AxSet},
+    {"AXVERIFY", Opcode::AxVerify},
+    {"TVECADD", Opcode::TVecAdd},
+    {"TMATMUL", Opcode::TMatMul},
+    {"TTENDOT", Opcode::TTenDot},
+    {"TVECMUL", Opcode::TVecMul},
+    {"TTRANSPOSE", Opcode::TTranspose},
+    {"TEXP", Opcode::TExp},
+    {"TSQRT", Opcode::TSqrt},
+    {"TSILU", Opcode::TSiLU},
+    {"TSOFTMAX", Opcode::TSoftmax},
+    {"TRMSNORM", Opcode::TRMSNorm},
+    {"TROPE", Opcode::TRoPE},
+    {"CHKSHAPE", Opcode::ChkShape},
+    {"WEIGHTSLOAD", Opcode::WeightsLoad},
+    {"SETF", Opcode::SetF},
+    {"MAKEOPTIONSOME", Opcode::MakeOptionSome},
+    {"MAKEOPTIONNONE", Opcode::MakeOptionNone},
+    {"MAKERESULTOK", Opcode::MakeResultOk},
+    {"MAKERESULTERR", Opcode::MakeResultErr},
+    {"OPTIONISSOME", Opcode::OptionIsSome},
+    {"OPTIONUNWRAP", Opcode::OptionUnwrap},
+    {"RESULTISOK", Opcode::ResultIsOk},
+    {"RESULTUNWRAPOK", Opcode::ResultUnwrapOk},
+    {"RESULTUNWRAPERR", Opcode::ResultUnwrapErr},
+    {"MAKEENUMVARIANT", Opcode::MakeEnumVariant},
+    {"MAKEENUMVARIANTPAYLOAD", Opcode::MakeEnumVariantPayload},
+    {"ENUMISVARIANT", Opcode::EnumIsVariant},
+    {"ENUMUNWRAPPAYLOAD", Opcode::EnumUnwrapPayload},
+};
+
+constexpr std::size_t kMaxMnemonicSize = std::ranges::max(kMnemonics, {}, [](const Mnemonic& m) {
+                                           return m.name.size();
+                                         }).name.size();
+
+constexpr int kMnemonicSlotBits = 10;
+
+constexpr std::size_t mnemonic_slot(std::string_view name, std::uint64_t seed) {
+  std::uint64_t hash = 1469598103934665603ULL ^ seed;
+  for (const char ch : name) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<std::size_t>((hash * 0x9E3779B97F4A7C15ULL) >> (64 - kMnemonicSlotBits));
+}
+
+// Perfect hash over kMnemonics: the first seed under which every mnemonic lands in its
+// own slot, found at compile time. A slot holds its mnemonic's index + 1, or 0.
+struct MnemonicTable {
+  std::uint64_t seed = 0;
+  std::array<std::uint8_t, std::size_t{1} << kMnemonicSlotBits> slots{};
+};
+
+consteval MnemonicTable build_mnemonic_table() {
+  static_assert(std::size(kMnemonics) < 255);
+  for (std::uint64_t seed = 0; seed < 100000; ++seed) {
+    MnemonicTable table{.seed = seed};
+    bool collision = false;
+    for (std::size_t i = 0; i < std::size(kMnemonics) && !collision; ++i) {
+      auto& slot = table.slots[mnemonic_slot(kMnemonics[i].name, seed)];
+      collision = slot != 0;
+      slot = static_cast<std::uint8_t>(i + 1);
+    }
+    if (!collision) {
+      return table;
+    }
+  }
+  throw "no collision-free seed for kMnemonics";
+}
+
+constexpr MnemonicTable kMnemonicTable = build_mnemonic_table();
+
+std::optional<Opcode> opcode_from_string(std::string_view raw) {
+  char normalized[kMaxMnemonicSize];
+  std::size_t size = 0;
+  for (const char ch : raw) {
     if (ch == '_' || ch == '-') {
       continue;
     }
-    s.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(ch))));
-  }
-
-  using t81::tisc::Opcode;
-  if (s == "NOP") return Opcode::Nop;
-  if (s == "HALT") return Opcode::Halt;
-  if (s == "LOADIMM") return Opcode::LoadImm;
-  if (s == "LOAD") return Opcode::Load;
-  if (s == "STORE") return Opcode::Store;
-  if (s == "ADD") return Opcode::Add;
-  if (s == "SUB") return Opcode::Sub;
-  if (s == "MUL") return Opcode::Mul;
-  if (s == "DIV") return Opcode::Div;
-  if (s == "MOD") return Opcode::Mod;
-  if (s == "JUMP" || s == "JMP") return Opcode::Jump;
-  if (s == "JUMPIFZERO" || s == "JZ") return Opcode::JumpIfZero;
-  if (s == "JUMPIFNOTZERO" || s == "JNZ") return Opcode::JumpIfNotZero;
-  if (s == "JUMPIFNEGATIVE" || s == "JN") return Opcode::JumpIfNegative;
-  if (s == "JUMPIFPOSITIVE" || s == "JP") return Opcode::JumpIfPositive;
-  if (s == "MOV") return Opcode::Mov;
-  if (s == "INC") return Opcode::Inc;
-  if (s == "DEC") return Opcode::Dec;
-  if (s == "CMP") return Opcode::Cmp;
-  if (s == "PUSH") return Opcode::Push;
-  if (s == "POP") return Opcode::Pop;
-  if (s == "CALL") return Opcode::Call;
-  if (s == "RET") return Opcode::Ret;
-  if (s == "TRAP") return Opcode::Trap;
-  if (s == "NEG") return Opcode::Neg;
-  if (s == "I2F") return Opcode::I2F;
-  if (s == "F2I") return Opcode::F2I;
-  if (s == "I2FRAC") return Opcode::I2Frac;
-  if (s == "FRAC2I") return Opcode::Frac2I;
-  if (s == "FADD") return Opcode::FAdd;
-  if (s == "FSUB") return Opcode::FSub;
-  if (s == "FMUL") return Opcode::FMul;
-  if (s == "FDIV") return Opcode::FDiv;
-  if (s == "FRACADD") return Opcode::FracAdd;
-  if (s == "FRACSUB") return Opcode::FracSub;
-  if (s == "FRACMUL") return Opcode::FracMul;
-  if (s == "FRACDIV") return Opcode::FracDiv;
-  if (s == "LESS" || s == "LT") return Opcode::Less;
-  if (s == "LESSEQUAL" || s == "LE") return Opcode::LessEqual;
-  if (s == "GREATER" || s == "GT") return Opcode::Greater;
-  if (s == "GREATEREQUAL" || s == "GE") return Opcode::GreaterEqual;
-  if (s == "EQUAL" || s == "EQ") return Opcode::Equal;
-  if (s == "NOTEQUAL" || s == "NEQ") return Opcode::NotEqual;
-  if (s == "STACKALLOC") return Opcode::StackAlloc;
-  if (s == "STACKFREE") return Opcode::StackFree;
-  if (s == "HEAPALLOC") return Opcode::HeapAlloc;
-  if (s == "HEAPFREE") return Opcode::HeapFree;
-  if (s == "TNOT") return Opcode::TNot;
-  if (s == "TAND") return Opcode::TAnd;
-  if (s == "TOR") return Opcode::TOr;
-  if (s == "TXOR") return Opcode::TXor;
-  if (s == "AXREAD") return Opcode::AxRead;
-  if (s == "AXSET") return Opcode::AxSet;
-  if (s == "AXVERIFY") return Opcode::AxVerify;
-  if (s == "TVECADD") return Opcode::TVecAdd;
-  if (s == "TMATMUL") return Opcode::TMatMul;
-  if (s == "TTENDOT") return Opcode::TTenDot;
-  if (s == "TVECMUL") return Opcode::TVecMul;
-  if (s == "TTRANSPOSE") return Opcode::TTranspose;
-  if (s == "TEXP") return Opcode::TExp;
-  if (s == "TSQRT") return Opcode::TSqrt;
-  if (s == "TSILU") return Opcode::TSiLU;
-  if (s == "TSOFTMAX") return Opcode::TSoftmax;
-  if (s == "TRMSNORM") return Opcode::TRMSNorm;
-  if (s == "TROPE") return Opcode::TRoPE;
-  if (s == "CHKSHAPE") return Opcode::ChkShape;
-  if (s == "WEIGHTSLOAD") return Opcode::WeightsLoad;
-  if (s == "SETF") return Opcode::SetF;
-  if (s == "MAKEOPTIONSOME") return Opcode::MakeOptionSome;
-  if (s == "MAKEOPTIONNONE") return Opcode::MakeOptionNone;
-  if (s == "MAKERESULTOK") return Opcode::MakeResultOk;
-  if (s == "MAKERESULTERR") return Opcode::MakeResultErr;
-  if (s == "OPTIONISSOME") return Opcode::OptionIsSome;
-  if (s == "OPTIONUNWRAP") return Opcode::OptionUnwrap;
-  if (s == "RESULTISOK") return Opcode::ResultIsOk;
-  if (s == "RESULTUNWRAPOK") return Opcode::ResultUnwrapOk;
-  if (s == "RESULTUNWRAPERR") return Opcode::ResultUnwrapErr;
-  if (s == "MAKEENUMVARIANT") return Opcode::MakeEnumVariant;
-  if (s == "MAKEENUMVARIANTPAYLOAD") return Opcode::MakeEnumVariantPayload;
-  if (s == "ENUMISVARIANT") return Opcode::EnumIsVariant;
-  if (s == "ENUMUNWRAPPAYLOAD") return Opcode::EnumUnwrapPayload;
-  return std::nullopt;
+    if (size == kMaxMnemonicSize) {
+      return std::nullopt;
+    }
+    normalized[size++] = ch >= 'a' && ch <= 'z' ? static_cast<char>(ch - 'a' + 'A') : ch;
+  }
+  const std::string_view name(normalized, size);
+  const std::uint8_t slot = kMnemonicTable.slots[mnemonic_slot(name, kMnemonicTable.seed)];
+  if (slot == 0 || kMnemonics[slot - 1].name != name) {
+    return std::nullopt;
+  }
+  return kMnemonics[slot - 1].opcode;
 }
 
-std::string trim(const std::string& in) {
-  std::size_t b = 0;
-  std::size_t e = in.size();
-  while (b < e && std::isspace(static_cast<unsigned char>(in[b]))) {
-    ++b;
+std::size_t skip_space(std::string_view s, std::size_t i) {
+  while (i < s.size() && std::isspace(static_cast<unsigned char>(s[i]))) {
+    ++i;
   }
+  return i;
+}
+
+std::string_view trim(std::string_view in) {
+  std::size_t b = skip_space(in, 0);
+  std::size_t e = in.size();
   while (e > b && std::isspace(static_cast<unsigned char>(in[e - 1]))) {
     --e;
   }
   return in.substr(b, e - b);
 }
 
-ProgramLoadResult load_text_v1(std::istream& in) {
-  ProgramLoadResult out;
-  out.format = ProgramFormat::TextV1;
+// Reads operands as chained `istream >> std::int64_t` does: each skips whitespace, takes
+// an optional sign and decimal digits, and stops at the next other character. A read
+// with no digits fails, and overflow saturates and fails; after a failure the remaining
+// operands stay 0.
+void read_operands(std::string_view s, std::span<std::int64_t> out) {
+  std::size_t i = 0;
+  for (auto& operand : out) {
+    i = skip_space(s, i);
+    const bool negative = i < s.size() && s[i] == '-';
+    const std::size_t digits = i < s.size() && (negative || s[i] == '+') ? i + 1 : i;
+    if (digits >= s.size() || !std::isdigit(static_cast<unsigned char>(s[digits]))) {
+      return;
+    }
+    const char* first = s.data() + (negative ? i : digits);
+    const auto [ptr, ec] = std::from_chars(first, s.data() + s.size(), operand);
+    if (ec == std::errc::result_out_of_range) {
+      operand = negative ? std::numeric_limits<std::int64_t>::min() : std::numeric_limits<std::int64_t>::max();
+      return;
+    }
+    i = static_cast<std::size_t>(ptr - s.data());
+  }
+}
+
+// Instructions of one line-aligned chunk of a Text V1 file, up to its first error.
+struct TextChunk {
+  std::vector<t81::tisc::Insn> insns;
+  std::optional<std::string_view> policy;  // last POLICY line before any error
+  std::string error;
+};
 
-  std::string line;
-  while (std::getline(in, line)) {
-    const std::string t = trim(line);
+void parse_text_chunk(std::string_view text, TextChunk* out) {
+  out->insns.reserve(static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+
+  for (std::size_t pos = 0; pos < text.size();) {
+    std::size_t end = text.find('\n', pos);
+    if (end == std::string_view::npos) {
+      end = text.size();
+    }
+    const std::string_view t = trim(text.substr(pos, end - pos));
+    pos = end + 1;
     if (t.empty() || t[0] == '#') {
       continue;
     }
 
-    std::istringstream iss(t);
-    std::string op;
-    iss >> op;
+    std::size_t op_end = 0;
+    while (op_end < t.size() && !std::isspace(static_cast<unsigned char>(t[op_end]))) {
+      ++op_end;
+    }
+    const std::string_view op = t.substr(0, op_end);
     if (op == "POLICY") {
-      std::string rest;
-      std::getline(iss, rest);
-      out.program.axion_policy_text = trim(rest);
+      out->policy = trim(t.substr(op_end));
       continue;
     }
 
-    std::int64_t a = 0;
-    std::int64_t b = 0;
-    std::int64_t c = 0;
-    iss >> a >> b >> c;
+    std::int64_t operands[3] = {0, 0, 0};
+    read_operands(t.substr(op_end), operands);
 
     const auto opcode = opcode_from_string(op);
     if (!opcode.has_value()) {
-      out.error = "unknown opcode in text program: " + op;
+      out->error = "unknown opcode in text program: " + std::string(op);
+      return;
+    }
+    out->insns.push_back({*opcode, operands[0], operands[1], operands[2]});
+  }
+}
+
+// Appends `insns` (moved when `program` is still empty).
+void append_insns(t81::tisc::Program& program, std::vector<t81::tisc::Insn>& insns) {
+  if (program.insns.empty()) {
+    program.insns = std::move(insns);
+  } else {
+    program.insns.insert(program.insns.end(), insns.begin(), insns.end());
+  }
+}
+
+ProgramLoadResult load_text_v1(std::string_view text, const ProgramLoadOptions& options) {
+  ProgramLoadResult out;
+  out.format = ProgramFormat::TextV1;
+
+  // Chunk i starts after the first newline at or past its even share of the bytes, so
+  // no line spans two chunks.
+  const std::size_t chunks = parallel_width(text.size(), options.min_chunk_bytes, options.threads);
+  std::vector<std::size_t> starts(chunks + 1, text.size());
+  starts[0] = 0;
+  for (std::size_t i = 1; i < chunks; ++i) {
+    const std::size_t newline = text.find('\n', chunk_range(text.size(), chunks, i).first);
+    starts[i] = newline == std::string_view::npos ? text.size() : newline + 1;
+  }
+  std::vector<TextChunk> parsed(chunks);
+  parallel_invoke(chunks, [&](std::size_t i) {
+    parse_text_chunk(text.substr(starts[i], starts[i + 1] - starts[i]), &parsed[i]);
+  });
+
+  // Stitched in file order, stopping at the first error as one sequential pass would.
+  if (chunks > 1) {
+    std::size_t total = 0;
+    for (const auto& chunk : parsed) {
+      total += chunk.insns.size();
+    }
+    out.program.insns.reserve(total);
+  }
+  for (auto& chunk : parsed) {
+    if (chunk.policy.has_value()) {
+      out.program.axion_policy_text = std::string(*chunk.policy);
+    }
+    append_insns(out.program, chunk.insns);
+    if (!chunk.error.empty()) {
+      out.error = std::move(chunk.error);
       return out;
     }
-    out.program.insns.push_back({*opcode, a, b, c});
   }
 
   out.ok = true;
   return out;
 }
 
-std::string read_all(std::istream& in) {
-  std::ostringstream ss;
-  ss << in.rdbuf();
-  return ss.str();
+// TISC JSON V1 is matched field by field rather than parsed as a JSON document: a field
+// is the leftmost `"key"\s*:\s*` followed by a `"[^"]*"` string or `-?[0-9]+` integer
+// within its enclosing span, and other text is skipped. The scanners below walk the
+// file buffer once and return views into it.
+
+// Position of the value after `"key"\s*:\s*` when `s[at]` opens that key, else npos.
+std::size_t match_key(std::string_view s, std::size_t at, std::string_view key) {
+  const std::size_t close = at + 1 + key.size();
+  if (close >= s.size() || s[close] != '"' || s.compare(at + 1, key.size(), key) != 0) {
+    return std::string_view::npos;
+  }
+  const std::size_t colon = skip_space(s, close + 1);
+  if (colon >= s.size() || s[colon] != ':') {
+    return std::string_view::npos;
+  }
+  return skip_space(s, colon + 1);
 }
 
-bool parse_int_field(const std::string& obj, const std::string& key, std::int64_t* out) {
-  const std::regex re("\\\"" + key + "\\\"\\s*:\\s*(-?[0-9]+)");
-  std::smatch m;
-  if (!std::regex_search(obj, m, re) || m.size() < 2) {
+std::optional<std::string_view> match_string(std::string_view s, std::size_t i) {
+  if (i >= s.size() || s[i] != '"') {
+    return std::nullopt;
+  }
+  const std::size_t close = s.find('"', i + 1);
+  if (close == std::string_view::npos) {
+    return std::nullopt;
+  }
+  return s.substr(i + 1, close - i - 1);
+}
+
+struct IntField {
+  bool found = false;
+  bool valid = false;  // false when the digits overflow int64
+  std::int64_t value = 0;
+};
+
+bool match_int(std::string_view s, std::size_t i, IntField* out) {
+  const std::size_t digits = i < s.size() && s[i] == '-' ? i + 1 : i;
+  if (digits >= s.size() || !std::isdigit(static_cast<unsigned char>(s[digits]))) {
     return false;
   }
-  *out = std::stoll(m[1].str());
+  const auto [ptr, ec] = std::from_chars(s.data() + i, s.data() + s.size(), out->value);
+  (void)ptr;
+  out->found = true;
+  out->valid = ec == std::errc{};
   return true;
 }
 
-std::optional<std::string> parse_string_field(const std::string& obj, const std::string& key) {
-  const std::regex re("\\\"" + key + "\\\"\\s*:\\s*\\\"([^\\\"]*)\\\"");
-  std::smatch m;
-  if (!std::regex_search(obj, m, re) || m.size() < 2) {
-    return std::nullopt;
+std::optional<std::string_view> find_string_field(std::string_view s, std::string_view key) {
+  const std::string quoted = "\"" + std::string(key) + "\"";
+  for (std::size_t at = s.find(quoted); at != std::string_view::npos; at = s.find(quoted, at + 1)) {
+    const std::size_t value = match_key(s, at, key);
+    if (value != std::string_view::npos) {
+      if (auto str = match_string(s, value)) {
+        return str;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+// Decodes one insn object, or sets `error`. One sweep over the object's quotes keeps
+// the leftmost match of each field.
+bool parse_insn_object(std::string_view obj, t81::tisc::Insn* insn, std::string* error) {
+  std::optional<std::string_view> opname;
+  IntField fields[3];
+  for (std::size_t q = obj.find('"'); q != std::string_view::npos; q = obj.find('"', q + 1)) {
+    if (!opname.has_value()) {
+      const std::size_t value = match_key(obj, q, "opcode");
+      if (value != std::string_view::npos) {
+        opname = match_string(obj, value);
+        if (opname.has_value()) {
+          continue;
+        }
+      }
+    }
+    const char name = q + 2 < obj.size() && obj[q + 2] == '"' ? obj[q + 1] : '\0';
+    if (name >= 'a' && name <= 'c' && !fields[name - 'a'].found) {
+      (void)match_int(obj, match_key(obj, q, std::string_view(&name, 1)), &fields[name - 'a']);
+    }
+  }
+
+  if (!opname.has_value()) {
+    *error = "missing opcode in insn object";
+    return false;
+  }
+  const auto opcode = opcode_from_string(*opname);
+  if (!opcode.has_value()) {
+    *error = "unknown opcode in json program: " + std::string(*opname);
+    return false;
+  }
+  if (!fields[0].valid || !fields[1].valid || !fields[2].valid) {
+    *error = "insn object requires integer fields a,b,c";
+    return false;
+  }
+  *insn = {*opcode, fields[0].value, fields[1].value, fields[2].value};
+  return true;
+}
+
+// Bounds of the insns array opened at `s[lb]` and of the insn objects inside it. Both
+// nestings are counted without regard to strings; a '}' outside any object is skipped.
+struct InsnSpans {
+  std::size_t rb = std::string_view::npos;  // npos: the array is unterminated
+  std::vector<std::pair<std::size_t, std::size_t>> objects;
+  bool unterminated_object = false;  // an object is still open at the array's end
+};
+
+InsnSpans scan_insn_spans(std::string_view s, std::size_t lb) {
+  InsnSpans out;
+  int brackets = 0;
+  int braces = 0;
+  std::size_t ob = 0;
+  for (std::size_t i = lb; i < s.size(); ++i) {
+    const char ch = s[i];
+    if (ch == '[') {
+      ++brackets;
+    } else if (ch == ']') {
+      if (--brackets == 0) {
+        out.rb = i;
+        break;
+      }
+    } else if (ch == '{') {
+      if (braces++ == 0) {
+        ob = i;
+      }
+    } else if (ch == '}' && braces > 0 && --braces == 0) {
+      out.objects.emplace_back(ob, i + 1);
+    }
   }
-  return m[1].str();
+  out.unterminated_object = braces > 0;
+  return out;
 }
 
-ProgramLoadResult load_tisc_json_v1(std::istream& in) {
+// Instructions of one run of insn objects, up to its first error.
+struct JsonChunk {
+  std::vector<t81::tisc::Insn> insns;
+  std::string error;
+};
+
+ProgramLoadResult load_tisc_json_v1(std::string_view s, const ProgramLoadOptions& options) {
   ProgramLoadResult out;
   out.format = ProgramFormat::TiscJsonV1;
 
-  const std::string s = read_all(in);
-  const auto policy = parse_string_field(s, "axion_policy_text");
-  if (policy.has_value()) {
-    out.program.axion_policy_text = *policy;
+  if (const auto policy = find_string_field(s, "axion_policy_text")) {
+    out.program.axion_policy_text = std::string(*policy);
   }
 
   const auto insns_pos = s.find("\"insns\"");
-  if (insns_pos == std::string::npos) {
+  if (insns_pos == std::string_view::npos) {
     out.error = "missing insns array";
     return out;
   }
   const auto lb = s.find('[', insns_pos);
-  if (lb == std::string::npos) {
+  if (lb == std::string_view::npos) {
     out.error = "invalid insns array";
     return out;
   }
-
-  int depth = 0;
-  std::size_t rb = std::string::npos;
-  for (std::size_t i = lb; i < s.size(); ++i) {
-    if (s[i] == '[') {
-      ++depth;
-    } else if (s[i] == ']') {
-      --depth;
-      if (depth == 0) {
-        rb = i;
-        break;
-      }
-    }
-  }
-  if (rb == std::string::npos) {
+  const InsnSpans spans = scan_insn_spans(s, lb);
+  if (spans.rb == std::string_view::npos) {
     out.error = "unterminated insns array";
     return out;
   }
 
-  const std::string body = s.substr(lb + 1, rb - lb - 1);
-  std::size_t pos = 0;
-  while (true) {
-    const auto ob = body.find('{', pos);
-    if (ob == std::string::npos) {
-      break;
-    }
-    int obj_depth = 0;
-    std::size_t cb = std::string::npos;
-    for (std::size_t i = ob; i < body.size(); ++i) {
-      if (body[i] == '{') {
-        ++obj_depth;
-      } else if (body[i] == '}') {
-        --obj_depth;
-        if (obj_depth == 0) {
-          cb = i;
-          break;
-        }
+  // Objects are decoded in parallel runs and stitched in order; the first error wins.
+  const auto& objects = spans.objects;
+  const std::size_t chunks = std::min(parallel_width(spans.rb - lb, options.min_chunk_bytes, options.threads),
+                                      std::max<std::size_t>(1, objects.size()));
+  std::vector<JsonChunk> parsed(chunks);
+  parallel_invoke(chunks, [&](std::size_t i) {
+    const auto [begin, end] = chunk_range(objects.size(), chunks, i);
+    auto& chunk = parsed[i];
+    chunk.insns.resize(end - begin);
+    for (std::size_t k = begin; k < end; ++k) {
+      const auto [ob, ce] = objects[k];
+      if (!parse_insn_object(s.substr(ob, ce - ob), &chunk.insns[k - begin], &chunk.error)) {
+        chunk.insns.resize(k - begin);
+        return;
       }
     }
-    if (cb == std::string::npos) {
-      out.error = "unterminated insn object";
-      return out;
-    }
-
-    const std::string obj = body.substr(ob, cb - ob + 1);
-    const auto opname = parse_string_field(obj, "opcode");
-    if (!opname.has_value()) {
-      out.error = "missing opcode in insn object";
-      return out;
-    }
-    const auto opcode = opcode_from_string(*opname);
-    if (!opcode.has_value()) {
-      out.error = "unknown opcode in json program: " + *opname;
-      return out;
-    }
-
-    std::int64_t a = 0;
-    std::int64_t b = 0;
-    std::int64_t c = 0;
-    if (!parse_int_field(obj, "a", &a) || !parse_int_field(obj, "b", &b) || !parse_int_field(obj, "c", &c)) {
-      out.error = "insn object requires integer fields a,b,c";
+  });
+  if (chunks > 1) {
+    out.program.insns.reserve(objects.size());
+  }
+  for (auto& chunk : parsed) {
+    append_insns(out.program, chunk.insns);
+    if (!chunk.error.empty()) {
+      out.error = std::move(chunk.error);
       return out;
     }
-
-    out.program.insns.push_back({*opcode, a, b, c});
-    pos = cb + 1;
+  }
+  if (spans.unterminated_object) {
+    out.error = "unterminated insn object";
+    return out;
   }
 
   if (out.program.insns.empty()) {
@@ -280,22 +533,274 @@ ProgramLoadResult load_tisc_json_v1(std::istream& in) {
   return out;
 }
 
-bool looks_like_json_path(const std::string& path) {
-  return path.size() >= 5 && path.substr(path.size() - 5) == ".json";
+// tisc-bin-v1 instruction table entries are read in place as Insn.
+static_assert(std::endian::native == std::endian::little, "tisc-bin-v1 is read in place on little-endian hosts");
+static_assert(sizeof(t81::tisc::Insn) == kTiscBinInsnSize);
+static_assert(offsetof(t81::tisc::Insn, a) == 8 && offsetof(t81::tisc::Insn, b) == 16 &&
+              offsetof(t81::tisc::Insn, c) == 24);
+
+constexpr std::size_t kSpecVersionOffset = 16;
+constexpr std::size_t kSpecVersionSize = 16;
+
+std::uint64_t fnv1a(const unsigned char* data, std::size_t size) {
+  std::uint64_t hash = 1469598103934665603ULL;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+template <typename T>
+T read_le(const unsigned char* at) {
+  T value;
+  std::memcpy(&value, at, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void append_le(std::string& out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.append(bytes, sizeof(T));
+}
+
+bool valid_opcode_byte(unsigned char byte) {
+  static const auto valid = [] {
+    std::array<bool, 256> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+      table[i] = std::string_view(t81::tisc::to_string(static_cast<t81::tisc::Opcode>(i))) != "Unknown";
+    }
+    return table;
+  }();
+  return valid[byte];
+}
+
+// A checked `tisc-bin-v1` container; the table and policy point into the checked bytes.
+struct TiscBinView {
+  const unsigned char* table = nullptr;
+  std::size_t count = 0;
+  std::string_view policy;
+  std::string_view spec_version;
+};
+
+// Checks the header, checksum and opcode bytes of the container in `bytes`; returns
+// the error (without the file name), or an empty string.
+std::string check_tisc_bin(const unsigned char* bytes, std::size_t size, TiscBinView* out) {
+  if (size < kTiscBinHeaderSize) {
+    return "truncated tisc-bin-v1 header";
+  }
+  if (std::memcmp(bytes, kTiscBinMagic, sizeof(kTiscBinMagic)) != 0) {
+    return "not a tisc-bin-v1 container";
+  }
+  const auto version = read_le<std::uint32_t>(bytes + 8);
+  if (version != kTiscBinVersion || read_le<std::uint32_t>(bytes + 12) != kTiscBinHeaderSize) {
+    return "unsupported tisc-bin container version " + std::to_string(version);
+  }
+  const auto* spec = reinterpret_cast<const char*>(bytes + kSpecVersionOffset);
+  out->spec_version = std::string_view(spec, ::strnlen(spec, kSpecVersionSize));
+  if (out->spec_version != kTiscSpecVersion) {
+    return "unsupported spec_version in binary program: " + std::string(out->spec_version);
+  }
+  const auto count = read_le<std::uint64_t>(bytes + 32);
+  const auto policy_size = read_le<std::uint64_t>(bytes + 40);
+  const std::size_t room = size - kTiscBinHeaderSize;
+  if (count > room / kTiscBinInsnSize || policy_size != room - count * kTiscBinInsnSize) {
+    return "tisc-bin-v1 size mismatch";
+  }
+  if (fnv1a(bytes + kTiscBinHeaderSize, room) != read_le<std::uint64_t>(bytes + 48)) {
+    return "tisc-bin-v1 checksum mismatch";
+  }
+  const auto* table = bytes + kTiscBinHeaderSize;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!valid_opcode_byte(table[i * kTiscBinInsnSize])) {
+      return "unknown opcode byte " + std::to_string(table[i * kTiscBinInsnSize]) + " at insn " + std::to_string(i);
+    }
+  }
+  out->table = table;
+  out->count = count;
+  out->policy = std::string_view(reinterpret_cast<const char*>(table + count * kTiscBinInsnSize), policy_size);
+  return "";
+}
+
+// By magic number (`tisc-bin-v1`), then by extension (`.json`: TISC JSON V1).
+ProgramFormat detect_format(const std::string& path, std::string_view text) {
+  if (text.starts_with(std::string_view(kTiscBinMagic, sizeof(kTiscBinMagic)))) {
+    return ProgramFormat::TiscBinV1;
+  }
+  if (path.size() >= 5 && path.substr(path.size() - 5) == ".json") {
+    return ProgramFormat::TiscJsonV1;
+  }
+  return ProgramFormat::TextV1;
 }
 
 }  // namespace
 
-ProgramLoadResult load_program_from_file(const std::string& path) {
-  std::ifstream in(path);
+ProgramFile::~ProgramFile() {
+#ifdef T81_VM_PROGRAM_MMAP
+  if (map_ != nullptr) {
+    ::munmap(map_, size_);
+  }
+#endif
+}
+
+bool ProgramFile::open(const std::string& path) {
+  path_ = path;
+#ifdef T81_VM_PROGRAM_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED) {
+      ::close(fd);
+      map_ = map;
+      size_ = size;
+      return true;
+    }
+  }
+  char chunk[1 << 16];
+  ssize_t n = 0;
+  while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+    buffer_.append(chunk, static_cast<std::size_t>(n));
+  }
+  ::close(fd);
+  return n == 0;
+#else
+  std::ifstream in(path, std::ios::binary);
   if (!in) {
+    return false;
+  }
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  buffer_ = ss.str();
+  return true;
+#endif
+}
+
+ProgramFormat ProgramFile::format() const {
+  return detect_format(path_, bytes());
+}
+
+ProgramLoadResult parse_program_file(const ProgramFile& file, const ProgramLoadOptions& options) {
+  switch (file.format()) {
+    case ProgramFormat::TiscBinV1: {
+      ProgramLoadResult out;
+      out.format = ProgramFormat::TiscBinV1;
+      // Copied out rather than viewed: a file read into memory need not be aligned for Insn.
+      TiscBinView view;
+      const auto bytes = file.bytes();
+      auto error = check_tisc_bin(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size(), &view);
+      if (!error.empty()) {
+        out.error = std::move(error) + ": " + file.path();
+        return out;
+      }
+      out.program.insns.resize(view.count);
+      std::memcpy(out.program.insns.data(), view.table, view.count * kTiscBinInsnSize);
+      out.program.axion_policy_text = std::string(view.policy);
+      out.ok = true;
+      return out;
+    }
+    case ProgramFormat::TiscJsonV1:
+      return load_tisc_json_v1(file.bytes(), options);
+    case ProgramFormat::TextV1:
+      break;
+  }
+  return load_text_v1(file.bytes(), options);
+}
+
+ProgramLoadResult load_program_from_file(const std::string& path, const ProgramLoadOptions& options) {
+  ProgramFile file;
+  if (!file.open(path)) {
     return ProgramLoadResult{.ok = false, .format = ProgramFormat::TextV1, .error = "unable to open file: " + path};
   }
+  return parse_program_file(file, options);
+}
+
+std::string encode_tisc_bin_v1(const t81::tisc::Program& program) {
+  std::string body;
+  body.reserve(program.insns.size() * kTiscBinInsnSize + program.axion_policy_text.size());
+  for (const auto& insn : program.insns) {
+    body.push_back(static_cast<char>(insn.opcode));
+    body.append(7, '\0');
+    append_le(body, insn.a);
+    append_le(body, insn.b);
+    append_le(body, insn.c);
+  }
+  body += program.axion_policy_text;
+
+  std::string out(kTiscBinMagic, sizeof(kTiscBinMagic));
+  append_le(out, kTiscBinVersion);
+  append_le(out, static_cast<std::uint32_t>(kTiscBinHeaderSize));
+  std::string spec(kTiscSpecVersion);
+  spec.resize(kSpecVersionSize, '\0');
+  out += spec;
+  append_le(out, static_cast<std::uint64_t>(program.insns.size()));
+  append_le(out, static_cast<std::uint64_t>(program.axion_policy_text.size()));
+  append_le(out, fnv1a(reinterpret_cast<const unsigned char*>(body.data()), body.size()));
+  append_le(out, std::uint64_t{0});
+  return out + body;
+}
+
+MappedProgramResult MappedProgram::open(const std::string& path, std::size_t offset) {
+#ifdef T81_VM_PROGRAM_MMAP
+  if (offset % alignof(t81::tisc::Insn) != 0) {
+    return MappedProgramResult{.ok = false, .program = nullptr, .error = "misaligned tisc-bin-v1 offset: " + path};
+  }
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return MappedProgramResult{.ok = false, .program = nullptr, .error = "unable to open file: " + path};
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < offset + kTiscBinHeaderSize) {
+    ::close(fd);
+    return MappedProgramResult{.ok = false, .program = nullptr, .error = "truncated tisc-bin-v1 header: " + path};
+  }
+  const auto file_size = static_cast<std::size_t>(st.st_size);
+  void* base = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return MappedProgramResult{.ok = false, .program = nullptr, .error = "unable to map file: " + path};
+  }
+  std::shared_ptr<MappedProgram> mapped(new MappedProgram());
+  mapped->base_ = base;
+  mapped->size_ = file_size;
+  mapped->prefix_ = std::string_view(static_cast<const char*>(base), offset);
 
-  if (looks_like_json_path(path)) {
-    return load_tisc_json_v1(in);
+  TiscBinView view;
+  auto error = check_tisc_bin(static_cast<const unsigned char*>(base) + offset, file_size - offset, &view);
+  if (!error.empty()) {
+    return MappedProgramResult{.ok = false, .program = nullptr, .error = std::move(error) + ": " + path};
   }
-  return load_text_v1(in);
+  // The mapping is page-aligned and the table starts a multiple of 8 bytes in, so
+  // entries are suitably aligned Insn objects.
+  mapped->insns_ = std::span<const t81::tisc::Insn>(reinterpret_cast<const t81::tisc::Insn*>(view.table), view.count);
+  mapped->policy_ = view.policy;
+  mapped->spec_version_ = view.spec_version;
+  return MappedProgramResult{.ok = true, .program = std::move(mapped), .error = ""};
+#else
+  (void)offset;
+  return MappedProgramResult{
+      .ok = false, .program = nullptr, .error = "tisc-bin-v1 needs mmap(), unavailable here: " + path};
+#endif
+}
+
+MappedProgram::~MappedProgram() {
+#ifdef T81_VM_PROGRAM_MMAP
+  if (base_ != nullptr) {
+    ::munmap(base_, size_);
+  }
+#endif
+}
+
+t81::tisc::Program MappedProgram::to_program() const {
+  t81::tisc::Program program;
+  program.insns.assign(insns_.begin(), insns_.end());
+  program.axion_policy_text = std::string(policy_);
+  return program;
 }
 
 }  // namespace t81::vm
@@ -1,5 +1,6 @@
 #include "t81/vm/summary.hpp"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -18,6 +19,33 @@ void mix_u64(std::uint64_t v, std::uint64_t* h) {
   }
 }
 
+// Refreshes stale per-page digests (FNV-1a over the page's words) and folds them, in
+// page order, into a single memory digest for STATE_HASH_V2.
+std::uint64_t memory_digest(const State& state) {
+  const auto& pages = state.memory_pages;
+  const std::size_t page_count = (state.memory.size() + MemoryPages::kPageWords - 1) / MemoryPages::kPageWords;
+  if (pages.digests.size() != page_count || pages.dirty.size() != page_count) {
+    pages.digests.assign(page_count, 0);
+    pages.dirty.assign(page_count, 1);
+  }
+  std::uint64_t h = kFnvOffsetBasis;
+  for (std::size_t page = 0; page < page_count; ++page) {
+    if (pages.dirty[page] != 0) {
+      const std::size_t begin = page * MemoryPages::kPageWords;
+      const std::size_t end = std::min(begin + MemoryPages::kPageWords, state.memory.size());
+      std::uint64_t d = kFnvOffsetBasis;
+      for (std::size_t i = begin; i < end; ++i) {
+        d ^= static_cast<std::uint64_t>(state.memory[i]);
+        d *= kFnvPrime;
+      }
+      pages.digests[page] = d;
+      pages.dirty[page] = 0;
+    }
+    mix_u64(pages.digests[page], &h);
+  }
+  return h;
+}
+
 std::string escape_payload_detail(const std::string& in) {
   std::string out;
   out.reserve(in.size());
@@ -39,6 +67,10 @@ std::string escape_payload_detail(const std::string& in) {
 }  // namespace
 
 std::uint64_t state_hash(const State& state) {
+  return state_hash(state, StateHashVersion::V1);
+}
+
+std::uint64_t state_hash(const State& state, StateHashVersion version) {
   std::uint64_t h = kFnvOffsetBasis;
   mix_u64(state.pc, &h);
   mix_u64(state.halted ? 1 : 0, &h);
@@ -47,18 +79,24 @@ std::uint64_t state_hash(const State& state) {
   for (const auto reg : state.registers) {
     mix_u64(static_cast<std::uint64_t>(reg), &h);
   }
-  for (const auto mem : state.memory) {
-    mix_u64(static_cast<std::uint64_t>(mem), &h);
-  }
-
-  mix_u64(state.trace.size(), &h);
-  for (const auto& entry : state.trace) {
-    mix_u64(entry.pc, &h);
-    mix_u64(static_cast<std::uint64_t>(entry.opcode), &h);
-    mix_u64(entry.write_reg.has_value() ? static_cast<std::uint64_t>(*entry.write_reg + 1U) : 0ULL, &h);
-    mix_u64(entry.write_value.has_value() ? static_cast<std::uint64_t>(*entry.write_value) : 0ULL, &h);
-    mix_u64(entry.write_tag.has_value() ? static_cast<std::uint64_t>(*entry.write_tag) + 1ULL : 0ULL, &h);
-    mix_u64(entry.trap.has_value() ? static_cast<std::uint64_t>(*entry.trap) : 0ULL, &h);
+  if (version == StateHashVersion::V2) {
+    mix_u64(state.memory.size(), &h);
+    mix_u64(memory_digest(state), &h);
+    mix_u64(state.trace_digest.length, &h);
+    mix_u64(state.trace_digest.value, &h);
+  } else {
+    for (const auto mem : state.memory) {
+      mix_u64(static_cast<std::uint64_t>(mem), &h);
+    }
+    mix_u64(state.trace.size(), &h);
+    for (const auto& entry : state.trace) {
+      mix_u64(entry.pc, &h);
+      mix_u64(static_cast<std::uint64_t>(entry.opcode), &h);
+      mix_u64(entry.write_reg.has_value() ? static_cast<std::uint64_t>(*entry.write_reg + 1U) : 0ULL, &h);
+      mix_u64(entry.write_value.has_value() ? static_cast<std::uint64_t>(*entry.write_value) : 0ULL, &h);
+      mix_u64(entry.write_tag.has_value() ? static_cast<std::uint64_t>(*entry.write_tag) + 1ULL : 0ULL, &h);
+      mix_u64(entry.trap.has_value() ? static_cast<std::uint64_t>(*entry.trap) : 0ULL, &h);
+    }
   }
 
   if (state.last_trap_payload.has_value()) {
@@ -109,11 +147,31 @@ std::string snapshot_summary(const State& state) {
     out << trap_payload << "\n";
   }
 
-  out << "STATE_HASH 0x" << std::hex << std::setfill('0') << std::setw(16) << state_hash(state)
-      << std::dec << "\n";
+  // The published hash covers the full trace; digest-only and flight-recorder runs
+  // publish the v2 hash instead and runs without any trace bookkeeping have no state hash.
+  if (state.trace_level == TraceLevel::Full) {
+    out << "STATE_HASH 0x" << std::hex << std::setfill('0') << std::setw(16) << state_hash(state)
+        << std::dec << "\n";
+  } else if (state.trace_level == TraceLevel::Digest || state.trace_level == TraceLevel::FlightRecorder) {
+    out << "STATE_HASH_V2 0x" << std::hex << std::setfill('0') << std::setw(16)
+        << state_hash(state, StateHashVersion::V2) << std::dec << "\n";
+  }
   return out.str();
 }
 
+std::string trace_line(const TraceEntry& entry) {
+  std::string line = std::to_string(entry.pc) + ":" + std::to_string(static_cast<int>(entry.opcode));
+  if (entry.write_reg.has_value() && entry.write_value.has_value() && entry.write_tag.has_value()) {
+    line += ":write=r" + std::to_string(*entry.write_reg) + "=" + std::to_string(*entry.write_value) + ":" +
+            to_string(*entry.write_tag);
+  }
+  if (entry.trap.has_value()) {
+    line += ":trap=";
+    line += to_string(*entry.trap);
+  }
+  return line;
+}
+
 std::string trap_payload_summary_line(const State& state) {
   if (!state.last_trap_payload.has_value()) {
     return {};
@@ -132,4 +190,39 @@ std::string trap_payload_summary_line(const State& state) {
   return out.str();
 }
 
+std::string flight_recorder_dump(const State& state) {
+  if (state.trace_level != TraceLevel::FlightRecorder) {
+    return {};
+  }
+  const auto& ring = state.flight_recorder;
+  std::string out = "FLIGHT_RECORDER depth=" + std::to_string(ring.depth()) +
+                    " recorded=" + std::to_string(ring.recorded()) + " kept=" + std::to_string(ring.size()) + "\n";
+  for (std::size_t i = 0; i < ring.size(); ++i) {
+    out += trace_line(ring[i]);
+    out += "\n";
+  }
+  return out;
+}
+
+std::string tier_report(const State& state) {
+  if (state.block_tiers.empty()) {
+    return {};
+  }
+  std::size_t promoted = 0;
+  for (const auto& block : state.block_tiers) {
+    promoted += block.tier > 0 ? 1 : 0;
+  }
+  std::string out = "TIER_REPORT blocks=" + std::to_string(state.block_tiers.size()) +
+                    " promoted=" + std::to_string(promoted) + "\n";
+  for (const auto& block : state.block_tiers) {
+    out += "TIER_BLOCK begin=" + std::to_string(block.begin) + " end=" + std::to_string(block.end) +
+           " entries=" + std::to_string(block.entries) + " tier=" + std::to_string(block.tier);
+    if (block.tier > 0) {
+      out += " promoted_at_step=" + std::to_string(block.promoted_at_step);
+    }
+    out += "\n";
+  }
+  return out;
+}
+
 }  // namespace t81::vm
@@ -0,0 +1,313 @@
+#include "t81/vm/trace_format.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+#include "t81/vm/summary.hpp"
+
+namespace t81::vm {
+namespace {
+
+constexpr std::uint8_t kFlagReg = 0x01;
+constexpr std::uint8_t kFlagValue = 0x02;
+constexpr std::uint8_t kFlagTag = 0x04;
+constexpr std::uint8_t kFlagTrap = 0x08;
+constexpr std::uint8_t kFlagNextPc = 0x10;
+constexpr std::uint8_t kRepeat = 0x80;
+// Shorter matches cost about as much as the literals they would replace.
+constexpr std::size_t kMinRepeat = 3;
+
+void put_varint(std::uint64_t v, std::string* out) {
+  while (v >= 0x80) {
+    out->push_back(static_cast<char>((v & 0x7F) | 0x80));
+    v >>= 7;
+  }
+  out->push_back(static_cast<char>(v));
+}
+
+std::uint64_t zigzag(std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v) {
+  return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+// Value a write delta is taken against; grows the table on first use of a register.
+std::int64_t& last_value(std::vector<std::int64_t>* values, std::size_t reg) {
+  if (reg >= values->size()) {
+    values->resize(reg + 1, 0);
+  }
+  return (*values)[reg];
+}
+
+void remember(const std::string& encoded, std::deque<std::string>* history) {
+  history->push_back(encoded);
+  if (history->size() > BinaryTraceWriter::kWindow) {
+    history->pop_front();
+  }
+}
+
+}  // namespace
+
+BinaryTraceWriter::BinaryTraceWriter(std::ostream& out) : out_(out) {
+  out_.write(kBinaryTraceMagic, sizeof(kBinaryTraceMagic));
+  out_.put(static_cast<char>(kBinaryTraceVersion));
+  out_.put(0);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter() {
+  finish();
+}
+
+void BinaryTraceWriter::write(const TraceEntry& entry) {
+  std::string e;
+  std::uint8_t flags = 0;
+  flags |= entry.write_reg.has_value() ? kFlagReg : 0;
+  flags |= entry.write_value.has_value() ? kFlagValue : 0;
+  flags |= entry.write_tag.has_value() ? kFlagTag : 0;
+  flags |= entry.trap.has_value() ? kFlagTrap : 0;
+  flags |= entry.pc == prev_pc_ + 1 ? kFlagNextPc : 0;
+  e.push_back(static_cast<char>(flags));
+  if ((flags & kFlagNextPc) == 0) {
+    put_varint(zigzag(static_cast<std::int64_t>(entry.pc - (prev_pc_ + 1))), &e);
+  }
+  e.push_back(static_cast<char>(entry.opcode));
+  const std::size_t reg = entry.write_reg.value_or(0);
+  if (entry.write_reg.has_value()) {
+    put_varint(reg, &e);
+  }
+  if (entry.write_value.has_value()) {
+    auto& last = last_value(&last_values_, reg);
+    put_varint(zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(*entry.write_value) -
+                                                static_cast<std::uint64_t>(last))),
+               &e);
+    last = *entry.write_value;
+  }
+  if (entry.write_tag.has_value()) {
+    e.push_back(static_cast<char>(*entry.write_tag));
+  }
+  if (entry.trap.has_value()) {
+    e.push_back(static_cast<char>(*entry.trap));
+  }
+  prev_pc_ = entry.pc;
+
+  // Extend the open match with every candidate offset that still agrees.
+  if (match_length_ > 0) {
+    std::vector<std::size_t> still;
+    for (const auto p : candidates_) {
+      if (history_[history_.size() - p] == e) {
+        still.push_back(p);
+      }
+    }
+    if (!still.empty()) {
+      candidates_ = std::move(still);
+      ++match_length_;
+      pending_.push_back(e);
+      remember(e, &history_);
+      return;
+    }
+    close_match();
+  }
+
+  for (std::size_t p = 1; p <= history_.size(); ++p) {
+    if (history_[history_.size() - p] == e) {
+      candidates_.push_back(p);
+    }
+  }
+  if (!candidates_.empty()) {
+    match_length_ = 1;
+    pending_.push_back(e);
+  } else {
+    emit_literal(e);
+  }
+  remember(e, &history_);
+}
+
+void BinaryTraceWriter::on_entries(std::span<const TraceEntry> batch) {
+  for (const auto& entry : batch) {
+    write(entry);
+  }
+}
+
+void BinaryTraceWriter::finish() {
+  if (finished_) {
+    return;
+  }
+  close_match();
+  out_.flush();
+  finished_ = true;
+}
+
+void BinaryTraceWriter::emit_literal(const std::string& encoded) {
+  out_.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+}
+
+void BinaryTraceWriter::close_match() {
+  if (match_length_ >= kMinRepeat) {
+    std::string rec(1, static_cast<char>(kRepeat));
+    put_varint(candidates_.front(), &rec);
+    put_varint(match_length_, &rec);
+    out_.write(rec.data(), static_cast<std::streamsize>(rec.size()));
+  } else {
+    for (const auto& e : pending_) {
+      emit_literal(e);
+    }
+  }
+  candidates_.clear();
+  pending_.clear();
+  match_length_ = 0;
+}
+
+BinaryTraceReader::BinaryTraceReader(std::istream& in) : in_(in) {
+  char header[sizeof(kBinaryTraceMagic) + 2] = {};
+  if (!in_.read(header, sizeof(header)) || !std::equal(kBinaryTraceMagic, kBinaryTraceMagic + 6, header)) {
+    fail("bad trace header");
+  } else if (static_cast<std::uint8_t>(header[6]) != kBinaryTraceVersion) {
+    fail("unsupported trace version " + std::to_string(static_cast<int>(static_cast<std::uint8_t>(header[6]))));
+  }
+}
+
+std::optional<TraceEntry> BinaryTraceReader::next() {
+  if (!error_.empty()) {
+    return std::nullopt;
+  }
+  std::string encoded;
+  if (repeat_left_ > 0) {
+    encoded = history_[history_.size() - repeat_offset_];
+    --repeat_left_;
+  } else {
+    const int first = in_.peek();
+    if (first == std::char_traits<char>::eof()) {
+      return std::nullopt;
+    }
+    if (static_cast<std::uint8_t>(first) == kRepeat) {
+      in_.get();
+      std::uint64_t offset = 0;
+      std::uint64_t count = 0;
+      for (auto* field : {&offset, &count}) {
+        int shift = 0;
+        int ch = 0;
+        do {
+          ch = in_.get();
+          if (ch == std::char_traits<char>::eof() || shift > 63) {
+            fail("truncated repeat record");
+            return std::nullopt;
+          }
+          *field |= static_cast<std::uint64_t>(ch & 0x7F) << shift;
+          shift += 7;
+        } while ((ch & 0x80) != 0);
+      }
+      if (offset == 0 || offset > history_.size() || count == 0) {
+        fail("repeat record out of range");
+        return std::nullopt;
+      }
+      repeat_offset_ = offset;
+      repeat_left_ = count - 1;
+      encoded = history_[history_.size() - repeat_offset_];
+    } else if (!read_literal(&encoded)) {
+      return std::nullopt;
+    }
+  }
+  auto entry = decode(encoded);
+  remember(encoded, &history_);
+  return entry;
+}
+
+// Reads one literal record, keeping its exact bytes so repeats can re-decode it.
+bool BinaryTraceReader::read_literal(std::string* encoded) {
+  auto byte = [&](std::string* out) {
+    const int ch = in_.get();
+    if (ch == std::char_traits<char>::eof()) {
+      return fail("truncated entry");
+    }
+    out->push_back(static_cast<char>(ch));
+    return true;
+  };
+  auto varint = [&](std::string* out) {
+    for (int i = 0; i < 10; ++i) {
+      if (!byte(out)) {
+        return false;
+      }
+      if ((static_cast<std::uint8_t>(out->back()) & 0x80) == 0) {
+        return true;
+      }
+    }
+    return fail("varint too long");
+  };
+  if (!byte(encoded)) {
+    return false;
+  }
+  const auto flags = static_cast<std::uint8_t>(encoded->front());
+  if ((flags & ~(kFlagReg | kFlagValue | kFlagTag | kFlagTrap | kFlagNextPc)) != 0) {
+    return fail("unknown entry flags");
+  }
+  return ((flags & kFlagNextPc) != 0 || varint(encoded)) && byte(encoded) &&
+         ((flags & kFlagReg) == 0 || varint(encoded)) && ((flags & kFlagValue) == 0 || varint(encoded)) &&
+         ((flags & kFlagTag) == 0 || byte(encoded)) && ((flags & kFlagTrap) == 0 || byte(encoded));
+}
+
+std::optional<TraceEntry> BinaryTraceReader::decode(const std::string& encoded) {
+  std::size_t i = 0;
+  auto varint = [&] {
+    std::uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+      const auto b = static_cast<std::uint8_t>(encoded[i++]);
+      v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+      if ((b & 0x80) == 0) {
+        return v;
+      }
+    }
+  };
+  const auto flags = static_cast<std::uint8_t>(encoded[i++]);
+  TraceEntry entry{
+      .pc = prev_pc_ + 1,
+      .opcode = t81::tisc::Opcode::Nop,
+      .write_reg = std::nullopt,
+      .write_value = std::nullopt,
+      .write_tag = std::nullopt,
+      .trap = std::nullopt,
+  };
+  if ((flags & kFlagNextPc) == 0) {
+    entry.pc += static_cast<std::size_t>(unzigzag(varint()));
+  }
+  entry.opcode = static_cast<t81::tisc::Opcode>(encoded[i++]);
+  const std::uint64_t reg = (flags & kFlagReg) != 0 ? varint() : 0;
+  if (reg >= std::tuple_size_v<decltype(State::registers)>) {
+    fail("register out of range");
+    return std::nullopt;
+  }
+  if ((flags & kFlagReg) != 0) {
+    entry.write_reg = static_cast<std::size_t>(reg);
+  }
+  if ((flags & kFlagValue) != 0) {
+    auto& last = last_value(&last_values_, static_cast<std::size_t>(reg));
+    last = static_cast<std::int64_t>(static_cast<std::uint64_t>(last) + static_cast<std::uint64_t>(unzigzag(varint())));
+    entry.write_value = last;
+  }
+  if ((flags & kFlagTag) != 0) {
+    entry.write_tag = static_cast<ValueTag>(encoded[i++]);
+  }
+  if ((flags & kFlagTrap) != 0) {
+    entry.trap = static_cast<Trap>(encoded[i++]);
+  }
+  prev_pc_ = entry.pc;
+  return entry;
+}
+
+bool BinaryTraceReader::fail(const std::string& message) {
+  if (error_.empty()) {
+    error_ = message;
+  }
+  return false;
+}
+
+std::string convert_binary_trace_to_text(std::istream& in, std::ostream& out) {
+  BinaryTraceReader reader(in);
+  while (const auto entry = reader.next()) {
+    out << trace_line(*entry) << "\n";
+  }
+  return reader.error();
+}
+
+}  // namespace t81::vm
@@ -0,0 +1,128 @@
+#include "t81/vm/trace_sink.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "t81/vm/summary.hpp"
+#include "t81/vm/trace_format.hpp"
+
+namespace t81::vm {
+
+struct FileTraceSink::Impl {
+  Impl(const std::string& path, std::size_t capacity, TraceFileFormat format)
+      : format(format),
+        out(path, std::ios::binary | std::ios::trunc),
+        ring(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+        mask(ring.size() - 1) {
+    if (out.is_open()) {
+      writer = std::thread([this] { run(); });
+    }
+  }
+
+  // Writer thread: format everything published so far, release the slots, then do the
+  // file I/O outside the ring. Flushes the stream whenever it catches up.
+  void run() {
+    std::ostringstream staging;
+    std::optional<BinaryTraceWriter> binary;
+    if (format == TraceFileFormat::Binary) {
+      binary.emplace(staging);
+    }
+    for (;;) {
+      std::size_t t = tail.load(std::memory_order_relaxed);
+      const std::size_t h = head.load(std::memory_order_acquire);
+      if (t == h) {
+        const bool stopping = stop.load(std::memory_order_acquire) && head.load(std::memory_order_acquire) == t;
+        if (stopping && binary.has_value()) {
+          binary->finish();
+          drain(&staging);
+        }
+        out.flush();
+        flushed.store(t, std::memory_order_release);
+        if (stopping) {
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        continue;
+      }
+      for (; t != h; ++t) {
+        if (binary.has_value()) {
+          binary->write(ring[t & mask]);
+        } else {
+          staging << trace_line(ring[t & mask]) << '\n';
+        }
+      }
+      tail.store(t, std::memory_order_release);
+      drain(&staging);
+    }
+  }
+
+  void drain(std::ostringstream* staging) {
+    const auto bytes = staging->view();
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    staging->str({});
+  }
+
+  TraceFileFormat format;
+  std::ofstream out;
+  std::vector<TraceEntry> ring;
+  std::size_t mask;
+  alignas(64) std::atomic<std::size_t> head{0};     // next slot the VM thread fills
+  alignas(64) std::atomic<std::size_t> tail{0};     // next slot the writer reads
+  alignas(64) std::atomic<std::size_t> flushed{0};  // entries written and flushed
+  std::atomic<bool> stop{false};
+  std::thread writer;
+};
+
+FileTraceSink::FileTraceSink(const std::string& path, std::size_t capacity, TraceFileFormat format)
+    : impl_(std::make_unique<Impl>(path, capacity, format)) {}
+
+FileTraceSink::~FileTraceSink() {
+  if (impl_->writer.joinable()) {
+    impl_->stop.store(true, std::memory_order_release);
+    impl_->writer.join();
+  }
+}
+
+bool FileTraceSink::ok() const {
+  return impl_->writer.joinable();
+}
+
+void FileTraceSink::on_entries(std::span<const TraceEntry> batch) {
+  if (!ok()) {
+    return;
+  }
+  auto& s = *impl_;
+  std::size_t h = s.head.load(std::memory_order_relaxed);
+  std::size_t i = 0;
+  while (i < batch.size()) {
+    const std::size_t free = s.ring.size() - (h - s.tail.load(std::memory_order_acquire));
+    if (free == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    const std::size_t n = std::min(free, batch.size() - i);
+    for (std::size_t k = 0; k < n; ++k, ++h) {
+      s.ring[h & s.mask] = batch[i + k];
+    }
+    i += n;
+    s.head.store(h, std::memory_order_release);
+  }
+}
+
+void FileTraceSink::flush() {
+  if (!ok()) {
+    return;
+  }
+  const std::size_t target = impl_->head.load(std::memory_order_relaxed);
+  while (impl_->flushed.load(std::memory_order_acquire) < target) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace t81::vm
@@ -1,6 +1,15 @@
 #include "t81/vm/validator.hpp"
 
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "t81/vm/parallel.hpp"
 
 namespace t81::vm {
 
@@ -101,139 +110,522 @@ bool valid_opcode(t81::tisc::Opcode opcode) {
   return false;
 }
 
+// Static operand checks for one instruction of a `size`-instruction program.
+bool valid_insn(const t81::tisc::Insn& insn, std::size_t size) {
+  if (!valid_opcode(insn.opcode)) {
+    return false;
+  }
+  switch (insn.opcode) {
+    case t81::tisc::Opcode::LoadImm:
+      if (!valid_reg(insn.a)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Load:
+      if (!valid_reg(insn.a)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Store:
+      if (!valid_reg(insn.b)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Div:
+    case t81::tisc::Opcode::Mod:
+    case t81::tisc::Opcode::Add:
+    case t81::tisc::Opcode::Sub:
+    case t81::tisc::Opcode::Mul:
+    case t81::tisc::Opcode::FAdd:
+    case t81::tisc::Opcode::FSub:
+    case t81::tisc::Opcode::FMul:
+    case t81::tisc::Opcode::FDiv:
+    case t81::tisc::Opcode::FracAdd:
+    case t81::tisc::Opcode::FracSub:
+    case t81::tisc::Opcode::FracMul:
+    case t81::tisc::Opcode::FracDiv:
+    case t81::tisc::Opcode::Less:
+    case t81::tisc::Opcode::LessEqual:
+    case t81::tisc::Opcode::Greater:
+    case t81::tisc::Opcode::GreaterEqual:
+    case t81::tisc::Opcode::Equal:
+    case t81::tisc::Opcode::NotEqual:
+    case t81::tisc::Opcode::TAnd:
+    case t81::tisc::Opcode::TOr:
+    case t81::tisc::Opcode::TXor:
+    case t81::tisc::Opcode::TVecAdd:
+    case t81::tisc::Opcode::TMatMul:
+    case t81::tisc::Opcode::TTenDot:
+    case t81::tisc::Opcode::TVecMul:
+    case t81::tisc::Opcode::ChkShape:
+      if (!valid_reg(insn.a) || !valid_reg(insn.b) || !valid_reg(insn.c)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::MakeOptionSome:
+    case t81::tisc::Opcode::MakeResultOk:
+    case t81::tisc::Opcode::MakeResultErr:
+    case t81::tisc::Opcode::OptionIsSome:
+    case t81::tisc::Opcode::OptionUnwrap:
+    case t81::tisc::Opcode::ResultIsOk:
+    case t81::tisc::Opcode::ResultUnwrapOk:
+    case t81::tisc::Opcode::ResultUnwrapErr:
+    case t81::tisc::Opcode::MakeEnumVariantPayload:
+    case t81::tisc::Opcode::EnumIsVariant:
+    case t81::tisc::Opcode::EnumUnwrapPayload:
+    case t81::tisc::Opcode::TTranspose:
+    case t81::tisc::Opcode::TExp:
+    case t81::tisc::Opcode::TSqrt:
+    case t81::tisc::Opcode::TSiLU:
+    case t81::tisc::Opcode::TSoftmax:
+    case t81::tisc::Opcode::TRMSNorm:
+    case t81::tisc::Opcode::TRoPE:
+    case t81::tisc::Opcode::TNot:
+      if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Cmp:
+      if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Mov:
+      if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Inc:
+    case t81::tisc::Opcode::Dec:
+    case t81::tisc::Opcode::Push:
+    case t81::tisc::Opcode::Pop:
+    case t81::tisc::Opcode::Neg:
+    case t81::tisc::Opcode::Call:
+    case t81::tisc::Opcode::I2F:
+    case t81::tisc::Opcode::F2I:
+    case t81::tisc::Opcode::I2Frac:
+    case t81::tisc::Opcode::Frac2I:
+    case t81::tisc::Opcode::StackAlloc:
+    case t81::tisc::Opcode::StackFree:
+    case t81::tisc::Opcode::HeapAlloc:
+    case t81::tisc::Opcode::HeapFree:
+    case t81::tisc::Opcode::MakeOptionNone:
+    case t81::tisc::Opcode::MakeEnumVariant:
+    case t81::tisc::Opcode::AxRead:
+    case t81::tisc::Opcode::AxVerify:
+    case t81::tisc::Opcode::WeightsLoad:
+      if (!valid_reg(insn.a)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::AxSet:
+    case t81::tisc::Opcode::SetF:
+      if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Jump:
+    case t81::tisc::Opcode::JumpIfZero:
+    case t81::tisc::Opcode::JumpIfNotZero:
+    case t81::tisc::Opcode::JumpIfNegative:
+    case t81::tisc::Opcode::JumpIfPositive:
+      if (insn.a < 0 || static_cast<std::size_t>(insn.a) >= size) {
+        return false;
+      }
+      break;
+    case t81::tisc::Opcode::Nop:
+    case t81::tisc::Opcode::Halt:
+    case t81::tisc::Opcode::Ret:
+    case t81::tisc::Opcode::Trap:
+      break;
+  }
+  return true;
+}
+
 }  // namespace
 
-std::optional<Trap> validate_program(const t81::tisc::Program& program) {
-  for (const auto& insn : program.insns) {
-    if (!valid_opcode(insn.opcode)) {
-      return Trap::DecodeFault;
+std::optional<Trap> validate_program(const t81::tisc::Program& program, const ValidateOptions& options) {
+  const auto& insns = program.insns;
+  const std::size_t chunks = parallel_width(insns.size(), options.min_chunk_insns, options.threads);
+  // Each chunk reports its first failing pc; the lowest one wins, so the result does not
+  // depend on the chunking. Chunks stop early once a lower failure is known.
+  std::atomic<std::size_t> first_failure{insns.size()};
+  parallel_invoke(chunks, [&](std::size_t chunk) {
+    const auto [begin, end] = chunk_range(insns.size(), chunks, chunk);
+    for (std::size_t pc = begin; pc < end; ++pc) {
+      if (!valid_insn(insns[pc], insns.size())) {
+        std::size_t known = first_failure.load(std::memory_order_relaxed);
+        while (pc < known && !first_failure.compare_exchange_weak(known, pc, std::memory_order_relaxed)) {
+        }
+        return;
+      }
+      if ((pc & 4095) == 0 && first_failure.load(std::memory_order_relaxed) < begin) {
+        return;
+      }
     }
+  });
+  if (first_failure.load() < insns.size()) {
+    return Trap::DecodeFault;
+  }
+  return std::nullopt;
+}
+
+std::vector<std::size_t> basic_block_leaders(const t81::tisc::Program& program) {
+  const std::size_t size = program.insns.size();
+  std::vector<bool> leader(size, false);
+  if (size > 0) {
+    leader[0] = true;
+  }
+  for (std::size_t pc = 0; pc < size; ++pc) {
+    const auto& insn = program.insns[pc];
     switch (insn.opcode) {
-      case t81::tisc::Opcode::LoadImm:
-        if (!valid_reg(insn.a)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::Load:
-        if (!valid_reg(insn.a)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::Store:
-        if (!valid_reg(insn.b)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::Div:
-      case t81::tisc::Opcode::Mod:
-      case t81::tisc::Opcode::Add:
-      case t81::tisc::Opcode::Sub:
-      case t81::tisc::Opcode::Mul:
-      case t81::tisc::Opcode::FAdd:
-      case t81::tisc::Opcode::FSub:
-      case t81::tisc::Opcode::FMul:
-      case t81::tisc::Opcode::FDiv:
-      case t81::tisc::Opcode::FracAdd:
-      case t81::tisc::Opcode::FracSub:
-      case t81::tisc::Opcode::FracMul:
-      case t81::tisc::Opcode::FracDiv:
-      case t81::tisc::Opcode::Less:
-      case t81::tisc::Opcode::LessEqual:
-      case t81::tisc::Opcode::Greater:
-      case t81::tisc::Opcode::GreaterEqual:
-      case t81::tisc::Opcode::Equal:
-      case t81::tisc::Opcode::NotEqual:
-      case t81::tisc::Opcode::TAnd:
-      case t81::tisc::Opcode::TOr:
-      case t81::tisc::Opcode::TXor:
-      case t81::tisc::Opcode::TVecAdd:
-      case t81::tisc::Opcode::TMatMul:
-      case t81::tisc::Opcode::TTenDot:
-      case t81::tisc::Opcode::TVecMul:
-      case t81::tisc::Opcode::ChkShape:
-        if (!valid_reg(insn.a) || !valid_reg(insn.b) || !valid_reg(insn.c)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::MakeOptionSome:
-      case t81::tisc::Opcode::MakeResultOk:
-      case t81::tisc::Opcode::MakeResultErr:
-      case t81::tisc::Opcode::OptionIsSome:
-      case t81::tisc::Opcode::OptionUnwrap:
-      case t81::tisc::Opcode::ResultIsOk:
-      case t81::tisc::Opcode::ResultUnwrapOk:
-      case t81::tisc::Opcode::ResultUnwrapErr:
-      case t81::tisc::Opcode::MakeEnumVariantPayload:
-      case t81::tisc::Opcode::EnumIsVariant:
-      case t81::tisc::Opcode::EnumUnwrapPayload:
-      case t81::tisc::Opcode::TTranspose:
-      case t81::tisc::Opcode::TExp:
-      case t81::tisc::Opcode::TSqrt:
-      case t81::tisc::Opcode::TSiLU:
-      case t81::tisc::Opcode::TSoftmax:
-      case t81::tisc::Opcode::TRMSNorm:
-      case t81::tisc::Opcode::TRoPE:
-      case t81::tisc::Opcode::TNot:
-        if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::Cmp:
-        if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::Mov:
-        if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::Inc:
-      case t81::tisc::Opcode::Dec:
-      case t81::tisc::Opcode::Push:
-      case t81::tisc::Opcode::Pop:
-      case t81::tisc::Opcode::Neg:
-      case t81::tisc::Opcode::Call:
-      case t81::tisc::Opcode::I2F:
-      case t81::tisc::Opcode::F2I:
-      case t81::tisc::Opcode::I2Frac:
-      case t81::tisc::Opcode::Frac2I:
-      case t81::tisc::Opcode::StackAlloc:
-      case t81::tisc::Opcode::StackFree:
-      case t81::tisc::Opcode::HeapAlloc:
-      case t81::tisc::Opcode::HeapFree:
-      case t81::tisc::Opcode::MakeOptionNone:
-      case t81::tisc::Opcode::MakeEnumVariant:
-      case t81::tisc::Opcode::AxRead:
-      case t81::tisc::Opcode::AxVerify:
-      case t81::tisc::Opcode::WeightsLoad:
-        if (!valid_reg(insn.a)) {
-          return Trap::DecodeFault;
-        }
-        break;
-      case t81::tisc::Opcode::AxSet:
-      case t81::tisc::Opcode::SetF:
-        if (!valid_reg(insn.a) || !valid_reg(insn.b)) {
-          return Trap::DecodeFault;
-        }
-        break;
       case t81::tisc::Opcode::Jump:
       case t81::tisc::Opcode::JumpIfZero:
       case t81::tisc::Opcode::JumpIfNotZero:
       case t81::tisc::Opcode::JumpIfNegative:
       case t81::tisc::Opcode::JumpIfPositive:
-        if (insn.a < 0 || static_cast<std::size_t>(insn.a) >= program.insns.size()) {
-          return Trap::DecodeFault;
+        if (insn.a >= 0 && static_cast<std::size_t>(insn.a) < size) {
+          leader[static_cast<std::size_t>(insn.a)] = true;
         }
-        break;
-      case t81::tisc::Opcode::Nop:
-      case t81::tisc::Opcode::Halt:
+        [[fallthrough]];
+      case t81::tisc::Opcode::Call:
       case t81::tisc::Opcode::Ret:
+      case t81::tisc::Opcode::Halt:
       case t81::tisc::Opcode::Trap:
+        if (pc + 1 < size) {
+          leader[pc + 1] = true;
+        }
+        break;
+      default:
         break;
     }
   }
-  return std::nullopt;
+  std::vector<std::size_t> out;
+  for (std::size_t pc = 0; pc < size; ++pc) {
+    if (leader[pc]) {
+      out.push_back(pc);
+    }
+  }
+  return out;
+}
+
+namespace {
+
+using TagSet = std::uint8_t;  // bit i set: the register may hold ValueTag i
+
+constexpr TagSet tag_bit(ValueTag tag) {
+  return static_cast<TagSet>(1U << static_cast<unsigned>(tag));
+}
+
+constexpr TagSet kAnyTag = 0x7F;
+
+// Abstract register file at one program point: the tags each register may hold, and
+// for registers some Call jumps through, the value when every path agrees on one
+// LoadImm constant.
+struct AbstractRegisters {
+  std::array<TagSet, kRegisterCount> tags{};
+  std::vector<std::optional<std::int64_t>> values;  // indexed by call-register slot
+
+  // Joins `other` into this state; true when anything widened.
+  bool join(const AbstractRegisters& other) {
+    bool changed = false;
+    for (std::size_t r = 0; r < kRegisterCount; ++r) {
+      const TagSet before = tags[r];
+      tags[r] = static_cast<TagSet>(tags[r] | other.tags[r]);
+      changed |= tags[r] != before;
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (values[i].has_value() && values[i] != other.values[i]) {
+        values[i].reset();
+        changed = true;
+      }
+    }
+    return changed;
+  }
+};
+
+constexpr std::size_t kNoSlot = kRegisterCount;
+
+// The tag an instruction writes to register `a`: kAnyTag for payload unwraps, 0 for
+// copies of `b`'s tag, nullopt when it writes no register. Mirrors Interpreter::step().
+std::optional<TagSet> written_tag(t81::tisc::Opcode opcode) {
+  using t81::tisc::Opcode;
+  switch (opcode) {
+    case Opcode::Nop:
+    case Opcode::Halt:
+    case Opcode::Store:
+    case Opcode::Jump:
+    case Opcode::JumpIfZero:
+    case Opcode::JumpIfNotZero:
+    case Opcode::JumpIfNegative:
+    case Opcode::JumpIfPositive:
+    case Opcode::Cmp:
+    case Opcode::Push:
+    case Opcode::Call:
+    case Opcode::Ret:
+    case Opcode::Trap:
+    case Opcode::AxSet:
+    case Opcode::StackFree:
+    case Opcode::HeapFree:
+      return std::nullopt;
+    case Opcode::Mov:
+    case Opcode::I2F:
+    case Opcode::F2I:
+    case Opcode::I2Frac:
+    case Opcode::Frac2I:
+      return TagSet{0};
+    case Opcode::TVecAdd:
+    case Opcode::TVecMul:
+    case Opcode::TMatMul:
+    case Opcode::TTenDot:
+    case Opcode::TTranspose:
+    case Opcode::TExp:
+    case Opcode::TSqrt:
+    case Opcode::TSiLU:
+    case Opcode::TSoftmax:
+    case Opcode::TRMSNorm:
+    case Opcode::TRoPE:
+      return tag_bit(ValueTag::TensorHandle);
+    case Opcode::WeightsLoad:
+      return tag_bit(ValueTag::WeightsTensorHandle);
+    case Opcode::MakeOptionSome:
+    case Opcode::MakeOptionNone:
+      return tag_bit(ValueTag::OptionHandle);
+    case Opcode::MakeResultOk:
+    case Opcode::MakeResultErr:
+      return tag_bit(ValueTag::ResultHandle);
+    case Opcode::MakeEnumVariant:
+    case Opcode::MakeEnumVariantPayload:
+      return tag_bit(ValueTag::EnumHandle);
+    case Opcode::OptionUnwrap:
+    case Opcode::ResultUnwrapOk:
+    case Opcode::ResultUnwrapErr:
+    case Opcode::EnumUnwrapPayload:
+      return kAnyTag;
+    default:
+      return tag_bit(ValueTag::Int);
+  }
+}
+
+// Tags `opcode` requires of its `b` and `c` operands (0: not checked).
+std::pair<TagSet, TagSet> required_tags(t81::tisc::Opcode opcode) {
+  using t81::tisc::Opcode;
+  switch (opcode) {
+    case Opcode::TVecAdd:
+    case Opcode::TVecMul:
+    case Opcode::TMatMul:
+    case Opcode::TTenDot:
+      return {tag_bit(ValueTag::TensorHandle), tag_bit(ValueTag::TensorHandle)};
+    case Opcode::TTranspose:
+    case Opcode::TExp:
+    case Opcode::TSqrt:
+    case Opcode::TSiLU:
+    case Opcode::TSoftmax:
+    case Opcode::TRMSNorm:
+    case Opcode::TRoPE:
+      return {tag_bit(ValueTag::TensorHandle), 0};
+    case Opcode::ChkShape:
+      return {tag_bit(ValueTag::TensorHandle), tag_bit(ValueTag::ShapeHandle)};
+    case Opcode::OptionIsSome:
+    case Opcode::OptionUnwrap:
+      return {tag_bit(ValueTag::OptionHandle), 0};
+    case Opcode::ResultIsOk:
+    case Opcode::ResultUnwrapOk:
+    case Opcode::ResultUnwrapErr:
+      return {tag_bit(ValueTag::ResultHandle), 0};
+    case Opcode::EnumIsVariant:
+    case Opcode::EnumUnwrapPayload:
+      return {tag_bit(ValueTag::EnumHandle), 0};
+    default:
+      return {0, 0};
+  }
+}
+
+TagCheck classify(const t81::tisc::Insn& insn, const AbstractRegisters& regs) {
+  const auto [need_b, need_c] = required_tags(insn.opcode);
+  if (need_b == 0) {
+    return TagCheck::None;
+  }
+  const TagSet have_b = regs.tags[static_cast<std::size_t>(insn.b)];
+  const TagSet have_c = need_c != 0 ? regs.tags[static_cast<std::size_t>(insn.c)] : TagSet{0};
+  if ((have_b & need_b) == 0 || (need_c != 0 && (have_c & need_c) == 0)) {
+    return TagCheck::Fail;
+  }
+  if ((have_b & ~need_b) == 0 && (have_c & ~need_c) == 0) {
+    return TagCheck::Pass;
+  }
+  return TagCheck::Dynamic;
+}
+
+// Applies a fall-through instruction's register write. `slot_of` maps a register to
+// its constant slot (kNoSlot when no Call reads it).
+void apply(const t81::tisc::Insn& insn, const std::array<std::size_t, kRegisterCount>& slot_of,
+           AbstractRegisters& regs) {
+  const auto written = written_tag(insn.opcode);
+  if (!written.has_value() || !valid_reg(insn.a)) {
+    return;
+  }
+  const auto a = static_cast<std::size_t>(insn.a);
+  std::optional<std::int64_t> value;
+  if (*written == 0) {
+    const auto b = static_cast<std::size_t>(insn.b);
+    regs.tags[a] = regs.tags[b];
+    if (insn.opcode == t81::tisc::Opcode::Mov && slot_of[b] != kNoSlot) {
+      value = regs.values[slot_of[b]];
+    }
+  } else {
+    regs.tags[a] = *written;
+    if (insn.opcode == t81::tisc::Opcode::LoadImm) {
+      value = insn.b;
+    }
+  }
+  if (slot_of[a] != kNoSlot) {
+    regs.values[slot_of[a]] = value;
+  }
+}
+
+}  // namespace
+
+std::vector<TagCheck> infer_tag_checks(const t81::tisc::Program& program) {
+  using t81::tisc::Opcode;
+  const std::size_t size = program.insns.size();
+  std::vector<TagCheck> checks(size, TagCheck::None);
+  bool any_checked = false;
+  for (std::size_t pc = 0; pc < size; ++pc) {
+    if (required_tags(program.insns[pc].opcode).first != 0) {
+      checks[pc] = TagCheck::Dynamic;
+      any_checked = true;
+    }
+  }
+  if (!any_checked || validate_program(program).has_value()) {
+    return checks;
+  }
+
+  // Constants are only tracked for registers some Call jumps through. A Ret may return
+  // to the instruction after any Call.
+  std::array<std::size_t, kRegisterCount> slot_of;
+  slot_of.fill(kNoSlot);
+  std::size_t slots = 0;
+  std::vector<std::size_t> return_points;
+  for (std::size_t pc = 0; pc < size; ++pc) {
+    const auto& insn = program.insns[pc];
+    if (insn.opcode == Opcode::Call) {
+      auto& slot = slot_of[static_cast<std::size_t>(insn.a)];
+      slot = slot == kNoSlot ? slots++ : slot;
+      return_points.push_back(pc + 1);
+    }
+  }
+
+  // Forward pass over blocks: the basic_block_leaders() blocks, split further at Call
+  // targets as they resolve. states[pc] is the join of every state flowing into the
+  // block starting at pc. Execution starts at pc 0 with every register an Int zero.
+  std::vector<bool> entry(size, false);
+  for (const auto leader : basic_block_leaders(program)) {
+    entry[leader] = true;
+  }
+  std::vector<std::unique_ptr<AbstractRegisters>> states(size);
+  states[0] = std::make_unique<AbstractRegisters>();
+  states[0]->tags.fill(tag_bit(ValueTag::Int));
+  states[0]->values.assign(slots, std::int64_t{0});
+  std::vector<std::size_t> worklist = {0};
+  std::vector<bool> queued(size, false);
+  queued[0] = true;
+  auto enqueue = [&](std::size_t pc) {
+    if (!queued[pc]) {
+      queued[pc] = true;
+      worklist.push_back(pc);
+    }
+  };
+  auto flow = [&](std::size_t target, const AbstractRegisters& regs) {
+    if (target >= size) {
+      return;
+    }
+    if (states[target] == nullptr) {
+      states[target] = std::make_unique<AbstractRegisters>(regs);
+    } else if (!states[target]->join(regs)) {
+      return;
+    }
+    enqueue(target);
+  };
+  // Walks the block at `begin` from its entry state, calling `visit(pc, regs)` before
+  // each instruction. False when a Call target cannot be resolved.
+  auto walk = [&](std::size_t begin, auto&& visit) {
+    AbstractRegisters regs = *states[begin];
+    for (std::size_t pc = begin; pc < size; ++pc) {
+      const auto& insn = program.insns[pc];
+      visit(pc, regs);
+      switch (insn.opcode) {
+        case Opcode::Jump:
+          flow(static_cast<std::size_t>(insn.a), regs);
+          return true;
+        case Opcode::JumpIfZero:
+        case Opcode::JumpIfNotZero:
+        case Opcode::JumpIfNegative:
+        case Opcode::JumpIfPositive:
+          flow(static_cast<std::size_t>(insn.a), regs);
+          flow(pc + 1, regs);
+          return true;
+        case Opcode::Call: {
+          const auto& callee = regs.values[slot_of[static_cast<std::size_t>(insn.a)]];
+          if (!callee.has_value()) {
+            return false;
+          }
+          if (*callee < 0 || static_cast<std::size_t>(*callee) >= size) {
+            return true;
+          }
+          const auto target = static_cast<std::size_t>(*callee);
+          if (!entry[target]) {
+            // New block boundary: re-walk every reached block so the one containing
+            // the target flows into it.
+            entry[target] = true;
+            for (std::size_t reached = 0; reached < size; ++reached) {
+              if (states[reached] != nullptr) {
+                enqueue(reached);
+              }
+            }
+          }
+          flow(target, regs);
+          return true;
+        }
+        case Opcode::Ret:
+          for (const auto point : return_points) {
+            flow(point, regs);
+          }
+          return true;
+        case Opcode::Halt:
+        case Opcode::Trap:
+          return true;
+        default:
+          apply(insn, slot_of, regs);
+          if (pc + 1 < size && entry[pc + 1]) {
+            flow(pc + 1, regs);
+            return true;
+          }
+          break;
+      }
+    }
+    return true;
+  };
+
+  while (!worklist.empty()) {
+    const std::size_t begin = worklist.back();
+    worklist.pop_back();
+    queued[begin] = false;
+    if (!walk(begin, [](std::size_t, const AbstractRegisters&) {})) {
+      // A register-indirect Call the pass cannot resolve: prove nothing.
+      return checks;
+    }
+  }
+  for (std::size_t begin = 0; begin < size; ++begin) {
+    if (states[begin] != nullptr && entry[begin]) {
+      walk(begin, [&](std::size_t pc, const AbstractRegisters& regs) {
+        if (checks[pc] != TagCheck::None) {
+          checks[pc] = classify(program.insns[pc], regs);
+        }
+      });
+    }
+  }
+  return checks;
 }
 
 }  // namespace t81::vm
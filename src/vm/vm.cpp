@@ -3,21 +3,54 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "t81/tisc/packed_code.hpp"
+#include "t81/vm/aot.hpp"
+#include "t81/vm/jit.hpp"
 #include "t81/vm/loader.hpp"
+#include "t81/vm/validator.hpp"
 
 namespace t81::vm {
 namespace {
 
+// Static bookkeeping policy for an interpreter instance. Every trace/Axion side effect in
+// the execution paths is guarded by `if constexpr` on these flags, so a disabled feature
+// costs no instructions in its specialization.
+template <TraceLevel Trace, AxionLogLevel Axion>
+struct ExecPolicy {
+  static constexpr TraceLevel kTraceLevel = Trace;
+  // Entries are produced (write deltas tracked, digest folded) unless tracing is off.
+  static constexpr bool kRecordTrace = Trace != TraceLevel::None;
+  // Entries are additionally stored in State::trace.
+  static constexpr bool kStoreTrace = Trace == TraceLevel::Full;
+  // Entries are kept in the fixed-depth State::flight_recorder ring.
+  static constexpr bool kRingTrace = Trace == TraceLevel::FlightRecorder;
+  static constexpr bool kAxionLog = Axion != AxionLogLevel::Off;
+  // Per-access SegmentAccess events (one per Store / segment-touching op).
+  static constexpr bool kAxionSegmentEvents = Axion == AxionLogLevel::All;
+};
+
+template <typename Policy>
 class Interpreter final : public IVirtualMachine {
  public:
-  void load_program(const t81::tisc::Program& program) override {
-    const auto loaded = load_program_image(program);
+  explicit Interpreter(const VmOptions& options)
+      : mode_(options.mode),
+        flight_recorder_depth_(options.flight_recorder_depth),
+        aot_module_(options.aot_module),
+        tier_up_threshold_(options.tier_up_threshold) {}
+
+  void load_program(const t81::tisc::Program& program) override { load_image(load_program_image(program)); }
+
+  void load_image(const LoadedProgram& loaded) override {
     program_ = loaded.program;
+    code_ = t81::tisc::PackedCode(program_.insns);
     state_ = loaded.initial_state;
     state_.register_tags.fill(ValueTag::Int);
     state_.option_pool.clear();
@@ -26,40 +59,118 @@ class Interpreter final : public IVirtualMachine {
     state_.tensor_pool.clear();
     state_.shape_pool.clear();
     state_.last_trap_payload.reset();
+    state_.trace_level = Policy::kTraceLevel;
+    state_.block_tiers.clear();
+    if constexpr (Policy::kAxionLog) {
+      state_.axion_log.reserve(kAxionLogReserve);
+    }
+    if constexpr (Policy::kRingTrace) {
+      state_.flight_recorder.reset(flight_recorder_depth_);
+    }
     preload_trap_ = loaded.preload_trap;
+    flags_pending_ = false;
+    resolve_memory_operands();
     steps_ = 0;
     call_stack_.clear();
+    decoded_.clear();
+    proven_queries_.clear();
+    native_.clear();
+    if (mode_ != ExecutionMode::Interpreter && !preload_trap_.has_value()) {
+      predecode();
+      if (mode_ == ExecutionMode::Aot && aot_module_ != nullptr && aot_module_->matches(program_)) {
+        native_.adopt(aot_module_->segments(program_, Policy::kRecordTrace), program_.insns.size(), aot_module_);
+      } else if (mode_ == ExecutionMode::Jit && jit::available()) {
+        native_.compile(program_, state_, Policy::kRecordTrace);
+      } else if (mode_ == ExecutionMode::Tiered) {
+        plan_tiers();
+      }
+      native_values_.assign(native_.max_length(), 0);
+      native_tags_.assign(native_.max_length(), ValueTag::Int);
+    }
   }
 
   std::expected<void, Trap> step() override {
+    auto res = execute_step();
+    sync_gc();
+    sync_flags();
+    flush_sink();
+    return res;
+  }
+
+  std::expected<void, Trap> run_to_halt(std::size_t max_steps = 100000) override {
+    auto res = run_steps(max_steps);
+    sync_flags();
+    flush_sink();
+    return res;
+  }
+
+  const State& state() const override { return state_; }
+
+  void set_register(int idx, std::int64_t value, ValueTag tag) override {
+    if (idx >= 0 && static_cast<std::size_t>(idx) < state_.registers.size()) {
+      set_register_value(static_cast<std::size_t>(idx), value, tag);
+      for (const auto pc : proven_queries_) {
+        decoded_[pc].handler = &h_reference;
+      }
+      proven_queries_.clear();
+    }
+  }
+
+  void set_trace_sink(ITraceSink* sink) override {
+    flush_sink();
+    sink_ = sink;
+    sink_batch_.reserve(kSinkBatch);
+  }
+
+ private:
+  static constexpr std::size_t kSinkBatch = 256;
+  static constexpr std::size_t kAxionLogReserve = 1024;
+
+  std::expected<void, Trap> run_steps(std::size_t max_steps) {
+    if (!decoded_.empty() && !state_.halted && !preload_trap_.has_value()) {
+      auto res = mode_ == ExecutionMode::Tiered ? run_tiered(max_steps)
+                 : native_.empty()                ? run_blocks(max_steps)
+                                                  : run_native(max_steps);
+      sync_gc();
+      return res;
+    }
+    for (std::size_t i = 0; i < max_steps; ++i) {
+      auto res = execute_step();
+      sync_gc();
+      if (!res.has_value()) {
+        return std::unexpected(res.error());
+      }
+      if (state_.halted) {
+        return {};
+      }
+    }
+    return std::unexpected(Trap::TrapInstruction);
+  }
+
+  void flush_sink() {
+    if (sink_ != nullptr && !sink_batch_.empty()) {
+      sink_->on_entries(sink_batch_);
+    }
+    sink_batch_.clear();
+  }
+
+  std::expected<void, Trap> execute_step() {
     if (state_.halted) {
       return {};
     }
     if (preload_trap_.has_value()) {
       return trap(*preload_trap_, current_opcode(), state_.pc);
     }
-    if (state_.pc >= program_.insns.size()) {
+    if (state_.pc >= code_.size()) {
       return trap(Trap::DecodeFault, t81::tisc::Opcode::Nop, state_.pc);
     }
 
     const std::size_t pc = state_.pc;
-    const t81::tisc::Insn insn = program_.insns[pc];
-    current_write_reg_.reset();
-    current_write_value_.reset();
-    current_write_tag_.reset();
-
-    if (++steps_ % kDeterministicGcInterval == 0) {
-      ++state_.gc_cycles;
-    }
-
-    auto set_flags = [this](std::int64_t value) {
-      state_.flags.zero = (value == 0);
-      state_.flags.negative = (value < 0);
-      state_.flags.positive = (value > 0);
-    };
+    const t81::tisc::Insn insn = code_[pc];
+    begin_step();
 
-    auto check_jump_target = [this, insn, pc](std::int64_t target) -> std::expected<void, Trap> {
-      if (target < 0 || static_cast<std::size_t>(target) >= program_.insns.size()) {
+    auto check_jump_target = [this, &insn, pc](std::int64_t target) -> std::expected<void, Trap> {
+      if (target < 0 || static_cast<std::size_t>(target) >= code_.size()) {
         return trap(Trap::DecodeFault, insn.opcode, pc);
       }
       state_.pc = static_cast<std::size_t>(target);
@@ -81,8 +192,8 @@ class Interpreter final : public IVirtualMachine {
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::Load:
-        if (!valid_mem(insn.b)) {
-          log_bounds_fault(insn.opcode, MemorySegmentKind::Unknown, insn.b, "memory load");
+        if (access_segment_[pc] == MemorySegmentKind::Unknown) {
+          log_bounds_fault(insn.opcode, MemorySegmentKind::Unknown, insn.b, AxionAction::MemoryLoad);
           return trap(Trap::BoundsFault, insn.opcode, pc, MemorySegmentKind::Unknown, "memory load");
         }
         set_register_value(static_cast<std::size_t>(insn.a), state_.memory[static_cast<std::size_t>(insn.b)],
@@ -91,12 +202,13 @@ class Interpreter final : public IVirtualMachine {
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::Store:
-        if (!valid_mem(insn.a)) {
-          log_bounds_fault(insn.opcode, MemorySegmentKind::Unknown, insn.a, "memory store");
+        if (access_segment_[pc] == MemorySegmentKind::Unknown) {
+          log_bounds_fault(insn.opcode, MemorySegmentKind::Unknown, insn.a, AxionAction::MemoryStore);
           return trap(Trap::BoundsFault, insn.opcode, pc, MemorySegmentKind::Unknown, "memory store");
         }
         state_.memory[static_cast<std::size_t>(insn.a)] = state_.registers[static_cast<std::size_t>(insn.b)];
-        log_segment_event(insn.opcode, segment_of(static_cast<std::size_t>(insn.a)));
+        state_.memory_pages.mark(static_cast<std::size_t>(insn.a));
+        log_segment_event(insn.opcode, access_segment_[pc]);
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::Add:
@@ -260,7 +372,7 @@ class Interpreter final : public IVirtualMachine {
       case t81::tisc::Opcode::Push:
         if (!push_register(static_cast<std::size_t>(insn.a))) {
           log_bounds_fault(insn.opcode, MemorySegmentKind::Stack, static_cast<std::int64_t>(state_.sp),
-                           "stack push");
+                           AxionAction::StackPush);
           return trap(Trap::StackFault, insn.opcode, pc, MemorySegmentKind::Stack, "stack push");
         }
         ++state_.pc;
@@ -268,7 +380,7 @@ class Interpreter final : public IVirtualMachine {
       case t81::tisc::Opcode::Pop:
         if (!pop_register(static_cast<std::size_t>(insn.a))) {
           log_bounds_fault(insn.opcode, MemorySegmentKind::Stack, static_cast<std::int64_t>(state_.sp),
-                           "stack pop");
+                           AxionAction::StackPop);
           return trap(Trap::StackFault, insn.opcode, pc, MemorySegmentKind::Stack, "stack pop");
         }
         set_flags(state_.registers[static_cast<std::size_t>(insn.a)]);
@@ -277,32 +389,32 @@ class Interpreter final : public IVirtualMachine {
       case t81::tisc::Opcode::Jump:
         return check_jump_target(insn.a);
       case t81::tisc::Opcode::JumpIfZero:
-        if (state_.flags.zero) {
+        if (flag_zero()) {
           return check_jump_target(insn.a);
         }
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::JumpIfNotZero:
-        if (!state_.flags.zero) {
+        if (!flag_zero()) {
           return check_jump_target(insn.a);
         }
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::JumpIfNegative:
-        if (state_.flags.negative) {
+        if (flag_negative()) {
           return check_jump_target(insn.a);
         }
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::JumpIfPositive:
-        if (state_.flags.positive) {
+        if (flag_positive()) {
           return check_jump_target(insn.a);
         }
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       case t81::tisc::Opcode::Call: {
         const auto target = state_.registers[static_cast<std::size_t>(insn.a)];
-        if (target < 0 || static_cast<std::size_t>(target) >= program_.insns.size()) {
+        if (target < 0 || static_cast<std::size_t>(target) >= code_.size()) {
           return trap(Trap::DecodeFault, insn.opcode, pc);
         }
         call_stack_.push_back(pc + 1);
@@ -323,7 +435,7 @@ class Interpreter final : public IVirtualMachine {
         const auto guard_kind = guard_addr >= 0 ? segment_of(static_cast<std::size_t>(guard_addr))
                                                 : MemorySegmentKind::Unknown;
         const auto denied = axion_denied();
-        log_axion_guard(insn.opcode, "AxRead guard", guard_kind, guard_addr, denied);
+        log_axion_guard(insn.opcode, guard_kind, guard_addr, denied);
         if (denied) {
           return trap(Trap::SecurityFault, insn.opcode, pc, guard_kind, "axion deny read");
         }
@@ -338,7 +450,7 @@ class Interpreter final : public IVirtualMachine {
         const auto guard_kind = guard_addr >= 0 ? segment_of(static_cast<std::size_t>(guard_addr))
                                                 : MemorySegmentKind::Unknown;
         const auto denied = axion_denied();
-        log_axion_guard(insn.opcode, "AxSet guard", guard_kind, guard_addr, denied, value);
+        log_axion_guard(insn.opcode, guard_kind, guard_addr, denied, value);
         if (denied) {
           return trap(Trap::SecurityFault, insn.opcode, pc, guard_kind, "axion deny set");
         }
@@ -347,7 +459,7 @@ class Interpreter final : public IVirtualMachine {
       }
       case t81::tisc::Opcode::AxVerify: {
         const auto denied = axion_denied();
-        log_axion_guard(insn.opcode, "AxVerify guard", MemorySegmentKind::Meta, static_cast<std::int64_t>(pc), denied);
+        log_axion_guard(insn.opcode, MemorySegmentKind::Meta, static_cast<std::int64_t>(pc), denied);
         if (denied) {
           return trap(Trap::SecurityFault, insn.opcode, pc, MemorySegmentKind::Meta, "axion deny verify");
         }
@@ -570,7 +682,7 @@ class Interpreter final : public IVirtualMachine {
       case t81::tisc::Opcode::WeightsLoad: {
         const auto handle = insn.b > 0 ? insn.b : (1000 + static_cast<std::int64_t>(pc));
         set_register_value(static_cast<std::size_t>(insn.a), handle, ValueTag::WeightsTensorHandle);
-        state_.axion_log.push_back({insn.opcode, "weights handle loaded"});
+        log_event(insn.opcode, AxionReason::WeightsHandleLoaded);
         set_flags(state_.registers[static_cast<std::size_t>(insn.a)]);
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
@@ -727,13 +839,13 @@ class Interpreter final : public IVirtualMachine {
         }
         const std::size_t bytes = static_cast<std::size_t>(insn.b);
         if (bytes > state_.sp || state_.sp - bytes < state_.layout.stack.start) {
-          log_bounds_fault(insn.opcode, MemorySegmentKind::Stack, insn.b, "stack frame allocate");
+          log_bounds_fault(insn.opcode, MemorySegmentKind::Stack, insn.b, AxionAction::StackFrameAllocate);
           return trap(Trap::StackFault, insn.opcode, pc, MemorySegmentKind::Stack, "stack frame allocate");
         }
         state_.sp -= bytes;
         state_.stack_frames.push_back({state_.sp, bytes});
         set_register_value(static_cast<std::size_t>(insn.a), static_cast<std::int64_t>(state_.sp), ValueTag::Int);
-        state_.axion_log.push_back({insn.opcode, "stack frame allocated"});
+        log_event(insn.opcode, AxionReason::StackFrameAllocated);
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       }
@@ -749,7 +861,7 @@ class Interpreter final : public IVirtualMachine {
         }
         state_.stack_frames.pop_back();
         state_.sp += top.second;
-        state_.axion_log.push_back({insn.opcode, "stack frame freed"});
+        log_event(insn.opcode, AxionReason::StackFrameFreed);
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       }
@@ -759,14 +871,14 @@ class Interpreter final : public IVirtualMachine {
         }
         const std::size_t bytes = static_cast<std::size_t>(insn.b);
         if (state_.heap_ptr + bytes > state_.layout.heap.limit) {
-          log_bounds_fault(insn.opcode, MemorySegmentKind::Heap, insn.b, "heap block allocate");
+          log_bounds_fault(insn.opcode, MemorySegmentKind::Heap, insn.b, AxionAction::HeapBlockAllocate);
           return trap(Trap::BoundsFault, insn.opcode, pc, MemorySegmentKind::Heap, "heap block allocate");
         }
         const std::size_t addr = state_.heap_ptr;
         state_.heap_ptr += bytes;
         state_.heap_frames.push_back({addr, bytes});
         set_register_value(static_cast<std::size_t>(insn.a), static_cast<std::int64_t>(addr), ValueTag::Int);
-        state_.axion_log.push_back({insn.opcode, "heap block allocated"});
+        log_event(insn.opcode, AxionReason::HeapBlockAllocated);
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       }
@@ -782,7 +894,7 @@ class Interpreter final : public IVirtualMachine {
         }
         state_.heap_frames.pop_back();
         state_.heap_ptr = top.first;
-        state_.axion_log.push_back({insn.opcode, "heap block freed"});
+        log_event(insn.opcode, AxionReason::HeapBlockFreed);
         ++state_.pc;
         return trace_ok(insn.opcode, pc);
       }
@@ -791,31 +903,788 @@ class Interpreter final : public IVirtualMachine {
     return trap(Trap::DecodeFault, insn.opcode, pc);
   }
 
-  std::expected<void, Trap> run_to_halt(std::size_t max_steps = 100000) override {
-    for (std::size_t i = 0; i < max_steps; ++i) {
-      auto res = step();
-      if (!res.has_value()) {
-        return std::unexpected(res.error());
+  static constexpr std::size_t kDeterministicGcInterval = 64;
+  static constexpr std::int64_t kTritMax = 1;
+  static constexpr std::int64_t kTritMin = -1;
+
+  // Pre-decoded instruction for the accelerated-preview backend. Operands are pre-cast to
+  // register indices (handlers only read fields the validator has proven in range) and
+  // literal operands (immediates, addresses, jump targets) are kept in `imm`.
+  struct DecodedInsn;
+  using Handler = bool (*)(Interpreter&, const DecodedInsn&);
+  // 16 bytes, four to a cache line. Register operands are below 243 in a loaded
+  // program; an immediate outside int32 leaves its instruction on h_reference.
+  struct DecodedInsn {
+    Handler handler = nullptr;
+    std::int32_t imm = 0;
+    std::uint8_t a = 0;
+    std::uint8_t b = 0;
+    std::uint8_t c = 0;
+    t81::tisc::Opcode opcode = t81::tisc::Opcode::Nop;
+  };
+  static_assert(sizeof(DecodedInsn) == 16);
+
+  static bool fits_imm(std::int64_t value) {
+    return value >= std::numeric_limits<std::int32_t>::min() && value <= std::numeric_limits<std::int32_t>::max();
+  }
+
+  void begin_step() {
+    if constexpr (Policy::kRecordTrace) {
+      current_write_reg_.reset();
+      current_write_value_.reset();
+      current_write_tag_.reset();
+    }
+    ++steps_;
+  }
+
+  // Deterministic GC accounting: one cycle per kDeterministicGcInterval executed steps.
+  // Derived from the step counter at API boundaries instead of being tracked per step.
+  void sync_gc() { state_.gc_cycles = steps_ / kDeterministicGcInterval; }
+
+  // Flag-producing instructions only record their value. Conditional jumps derive the
+  // flag they test from it, and sync_flags() materializes State::flags before the host
+  // can observe state() and before native code, which uses State::flags directly, runs.
+  void set_flags(std::int64_t value) {
+    flag_value_ = value;
+    flags_pending_ = true;
+  }
+
+  bool flag_zero() const { return flags_pending_ ? flag_value_ == 0 : state_.flags.zero; }
+  bool flag_negative() const { return flags_pending_ ? flag_value_ < 0 : state_.flags.negative; }
+  bool flag_positive() const { return flags_pending_ ? flag_value_ > 0 : state_.flags.positive; }
+
+  void sync_flags() {
+    if (flags_pending_) {
+      state_.flags = Flags{.zero = flag_value_ == 0, .negative = flag_value_ < 0, .positive = flag_value_ > 0};
+      flags_pending_ = false;
+    }
+  }
+
+  void predecode() {
+    using t81::tisc::Opcode;
+    decoded_.reserve(program_.insns.size() + 1);
+    for (const auto& insn : program_.insns) {
+      DecodedInsn d{
+          .handler = &h_reference,
+          .imm = 0,
+          .a = static_cast<std::uint8_t>(insn.a),
+          .b = static_cast<std::uint8_t>(insn.b),
+          .c = static_cast<std::uint8_t>(insn.c),
+          .opcode = insn.opcode,
+      };
+      std::int64_t imm = 0;
+      switch (insn.opcode) {
+        case Opcode::Nop:
+          d.handler = &h_nop;
+          break;
+        case Opcode::LoadImm:
+          d.handler = &h_load_imm;
+          imm = insn.b;
+          break;
+        case Opcode::Load:
+          // Out-of-range accesses stay on the reference path, which raises their trap.
+          if (access_segment_[decoded_.size()] != MemorySegmentKind::Unknown) {
+            d.handler = &h_load;
+          }
+          imm = insn.b;
+          break;
+        case Opcode::Store:
+          d.handler = store_handler(access_segment_[decoded_.size()]);
+          imm = insn.a;
+          break;
+        case Opcode::Add:
+        case Opcode::FAdd:
+        case Opcode::FracAdd:
+          d.handler = &h_arith<Opcode::Add>;
+          break;
+        case Opcode::Sub:
+        case Opcode::FSub:
+        case Opcode::FracSub:
+          d.handler = &h_arith<Opcode::Sub>;
+          break;
+        case Opcode::Mul:
+        case Opcode::FMul:
+        case Opcode::FracMul:
+          d.handler = &h_arith<Opcode::Mul>;
+          break;
+        case Opcode::Div:
+        case Opcode::FDiv:
+        case Opcode::FracDiv:
+          d.handler = &h_arith<Opcode::Div>;
+          break;
+        case Opcode::Mod:
+          d.handler = &h_arith<Opcode::Mod>;
+          break;
+        case Opcode::Less:
+          d.handler = &h_compare<Opcode::Less>;
+          break;
+        case Opcode::LessEqual:
+          d.handler = &h_compare<Opcode::LessEqual>;
+          break;
+        case Opcode::Greater:
+          d.handler = &h_compare<Opcode::Greater>;
+          break;
+        case Opcode::GreaterEqual:
+          d.handler = &h_compare<Opcode::GreaterEqual>;
+          break;
+        case Opcode::Equal:
+          d.handler = &h_compare<Opcode::Equal>;
+          break;
+        case Opcode::NotEqual:
+          d.handler = &h_compare<Opcode::NotEqual>;
+          break;
+        case Opcode::Mov:
+          d.handler = &h_mov;
+          break;
+        case Opcode::Inc:
+          d.handler = &h_step_by<1>;
+          break;
+        case Opcode::Dec:
+          d.handler = &h_step_by<-1>;
+          break;
+        case Opcode::Cmp:
+          d.handler = &h_cmp;
+          break;
+        case Opcode::Neg:
+          d.handler = &h_neg;
+          break;
+        case Opcode::Push:
+          d.handler = &h_push;
+          break;
+        case Opcode::Pop:
+          d.handler = &h_pop;
+          break;
+        case Opcode::Jump:
+          d.handler = &h_jump;
+          imm = insn.a;
+          break;
+        case Opcode::JumpIfZero:
+          d.handler = &h_jump_if<Opcode::JumpIfZero>;
+          imm = insn.a;
+          break;
+        case Opcode::JumpIfNotZero:
+          d.handler = &h_jump_if<Opcode::JumpIfNotZero>;
+          imm = insn.a;
+          break;
+        case Opcode::JumpIfNegative:
+          d.handler = &h_jump_if<Opcode::JumpIfNegative>;
+          imm = insn.a;
+          break;
+        case Opcode::JumpIfPositive:
+          d.handler = &h_jump_if<Opcode::JumpIfPositive>;
+          imm = insn.a;
+          break;
+        case Opcode::Call:
+          d.handler = &h_call;
+          break;
+        case Opcode::Ret:
+          d.handler = &h_ret;
+          break;
+        default:
+          break;
       }
-      if (state_.halted) {
-        return {};
+      if (fits_imm(imm)) {
+        d.imm = static_cast<std::int32_t>(imm);
+      } else {
+        d.handler = &h_reference;
+      }
+      decoded_.push_back(d);
+    }
+    // Falling off the end of the program resolves through the reference path so the
+    // DecodeFault trap and its trace entry are produced exactly as in interpreter mode.
+    decoded_.push_back(DecodedInsn{.handler = &h_reference});
+    bind_proven_queries();
+    partition_blocks();
+    fuse_superinstructions();
+  }
+
+  // Structured-value queries whose operand tag infer_tag_checks() proved get handlers
+  // without the TypeFault check. A host register write voids the proof (set_register()).
+  void bind_proven_queries() {
+    using t81::tisc::Opcode;
+    const auto checks = infer_tag_checks(program_);
+    for (std::size_t pc = 0; pc < checks.size(); ++pc) {
+      if (checks[pc] != TagCheck::Pass) {
+        continue;
+      }
+      DecodedInsn& d = decoded_[pc];
+      switch (d.opcode) {
+        case Opcode::OptionIsSome:
+          d.handler = &h_proven_query<Opcode::OptionIsSome>;
+          break;
+        case Opcode::OptionUnwrap:
+          d.handler = &h_proven_query<Opcode::OptionUnwrap>;
+          break;
+        case Opcode::ResultIsOk:
+          d.handler = &h_proven_query<Opcode::ResultIsOk>;
+          break;
+        case Opcode::ResultUnwrapOk:
+          d.handler = &h_proven_query<Opcode::ResultUnwrapOk>;
+          break;
+        case Opcode::ResultUnwrapErr:
+          d.handler = &h_proven_query<Opcode::ResultUnwrapErr>;
+          break;
+        case Opcode::EnumIsVariant:
+          if (!fits_imm(program_.insns[pc].c)) {
+            continue;
+          }
+          d.handler = &h_proven_query<Opcode::EnumIsVariant>;
+          d.imm = static_cast<std::int32_t>(program_.insns[pc].c);
+          break;
+        case Opcode::EnumUnwrapPayload:
+          d.handler = &h_proven_query<Opcode::EnumUnwrapPayload>;
+          break;
+        default:
+          continue;
+      }
+      proven_queries_.push_back(pc);
+    }
+  }
+
+  // block_end_[pc] is one past the last instruction of the basic block containing pc, so
+  // a block can be entered anywhere (register-indirect call targets are not leaders).
+  // The end-of-program sentinel is a block of its own.
+  void partition_blocks() {
+    const std::size_t size = program_.insns.size();
+    block_end_.assign(size + 1, size + 1);
+    std::size_t next = size;
+    const auto leaders = basic_block_leaders(program_);
+    auto leader = leaders.rbegin();
+    for (std::size_t pc = size; pc-- > 0;) {
+      block_end_[pc] = next;
+      if (leader != leaders.rend() && *leader == pc) {
+        next = pc;
+        ++leader;
+      }
+    }
+  }
+
+  // Hot two-instruction idioms (`Dec; JumpIfNotZero`, `Cmp; JumpIfZero`, `Less;
+  // JumpIfNotZero`, `LoadImm; Add`, ...) get a fused handler on their first slot when no
+  // jump lands on the second. The second slot keeps its own handler, so register-indirect
+  // calls into it still execute correctly.
+  void fuse_superinstructions() {
+    for (std::size_t pc = 0; pc + 1 < program_.insns.size(); ++pc) {
+      if (block_end_[pc] == pc + 1 || decoded_[pc].handler == &h_reference ||
+          decoded_[pc + 1].handler == &h_reference) {
+        continue;
+      }
+      if (const Handler fused = fused_handler(program_.insns[pc].opcode, program_.insns[pc + 1].opcode)) {
+        decoded_[pc].handler = fused;
+      }
+    }
+  }
+
+  template <Handler First>
+  static Handler fused_with_branch(t81::tisc::Opcode second) {
+    using t81::tisc::Opcode;
+    switch (second) {
+      case Opcode::JumpIfZero:
+        return &h_fused<First, &h_jump_if<Opcode::JumpIfZero>>;
+      case Opcode::JumpIfNotZero:
+        return &h_fused<First, &h_jump_if<Opcode::JumpIfNotZero>>;
+      case Opcode::JumpIfNegative:
+        return &h_fused<First, &h_jump_if<Opcode::JumpIfNegative>>;
+      case Opcode::JumpIfPositive:
+        return &h_fused<First, &h_jump_if<Opcode::JumpIfPositive>>;
+      default:
+        return nullptr;
+    }
+  }
+
+  static Handler fused_handler(t81::tisc::Opcode first, t81::tisc::Opcode second) {
+    using t81::tisc::Opcode;
+    switch (first) {
+      case Opcode::Dec:
+        return fused_with_branch<&h_step_by<-1>>(second);
+      case Opcode::Inc:
+        return fused_with_branch<&h_step_by<1>>(second);
+      case Opcode::Cmp:
+        return fused_with_branch<&h_cmp>(second);
+      case Opcode::Less:
+        return fused_with_branch<&h_compare<Opcode::Less>>(second);
+      case Opcode::LessEqual:
+        return fused_with_branch<&h_compare<Opcode::LessEqual>>(second);
+      case Opcode::Greater:
+        return fused_with_branch<&h_compare<Opcode::Greater>>(second);
+      case Opcode::GreaterEqual:
+        return fused_with_branch<&h_compare<Opcode::GreaterEqual>>(second);
+      case Opcode::Equal:
+        return fused_with_branch<&h_compare<Opcode::Equal>>(second);
+      case Opcode::NotEqual:
+        return fused_with_branch<&h_compare<Opcode::NotEqual>>(second);
+      case Opcode::LoadImm:
+        switch (second) {
+          case Opcode::Add:
+            return &h_fused<&h_load_imm, &h_arith<Opcode::Add>>;
+          case Opcode::Sub:
+            return &h_fused<&h_load_imm, &h_arith<Opcode::Sub>>;
+          case Opcode::Mul:
+            return &h_fused<&h_load_imm, &h_arith<Opcode::Mul>>;
+          default:
+            return nullptr;
+        }
+      default:
+        return nullptr;
+    }
+  }
+
+  // Runs whole basic blocks: the budget is checked once per block, and a block only
+  // starts when the remaining budget covers all of it. Otherwise instructions are
+  // dispatched one at a time so execution stops exactly at max_steps. Budgets count
+  // steps_, not dispatches, since a fused handler runs two steps per dispatch (and only
+  // its first half when that exhausts the budget).
+  std::expected<void, Trap> run_blocks(std::size_t max_steps) {
+    const DecodedInsn* code = decoded_.data();
+    const std::size_t end = decoded_.size() - 1;
+    exit_trap_.reset();
+    step_limit_ = max_steps > SIZE_MAX - steps_ ? SIZE_MAX : steps_ + max_steps;
+    while (steps_ < step_limit_) {
+      if (!run_block(code, std::min(state_.pc, end))) {
+        return exit_result();
       }
     }
     return std::unexpected(Trap::TrapInstruction);
   }
 
-  const State& state() const override { return state_; }
+  // Runs the block containing `at` from `at` through its final transfer, or the single
+  // instruction at `at` when the remaining budget does not cover the rest of the block.
+  // Returns false when execution stopped.
+  bool run_block(const DecodedInsn* code, std::size_t at) {
+    const std::size_t stop = block_end_[at];
+    if (step_limit_ - steps_ < stop - at) {
+      return code[at].handler(*this, code[at]);
+    }
+    // Within a block every instruction but the last falls through, so the pc only
+    // moves forward until the block's final transfer (which may loop back into it).
+    std::size_t prev = 0;
+    do {
+      if (!code[at].handler(*this, code[at])) {
+        return false;
+      }
+      prev = at;
+      at = state_.pc;
+    } while (at > prev && at < stop);
+    return true;
+  }
 
-  void set_register(int idx, std::int64_t value, ValueTag tag) override {
-    if (idx >= 0 && static_cast<std::size_t>(idx) < state_.registers.size()) {
-      set_register_value(static_cast<std::size_t>(idx), value, tag);
+  // One BlockTier per basic block, all starting at tier 0.
+  void plan_tiers() {
+    const std::size_t size = program_.insns.size();
+    tier_of_.assign(size, 0);
+    for (std::size_t pc = 0; pc < size; pc = block_end_[pc]) {
+      std::fill(tier_of_.begin() + static_cast<std::ptrdiff_t>(pc),
+                tier_of_.begin() + static_cast<std::ptrdiff_t>(block_end_[pc]), state_.block_tiers.size());
+      state_.block_tiers.push_back(BlockTier{.begin = pc, .end = block_end_[pc]});
     }
   }
 
- private:
-  static constexpr std::size_t kDeterministicGcInterval = 64;
-  static constexpr std::int64_t kTritMax = 1;
-  static constexpr std::int64_t kTritMin = -1;
+  // Tiered loop: every dispatch of a block's leader counts as an entry, and the entry
+  // that reaches the threshold promotes the block before it runs. Tier-0 blocks step
+  // through the reference path one instruction at a time; tier-1 blocks run on the
+  // pre-decoded handlers exactly as in run_blocks(). Both paths commit identical state,
+  // so where a promotion lands never shows in traces, hashes or traps.
+  std::expected<void, Trap> run_tiered(std::size_t max_steps) {
+    const DecodedInsn* code = decoded_.data();
+    const std::size_t end = decoded_.size() - 1;
+    exit_trap_.reset();
+    step_limit_ = max_steps > SIZE_MAX - steps_ ? SIZE_MAX : steps_ + max_steps;
+    while (steps_ < step_limit_) {
+      const std::size_t at = std::min(state_.pc, end);
+      if (at == end) {
+        if (!h_reference(*this, code[at])) {
+          return exit_result();
+        }
+        continue;
+      }
+      BlockTier& block = state_.block_tiers[tier_of_[at]];
+      if (at == block.begin && ++block.entries >= tier_up_threshold_ && block.tier == 0) {
+        block.tier = 1;
+        block.promoted_at_step = steps_;
+      }
+      if (!(block.tier == 0 ? h_reference(*this, code[at]) : run_block(code, at))) {
+        return exit_result();
+      }
+    }
+    return std::unexpected(Trap::TrapInstruction);
+  }
+
+  // JIT loop: a native segment runs whenever one starts at the pc and the budget covers
+  // all of it; everything else (segment tails cut by the budget, uncompiled instructions,
+  // and instructions a segment bailed out on) is dispatched through the handlers.
+  std::expected<void, Trap> run_native(std::size_t max_steps) {
+    const DecodedInsn* code = decoded_.data();
+    const std::size_t end = decoded_.size() - 1;
+    jit::Context ctx{
+        .registers = state_.registers.data(),
+        .register_tags = state_.register_tags.data(),
+        .memory = state_.memory.data(),
+        .dirty_pages = state_.memory_pages.dirty.data(),
+        .sp = &state_.sp,
+        .flags = &state_.flags,
+        .write_values = native_values_.data(),
+        .write_tags = native_tags_.data(),
+        .budget = 0,
+        .next_pc = 0,
+    };
+    exit_trap_.reset();
+    step_limit_ = max_steps > SIZE_MAX - steps_ ? SIZE_MAX : steps_ + max_steps;
+    while (steps_ < step_limit_) {
+      const std::size_t at = std::min(state_.pc, end);
+      const jit::Segment* segment = native_.segment_at(at);
+      if (segment != nullptr && step_limit_ - steps_ >= segment->length) {
+        ctx.budget = step_limit_ - steps_;
+        sync_flags();
+        const std::size_t completed = segment->fn(&ctx);
+        commit_native(*segment, completed);
+        state_.pc = ctx.next_pc;
+        if (completed != 0) {
+          continue;
+        }
+        // Bailed out on the first instruction: run it on the reference path.
+      }
+      if (!code[at].handler(*this, code[at])) {
+        return exit_result();
+      }
+    }
+    return std::unexpected(Trap::TrapInstruction);
+  }
+
+  // Native code only updates machine state; the step count, trace entries and Axion
+  // segment events of the `completed` instructions are committed here, in order.
+  void commit_native(const jit::Segment& segment, std::size_t completed) {
+    steps_ += completed;
+    if constexpr (Policy::kRecordTrace || Policy::kAxionSegmentEvents) {
+      if (!Policy::kRecordTrace && !segment.stores) {
+        return;
+      }
+      for (std::size_t i = 0, k = 0; i < completed; ++i, k = k + 1 == segment.length ? 0 : k + 1) {
+        const std::size_t pc = segment.begin + k;
+        const auto insn = code_[pc];
+        if (insn.opcode == t81::tisc::Opcode::Store) {
+          log_segment_event(insn.opcode, segment_of(static_cast<std::size_t>(insn.a)));
+        }
+        if constexpr (Policy::kRecordTrace) {
+          TraceEntry entry{
+              .pc = pc,
+              .opcode = insn.opcode,
+              .write_reg = std::nullopt,
+              .write_value = std::nullopt,
+              .write_tag = std::nullopt,
+              .trap = std::nullopt,
+          };
+          const auto kind = jit::write_kind(insn.opcode);
+          if (kind != jit::WriteKind::None) {
+            entry.write_reg = static_cast<std::size_t>(insn.a);
+            entry.write_value = native_values_[k];
+            entry.write_tag = kind == jit::WriteKind::Copy ? native_tags_[k] : ValueTag::Int;
+          }
+          record_trace(entry);
+          if (i + 1 == completed) {
+            // A trap on the next step reports the write pending from this one.
+            current_write_reg_ = entry.write_reg;
+            current_write_value_ = entry.write_value;
+            current_write_tag_ = entry.write_tag;
+          }
+        }
+      }
+    }
+  }
+
+  std::expected<void, Trap> exit_result() const {
+    if (exit_trap_.has_value()) {
+      return std::unexpected(*exit_trap_);
+    }
+    return {};
+  }
+
+  // Handlers return true to continue the block loop and false when execution must
+  // stop (halt or trap). Rare and faulting paths defer to the reference step() before
+  // any state is touched, so trap payloads and trace entries stay byte-identical.
+  static bool h_reference(Interpreter& vm, const DecodedInsn&) {
+    auto res = vm.execute_step();
+    if (!res.has_value()) {
+      vm.exit_trap_ = res.error();
+      return false;
+    }
+    return !vm.state_.halted;
+  }
+
+  // Superinstruction: both halves run their ordinary handlers, so each still commits
+  // its own trace entry and flags. First is always a fall-through instruction, and the
+  // decoded entry for pc + 1 sits directly after `d`.
+  template <Handler First, Handler Second>
+  static bool h_fused(Interpreter& vm, const DecodedInsn& d) {
+    if (!First(vm, d)) {
+      return false;
+    }
+    if (vm.steps_ >= vm.step_limit_) {
+      return true;
+    }
+    return Second(vm, (&d)[1]);
+  }
+
+  bool fast_next(const DecodedInsn& d) {
+    const std::size_t pc = state_.pc++;
+    trace_ok(d.opcode, pc);
+    return true;
+  }
+
+  bool fast_goto(const DecodedInsn& d, std::size_t target) {
+    const std::size_t pc = state_.pc;
+    state_.pc = target;
+    trace_ok(d.opcode, pc);
+    return true;
+  }
+
+  static bool h_nop(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    return vm.fast_next(d);
+  }
+
+  static bool h_load_imm(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    vm.set_register_value(d.a, d.imm, ValueTag::Int);
+    vm.set_flags(d.imm);
+    return vm.fast_next(d);
+  }
+
+  // Load/Store handlers are only bound to in-range addresses (resolve_memory_operands()).
+  static bool h_load(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    const auto value = vm.state_.memory[static_cast<std::size_t>(d.imm)];
+    vm.set_register_value(d.a, value, ValueTag::Int);
+    vm.set_flags(value);
+    return vm.fast_next(d);
+  }
+
+  template <MemorySegmentKind Segment>
+  static bool h_store(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    const auto addr = static_cast<std::size_t>(d.imm);
+    vm.state_.memory[addr] = vm.state_.registers[d.b];
+    vm.state_.memory_pages.mark(addr);
+    vm.log_segment_event(d.opcode, Segment);
+    return vm.fast_next(d);
+  }
+
+  static Handler store_handler(MemorySegmentKind segment) {
+    switch (segment) {
+      case MemorySegmentKind::Code:
+        return &h_store<MemorySegmentKind::Code>;
+      case MemorySegmentKind::Stack:
+        return &h_store<MemorySegmentKind::Stack>;
+      case MemorySegmentKind::Heap:
+        return &h_store<MemorySegmentKind::Heap>;
+      case MemorySegmentKind::Tensor:
+        return &h_store<MemorySegmentKind::Tensor>;
+      case MemorySegmentKind::Meta:
+        return &h_store<MemorySegmentKind::Meta>;
+      case MemorySegmentKind::Unknown:
+        break;
+    }
+    return &h_reference;
+  }
+
+  template <t81::tisc::Opcode Op>
+  static bool h_arith(Interpreter& vm, const DecodedInsn& d) {
+    using t81::tisc::Opcode;
+    const auto lhs = vm.state_.registers[d.b];
+    const auto rhs = vm.state_.registers[d.c];
+    if constexpr (Op == Opcode::Div || Op == Opcode::Mod) {
+      if (rhs == 0) {
+        return h_reference(vm, d);
+      }
+    }
+    vm.begin_step();
+    std::int64_t result = 0;
+    if constexpr (Op == Opcode::Add) {
+      result = lhs + rhs;
+    } else if constexpr (Op == Opcode::Sub) {
+      result = lhs - rhs;
+    } else if constexpr (Op == Opcode::Mul) {
+      result = lhs * rhs;
+    } else if constexpr (Op == Opcode::Div) {
+      result = lhs / rhs;
+    } else {
+      result = lhs % rhs;
+    }
+    vm.set_register_value(d.a, result, ValueTag::Int);
+    vm.set_flags(result);
+    return vm.fast_next(d);
+  }
+
+  template <t81::tisc::Opcode Op>
+  static bool h_compare(Interpreter& vm, const DecodedInsn& d) {
+    using t81::tisc::Opcode;
+    const auto lhs = vm.state_.registers[d.b];
+    const auto rhs = vm.state_.registers[d.c];
+    bool result = false;
+    if constexpr (Op == Opcode::Less) {
+      result = lhs < rhs;
+    } else if constexpr (Op == Opcode::LessEqual) {
+      result = lhs <= rhs;
+    } else if constexpr (Op == Opcode::Greater) {
+      result = lhs > rhs;
+    } else if constexpr (Op == Opcode::GreaterEqual) {
+      result = lhs >= rhs;
+    } else if constexpr (Op == Opcode::Equal) {
+      result = lhs == rhs;
+    } else {
+      result = lhs != rhs;
+    }
+    vm.begin_step();
+    vm.set_register_value(d.a, result ? 1 : 0, ValueTag::Int);
+    vm.set_flags(result ? 1 : 0);
+    return vm.fast_next(d);
+  }
+
+  static bool h_mov(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    const auto value = vm.state_.registers[d.b];
+    vm.set_register_value(d.a, value, vm.state_.register_tags[d.b]);
+    vm.set_flags(value);
+    return vm.fast_next(d);
+  }
+
+  template <int Delta>
+  static bool h_step_by(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    auto& reg = vm.state_.registers[d.a];
+    reg += Delta;
+    vm.state_.register_tags[d.a] = ValueTag::Int;
+    vm.set_flags(reg);
+    return vm.fast_next(d);
+  }
+
+  static bool h_cmp(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    vm.set_flags(vm.state_.registers[d.a] - vm.state_.registers[d.b]);
+    return vm.fast_next(d);
+  }
+
+  static bool h_neg(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    const auto value = -vm.state_.registers[d.b];
+    vm.set_register_value(d.a, value, ValueTag::Int);
+    vm.set_flags(value);
+    return vm.fast_next(d);
+  }
+
+  static bool h_push(Interpreter& vm, const DecodedInsn& d) {
+    if (vm.state_.sp == 0 || vm.state_.sp - 1 < vm.state_.layout.stack.start) {
+      return h_reference(vm, d);
+    }
+    vm.begin_step();
+    vm.push_register(d.a);
+    return vm.fast_next(d);
+  }
+
+  static bool h_pop(Interpreter& vm, const DecodedInsn& d) {
+    if (vm.state_.sp >= vm.state_.layout.stack.limit) {
+      return h_reference(vm, d);
+    }
+    vm.begin_step();
+    vm.pop_register(d.a);
+    vm.set_flags(vm.state_.registers[d.a]);
+    return vm.fast_next(d);
+  }
+
+  // Query on a handle whose tag is proven: only a stale handle or a missing payload is
+  // left to detect, and those trap through the reference path.
+  template <t81::tisc::Opcode Op>
+  static bool h_proven_query(Interpreter& vm, const DecodedInsn& d) {
+    using t81::tisc::Opcode;
+    const std::int64_t handle = vm.state_.registers[d.b];
+    std::int64_t value = 0;
+    ValueTag tag = ValueTag::Int;
+    if constexpr (Op == Opcode::OptionIsSome || Op == Opcode::OptionUnwrap) {
+      const auto* option = vm.option_ptr(handle);
+      if (option == nullptr || (Op == Opcode::OptionUnwrap && !option->has_value)) {
+        return h_reference(vm, d);
+      }
+      value = Op == Opcode::OptionIsSome ? (option->has_value ? 1 : 0) : option->payload;
+      tag = Op == Opcode::OptionIsSome ? ValueTag::Int : option->payload_tag;
+    } else if constexpr (Op == Opcode::ResultIsOk || Op == Opcode::ResultUnwrapOk || Op == Opcode::ResultUnwrapErr) {
+      const auto* result = vm.result_ptr(handle);
+      if (result == nullptr || (Op == Opcode::ResultUnwrapOk && !result->is_ok) ||
+          (Op == Opcode::ResultUnwrapErr && result->is_ok)) {
+        return h_reference(vm, d);
+      }
+      value = Op == Opcode::ResultIsOk ? (result->is_ok ? 1 : 0) : result->payload;
+      tag = Op == Opcode::ResultIsOk ? ValueTag::Int : result->payload_tag;
+    } else {
+      const auto* enum_value = vm.enum_ptr(handle);
+      if (enum_value == nullptr || (Op == Opcode::EnumUnwrapPayload && !enum_value->has_payload)) {
+        return h_reference(vm, d);
+      }
+      value = Op == Opcode::EnumIsVariant ? (enum_value->variant_id == d.imm ? 1 : 0) : enum_value->payload;
+      tag = Op == Opcode::EnumIsVariant ? ValueTag::Int : enum_value->payload_tag;
+    }
+    vm.begin_step();
+    vm.set_register_value(d.a, value, tag);
+    vm.set_flags(value);
+    return vm.fast_next(d);
+  }
+
+  static bool h_jump(Interpreter& vm, const DecodedInsn& d) {
+    vm.begin_step();
+    return vm.fast_goto(d, static_cast<std::size_t>(d.imm));
+  }
+
+  template <t81::tisc::Opcode Op>
+  static bool h_jump_if(Interpreter& vm, const DecodedInsn& d) {
+    using t81::tisc::Opcode;
+    vm.begin_step();
+    bool taken = false;
+    if constexpr (Op == Opcode::JumpIfZero) {
+      taken = vm.flag_zero();
+    } else if constexpr (Op == Opcode::JumpIfNotZero) {
+      taken = !vm.flag_zero();
+    } else if constexpr (Op == Opcode::JumpIfNegative) {
+      taken = vm.flag_negative();
+    } else {
+      taken = vm.flag_positive();
+    }
+    if (taken) {
+      return vm.fast_goto(d, static_cast<std::size_t>(d.imm));
+    }
+    return vm.fast_next(d);
+  }
+
+  static bool h_call(Interpreter& vm, const DecodedInsn& d) {
+    const auto target = vm.state_.registers[d.a];
+    if (target < 0 || static_cast<std::size_t>(target) >= vm.code_.size()) {
+      return h_reference(vm, d);
+    }
+    vm.begin_step();
+    vm.call_stack_.push_back(vm.state_.pc + 1);
+    return vm.fast_goto(d, static_cast<std::size_t>(target));
+  }
+
+  static bool h_ret(Interpreter& vm, const DecodedInsn& d) {
+    if (vm.call_stack_.empty()) {
+      return h_reference(vm, d);
+    }
+    vm.begin_step();
+    const auto target = vm.call_stack_.back();
+    vm.call_stack_.pop_back();
+    return vm.fast_goto(d, target);
+  }
+
+  // Load and Store take immediate addresses and the layout is fixed at load, so each
+  // one's segment is resolved once here; Unknown marks an out-of-range access.
+  void resolve_memory_operands() {
+    using t81::tisc::Opcode;
+    access_segment_.assign(program_.insns.size(), MemorySegmentKind::Unknown);
+    for (std::size_t pc = 0; pc < program_.insns.size(); ++pc) {
+      const auto& insn = program_.insns[pc];
+      const std::int64_t addr = insn.opcode == Opcode::Load ? insn.b : insn.opcode == Opcode::Store ? insn.a : -1;
+      if (valid_mem(addr)) {
+        access_segment_[pc] = segment_of(static_cast<std::size_t>(addr));
+      }
+    }
+  }
 
   bool valid_mem(std::int64_t idx) const {
     if (idx < 0) {
@@ -837,21 +1706,33 @@ class Interpreter final : public IVirtualMachine {
     return MemorySegmentKind::Unknown;
   }
 
+  void log_event(t81::tisc::Opcode opcode, AxionReason code) {
+    if constexpr (Policy::kAxionLog) {
+      state_.axion_log.push_back(AxionEvent{.opcode = opcode, .code = code});
+    }
+  }
+
   void log_segment_event(t81::tisc::Opcode opcode, MemorySegmentKind kind) {
+    if constexpr (!Policy::kAxionSegmentEvents) {
+      return;
+    }
     if (kind == MemorySegmentKind::Unknown) {
       return;
     }
-    state_.axion_log.push_back({opcode, std::string("segment access ") + to_string(kind)});
+    state_.axion_log.push_back(AxionEvent{.opcode = opcode, .code = AxionReason::SegmentAccess, .segment = kind});
   }
 
-  void log_bounds_fault(t81::tisc::Opcode opcode, MemorySegmentKind segment, std::int64_t addr, std::string action) {
-    std::string reason = "bounds fault segment=";
-    reason += to_string(segment);
-    reason += " addr=";
-    reason += std::to_string(addr);
-    reason += " action=";
-    reason += action;
-    state_.axion_log.push_back({opcode, reason});
+  void log_bounds_fault(t81::tisc::Opcode opcode, MemorySegmentKind segment, std::int64_t addr, AxionAction action) {
+    if constexpr (!Policy::kAxionLog) {
+      return;
+    }
+    state_.axion_log.push_back(AxionEvent{
+        .opcode = opcode,
+        .code = AxionReason::BoundsFault,
+        .action = action,
+        .segment = segment,
+        .addr = addr,
+    });
   }
 
   bool push_register(std::size_t reg_index) {
@@ -860,6 +1741,7 @@ class Interpreter final : public IVirtualMachine {
     }
     --state_.sp;
     state_.memory[state_.sp] = state_.registers[reg_index];
+    state_.memory_pages.mark(state_.sp);
     return true;
   }
 
@@ -876,9 +1758,11 @@ class Interpreter final : public IVirtualMachine {
   void set_register_value(std::size_t reg_index, std::int64_t value, ValueTag tag) {
     state_.registers[reg_index] = value;
     state_.register_tags[reg_index] = tag;
-    current_write_reg_ = reg_index;
-    current_write_value_ = value;
-    current_write_tag_ = tag;
+    if constexpr (Policy::kRecordTrace) {
+      current_write_reg_ = reg_index;
+      current_write_value_ = value;
+      current_write_tag_ = tag;
+    }
   }
 
   static std::int64_t clamp_trit(std::int64_t value) {
@@ -893,23 +1777,20 @@ class Interpreter final : public IVirtualMachine {
 
   bool axion_denied() const { return state_.policy.has_value() && state_.policy->tier == 0; }
 
-  void log_axion_guard(t81::tisc::Opcode opcode, const char* label, MemorySegmentKind segment, std::int64_t addr,
-                       bool denied, std::optional<std::int64_t> value = std::nullopt) {
-    std::string reason = label;
-    reason += " segment=";
-    reason += to_string(segment);
-    reason += " addr=";
-    reason += std::to_string(addr);
-    if (value.has_value()) {
-      reason += " value=";
-      reason += std::to_string(*value);
-    }
-    if (denied) {
-      reason += " deny=tier0";
-    } else {
-      reason += " allow";
+  void log_axion_guard(t81::tisc::Opcode opcode, MemorySegmentKind segment, std::int64_t addr, bool denied,
+                       std::optional<std::int64_t> value = std::nullopt) {
+    if constexpr (!Policy::kAxionLog) {
+      return;
     }
-    state_.axion_log.push_back({opcode, reason});
+    state_.axion_log.push_back(AxionEvent{
+        .opcode = opcode,
+        .code = AxionReason::Guard,
+        .segment = segment,
+        .denied = denied,
+        .has_value = value.has_value(),
+        .addr = addr,
+        .value = value.value_or(0),
+    });
   }
 
   std::int64_t intern_option(bool has_value, ValueTag payload_tag, std::int64_t payload) {
@@ -984,21 +1865,43 @@ class Interpreter final : public IVirtualMachine {
   }
 
   t81::tisc::Opcode current_opcode() const {
-    if (state_.pc < program_.insns.size()) {
-      return program_.insns[state_.pc].opcode;
+    if (state_.pc < code_.size()) {
+      return code_.opcode(state_.pc);
     }
     return t81::tisc::Opcode::Nop;
   }
 
+  void record_trace(const TraceEntry& entry) {
+    if constexpr (Policy::kRecordTrace) {
+      state_.trace_digest.fold(entry);
+    }
+    if constexpr (Policy::kStoreTrace) {
+      state_.trace.push_back(entry);
+    }
+    if constexpr (Policy::kRingTrace) {
+      state_.flight_recorder.push(entry);
+    }
+    if constexpr (Policy::kRecordTrace) {
+      if (sink_ != nullptr) {
+        sink_batch_.push_back(entry);
+        if (sink_batch_.size() == kSinkBatch) {
+          flush_sink();
+        }
+      }
+    }
+  }
+
   std::expected<void, Trap> trace_ok(t81::tisc::Opcode opcode, std::size_t pc) {
-    state_.trace.push_back(TraceEntry{
-        .pc = pc,
-        .opcode = opcode,
-        .write_reg = current_write_reg_,
-        .write_value = current_write_value_,
-        .write_tag = current_write_tag_,
-        .trap = std::nullopt,
-    });
+    if constexpr (Policy::kRecordTrace) {
+      record_trace(TraceEntry{
+          .pc = pc,
+          .opcode = opcode,
+          .write_reg = current_write_reg_,
+          .write_value = current_write_value_,
+          .write_tag = current_write_tag_,
+          .trap = std::nullopt,
+      });
+    }
     return {};
   }
 
@@ -1008,8 +1911,8 @@ class Interpreter final : public IVirtualMachine {
     std::int64_t a = 0;
     std::int64_t b = 0;
     std::int64_t c = 0;
-    if (pc < program_.insns.size()) {
-      const auto& fault_insn = program_.insns[pc];
+    if (pc < code_.size()) {
+      const auto fault_insn = code_[pc];
       if (fault_insn.opcode == opcode) {
         a = fault_insn.a;
         b = fault_insn.b;
@@ -1028,32 +1931,84 @@ class Interpreter final : public IVirtualMachine {
         .detail = std::move(detail),
     };
 
-    state_.trace.push_back(TraceEntry{
-        .pc = pc,
-        .opcode = opcode,
-        .write_reg = current_write_reg_,
-        .write_value = current_write_value_,
-        .write_tag = current_write_tag_,
-        .trap = trap_code,
-    });
+    if constexpr (Policy::kRecordTrace) {
+      record_trace(TraceEntry{
+          .pc = pc,
+          .opcode = opcode,
+          .write_reg = current_write_reg_,
+          .write_value = current_write_value_,
+          .write_tag = current_write_tag_,
+          .trap = trap_code,
+      });
+    }
     preload_trap_.reset();
     return std::unexpected(trap_code);
   }
 
+  ExecutionMode mode_;
+  std::size_t flight_recorder_depth_;
+  std::shared_ptr<const AotModule> aot_module_;
+  std::uint64_t tier_up_threshold_;
   t81::tisc::Program program_;
+  t81::tisc::PackedCode code_;  // what the engines fetch from; program_ is only read at load
+  std::vector<DecodedInsn> decoded_;
+  std::vector<MemorySegmentKind> access_segment_;  // per pc, see resolve_memory_operands()
+  std::vector<std::size_t> proven_queries_;  // pcs bound by bind_proven_queries()
+  std::vector<std::size_t> block_end_;
+  std::vector<std::size_t> tier_of_;  // pc -> index into State::block_tiers
+  jit::NativeProgram native_;
+  std::vector<std::int64_t> native_values_;  // jit::Context write log
+  std::vector<ValueTag> native_tags_;
+  std::optional<Trap> exit_trap_;
   State state_;
   std::optional<Trap> preload_trap_;
   std::size_t steps_ = 0;
+  std::size_t step_limit_ = 0;  // steps_ value at which run_blocks() stops
+  std::int64_t flag_value_ = 0;  // last flag-producing value, see set_flags()
+  bool flags_pending_ = false;   // State::flags is stale until sync_flags()
   std::vector<std::size_t> call_stack_;
   std::optional<std::size_t> current_write_reg_;
   std::optional<std::int64_t> current_write_value_;
   std::optional<ValueTag> current_write_tag_;
+  ITraceSink* sink_ = nullptr;
+  std::vector<TraceEntry> sink_batch_;
 };
 
 }  // namespace
 
+namespace {
+
+template <TraceLevel Trace>
+std::unique_ptr<IVirtualMachine> make_with_trace_level(const VmOptions& options) {
+  switch (options.axion_log) {
+    case AxionLogLevel::All:
+      return std::make_unique<Interpreter<ExecPolicy<Trace, AxionLogLevel::All>>>(options);
+    case AxionLogLevel::NoSegmentAccess:
+      return std::make_unique<Interpreter<ExecPolicy<Trace, AxionLogLevel::NoSegmentAccess>>>(options);
+    case AxionLogLevel::Off:
+      return std::make_unique<Interpreter<ExecPolicy<Trace, AxionLogLevel::Off>>>(options);
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 std::unique_ptr<IVirtualMachine> make_interpreter_vm() {
-  return std::make_unique<Interpreter>();
+  return make_vm(VmOptions{});
+}
+
+std::unique_ptr<IVirtualMachine> make_vm(const VmOptions& options) {
+  switch (options.trace) {
+    case TraceLevel::Full:
+      return make_with_trace_level<TraceLevel::Full>(options);
+    case TraceLevel::Digest:
+      return make_with_trace_level<TraceLevel::Digest>(options);
+    case TraceLevel::None:
+      return make_with_trace_level<TraceLevel::None>(options);
+    case TraceLevel::FlightRecorder:
+      return make_with_trace_level<TraceLevel::FlightRecorder>(options);
+  }
+  return nullptr;
 }
 
 }  // namespace t81::vm
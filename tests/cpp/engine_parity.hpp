@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+// Helpers for the tests that hold an execution engine to the reference interpreter.
+namespace t81::test {
+
+inline tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+// Everything a host can read back from `m`: summary, flags, trace, Axion event reasons,
+// trap payload, STATE_HASH and GC cycles.
+inline std::string observe(const vm::IVirtualMachine& m) {
+  const auto& s = m.state();
+  std::string out = vm::snapshot_summary(s);
+  out += " flags=" + std::to_string(s.flags.zero) + std::to_string(s.flags.negative) + std::to_string(s.flags.positive);
+  out += "\n";
+  for (const auto& e : s.trace) {
+    out += vm::trace_line(e) + "\n";
+  }
+  for (const auto& e : s.axion_log) {
+    out += e.reason() + "\n";
+  }
+  out += vm::trap_payload_summary_line(s) + "\n";
+  out += "hash=" + std::to_string(vm::state_hash(s)) + " gc=" + std::to_string(s.gc_cycles) + "\n";
+  return out;
+}
+
+// Runs `ref` and `other`, loaded with the same program, `chunk` steps at a time for up
+// to `total` steps, requiring the same result and observable state after every chunk,
+// so budgets end at every offset within every block. Stops at a halt or a fault.
+inline void run_lockstep(vm::IVirtualMachine& ref, vm::IVirtualMachine& other, std::size_t chunk, std::size_t total) {
+  for (std::size_t done = 0; done < total && !ref.state().halted; done += chunk) {
+    const auto ref_res = ref.run_to_halt(chunk);
+    const auto other_res = other.run_to_halt(chunk);
+    assert(ref_res.has_value() == other_res.has_value());
+    if (!ref_res.has_value()) {
+      assert(ref_res.error() == other_res.error());
+    }
+    assert(observe(ref) == observe(other));
+    if (!ref_res.has_value() && ref_res.error() != vm::Trap::TrapInstruction) {
+      break;
+    }
+  }
+}
+
+// run_lockstep() of `program` under the interpreter and under `options.mode`, both with
+// `options`. Returns the engine under test for further checks.
+inline std::unique_ptr<vm::IVirtualMachine> check_against_interpreter(const tisc::Program& program,
+                                                                      vm::VmOptions options, std::size_t chunk,
+                                                                      std::size_t total) {
+  auto other = vm::make_vm(options);
+  options.mode = vm::ExecutionMode::Interpreter;
+  auto ref = vm::make_vm(options);
+  ref->load_program(program);
+  other->load_program(program);
+  run_lockstep(*ref, *other, chunk, total);
+  return other;
+}
+
+}  // namespace t81::test
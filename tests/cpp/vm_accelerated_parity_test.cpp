@@ -0,0 +1,179 @@
+#include <cassert>
+#include <cstddef>
+#include <expected>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+void assert_same_state(const vm::State& ref, const vm::State& acc) {
+  assert(ref.pc == acc.pc);
+  assert(ref.halted == acc.halted);
+  assert(ref.gc_cycles == acc.gc_cycles);
+  assert(ref.registers == acc.registers);
+  assert(ref.register_tags == acc.register_tags);
+  assert(ref.memory == acc.memory);
+  assert(ref.sp == acc.sp);
+  assert(ref.flags.zero == acc.flags.zero);
+  assert(ref.flags.negative == acc.flags.negative);
+  assert(ref.flags.positive == acc.flags.positive);
+  assert(ref.trace.size() == acc.trace.size());
+  for (std::size_t i = 0; i < ref.trace.size(); ++i) {
+    assert(ref.trace[i].pc == acc.trace[i].pc);
+    assert(ref.trace[i].opcode == acc.trace[i].opcode);
+    assert(ref.trace[i].write_reg == acc.trace[i].write_reg);
+    assert(ref.trace[i].write_value == acc.trace[i].write_value);
+    assert(ref.trace[i].write_tag == acc.trace[i].write_tag);
+    assert(ref.trace[i].trap == acc.trace[i].trap);
+  }
+  assert(ref.axion_log.size() == acc.axion_log.size());
+  for (std::size_t i = 0; i < ref.axion_log.size(); ++i) {
+    assert(ref.axion_log[i].opcode == acc.axion_log[i].opcode);
+    assert(ref.axion_log[i].reason() == acc.axion_log[i].reason());
+  }
+  assert(vm::trap_payload_summary_line(ref) == vm::trap_payload_summary_line(acc));
+  assert(vm::state_hash(ref) == vm::state_hash(acc));
+}
+
+std::expected<void, vm::Trap> run_both(const tisc::Program& p, std::size_t max_steps = 100000) {
+  auto ref = vm::make_interpreter_vm();
+  auto acc = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+  ref->load_program(p);
+  acc->load_program(p);
+  const auto ref_result = ref->run_to_halt(max_steps);
+  const auto acc_result = acc->run_to_halt(max_steps);
+  assert(ref_result.has_value() == acc_result.has_value());
+  if (!ref_result.has_value()) {
+    assert(ref_result.error() == acc_result.error());
+  }
+  assert_same_state(ref->state(), acc->state());
+  return ref_result;
+}
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  // Scalar arithmetic, comparisons and flag-driven loops.
+  {
+    auto p = make({
+        {Opcode::LoadImm, 0, 200, 0},
+        {Opcode::LoadImm, 1, 3, 0},
+        {Opcode::LoadImm, 5, -7, 0},
+        {Opcode::Add, 2, 2, 1},
+        {Opcode::Mul, 3, 1, 1},
+        {Opcode::Sub, 4, 2, 3},
+        {Opcode::Div, 6, 2, 1},
+        {Opcode::Mod, 7, 2, 1},
+        {Opcode::FAdd, 8, 8, 1},
+        {Opcode::Less, 9, 5, 1},
+        {Opcode::GreaterEqual, 10, 5, 1},
+        {Opcode::NotEqual, 11, 1, 1},
+        {Opcode::Mov, 12, 4, 0},
+        {Opcode::Neg, 13, 12, 0},
+        {Opcode::Inc, 14, 0, 0},
+        {Opcode::Cmp, 5, 1, 0},
+        {Opcode::JumpIfPositive, 0, 0, 0},
+        {Opcode::Dec, 0, 0, 0},
+        {Opcode::JumpIfNotZero, 3, 0, 0},
+        {Opcode::Halt, 0, 0, 0},
+    });
+    assert(run_both(p).has_value());
+  }
+
+  // Call/Ret, stack traffic, memory load/store across segments.
+  {
+    auto p = make({
+        {Opcode::LoadImm, 0, 6, 0},
+        {Opcode::LoadImm, 1, 42, 0},
+        {Opcode::Call, 0, 0, 0},
+        {Opcode::Store, 300, 1, 0},
+        {Opcode::Load, 2, 300, 0},
+        {Opcode::Halt, 0, 0, 0},
+        {Opcode::Push, 1, 0, 0},
+        {Opcode::Pop, 3, 0, 0},
+        {Opcode::Store, 1, 3, 0},
+        {Opcode::Jump, 10, 0, 0},
+        {Opcode::Nop, 0, 0, 0},
+        {Opcode::Ret, 0, 0, 0},
+    });
+    assert(run_both(p).has_value());
+  }
+
+  // Mixed hot/cold opcodes route through the reference handlers.
+  {
+    auto p = make({
+        {Opcode::LoadImm, 1, 9, 0},
+        {Opcode::MakeOptionSome, 2, 1, 0},
+        {Opcode::OptionUnwrap, 3, 2, 0},
+        {Opcode::Add, 4, 3, 1},
+        {Opcode::StackAlloc, 5, 8, 0},
+        {Opcode::StackFree, 5, 8, 0},
+        {Opcode::Halt, 0, 0, 0},
+    });
+    assert(run_both(p).has_value());
+  }
+
+  // Fault paths must produce identical trap entries and payloads.
+  {
+    const auto div = run_both(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Div, 2, 0, 1}, {Opcode::Halt, 0, 0, 0}}));
+    assert(!div.has_value() && div.error() == vm::Trap::DivisionFault);
+
+    const auto load = run_both(make({{Opcode::Load, 1, 99999, 0}, {Opcode::Halt, 0, 0, 0}}));
+    assert(!load.has_value() && load.error() == vm::Trap::BoundsFault);
+
+    const auto pop = run_both(make({{Opcode::Pop, 1, 0, 0}, {Opcode::Halt, 0, 0, 0}}));
+    assert(!pop.has_value() && pop.error() == vm::Trap::StackFault);
+
+    const auto ret = run_both(make({{Opcode::Ret, 0, 0, 0}}));
+    assert(!ret.has_value() && ret.error() == vm::Trap::StackFault);
+
+    const auto call = run_both(make({{Opcode::LoadImm, 0, 77, 0}, {Opcode::Call, 0, 0, 0}}));
+    assert(!call.has_value() && call.error() == vm::Trap::DecodeFault);
+
+    const auto fall_off = run_both(make({{Opcode::LoadImm, 0, 5, 0}, {Opcode::Inc, 0, 0, 0}}));
+    assert(!fall_off.has_value() && fall_off.error() == vm::Trap::DecodeFault);
+
+    const auto invalid = run_both(make({{Opcode::LoadImm, 999, 1, 0}, {Opcode::Halt, 0, 0, 0}}));
+    assert(!invalid.has_value() && invalid.error() == vm::Trap::DecodeFault);
+  }
+
+  // Step budget exhaustion and resumption.
+  {
+    auto p = make({
+        {Opcode::LoadImm, 0, 50, 0},
+        {Opcode::Dec, 0, 0, 0},
+        {Opcode::JumpIfNotZero, 1, 0, 0},
+        {Opcode::Halt, 0, 0, 0},
+    });
+    const auto exhausted = run_both(p, 10);
+    assert(!exhausted.has_value() && exhausted.error() == vm::Trap::TrapInstruction);
+
+    auto ref = vm::make_interpreter_vm();
+    auto acc = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+    ref->load_program(p);
+    acc->load_program(p);
+    assert(!ref->run_to_halt(10).has_value());
+    assert(!acc->run_to_halt(10).has_value());
+    assert(acc->step().has_value());
+    assert(ref->step().has_value());
+    assert(ref->run_to_halt().has_value());
+    assert(acc->run_to_halt().has_value());
+    assert_same_state(ref->state(), acc->state());
+  }
+
+  return 0;
+}
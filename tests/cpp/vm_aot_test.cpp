@@ -0,0 +1,128 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine_parity.hpp"
+#include "t81/vm/aot.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+namespace {
+
+std::shared_ptr<const vm::AotModule> build(const tisc::Program& program, const std::string& name) {
+  const std::string path = "build/vm_aot_test_" + name + ".so";
+  const auto built = vm::compile_aot(program, path);
+  assert(built.ok);
+  auto opened = vm::AotModule::open(path);
+  assert(opened.ok && opened.module != nullptr);
+  assert(opened.module->matches(program));
+  return opened.module;
+}
+
+// Runs `program` under the interpreter and from `module`, `chunk` steps at a time.
+void check(const tisc::Program& program, const std::shared_ptr<const vm::AotModule>& module,
+           vm::VmOptions options, std::size_t chunk, std::size_t total) {
+  options.mode = vm::ExecutionMode::Aot;
+  options.aot_module = module;
+  check_against_interpreter(program, options, chunk, total);
+}
+
+void check_all(const tisc::Program& program, const std::shared_ptr<const vm::AotModule>& module,
+               std::size_t total) {
+  const std::vector<vm::VmOptions> configs = {
+      {.trace = vm::TraceLevel::Full},
+      {.trace = vm::TraceLevel::Digest},
+      {.trace = vm::TraceLevel::None},
+      {.trace = vm::TraceLevel::FlightRecorder, .flight_recorder_depth = 5},
+      {.trace = vm::TraceLevel::None, .axion_log = vm::AxionLogLevel::Off},
+  };
+  for (const auto& options : configs) {
+    for (std::size_t chunk : {std::size_t{1}, std::size_t{3}, std::size_t{7}, total}) {
+      check(program, module, options, chunk, total);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  // The generated source is self-contained and names its program.
+  const auto loop = make({
+      {Opcode::LoadImm, 0, 40, 0},
+      {Opcode::LoadImm, 1, 1, 0},
+      {Opcode::LoadImm, 5, INT64_MIN, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Store, 400, 2, 0},
+      {Opcode::Push, 2, 0, 0},
+      {Opcode::Pop, 3, 0, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 3, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  const auto source = vm::emit_cpp(loop);
+  assert(source.find("t81aot_fingerprint") != std::string::npos);
+  assert(source.find(std::to_string(vm::program_fingerprint(loop))) != std::string::npos);
+  assert(source.find("#include \"t81") == std::string::npos);
+
+  const auto loop_module = build(loop, "loop");
+  check_all(loop, loop_module, 400);
+
+  // Untraced runs iterate the loop natively; budgets still end on the exact step.
+  auto long_loop = loop;
+  long_loop.insns[0].b = 3000;
+  assert(!loop_module->matches(long_loop));
+  const auto long_module = build(long_loop, "long_loop");
+  for (std::size_t chunk : {std::size_t{1000}, std::size_t{4097}, std::size_t{100000}}) {
+    check(long_loop, long_module, {.trace = vm::TraceLevel::None}, chunk, 30000);
+    check(long_loop, long_module, {.trace = vm::TraceLevel::Digest}, chunk, 30000);
+  }
+
+  // Scalar arithmetic, ternary logic, a tag-copying Mov, faults that leave native code
+  // (division by zero after the loop) and a Call/Ret pair run by the handlers.
+  const auto mixed = make({
+      {Opcode::LoadImm, 0, 6, 0},
+      {Opcode::LoadImm, 1, -3, 0},
+      {Opcode::LoadImm, 2, 5, 0},
+      {Opcode::Add, 3, 3, 2},
+      {Opcode::Mul, 4, 3, 1},
+      {Opcode::Mod, 6, 4, 0},
+      {Opcode::Neg, 7, 6, 0},
+      {Opcode::TXor, 10, 7, 1},
+      {Opcode::TNot, 11, 10, 0},
+      {Opcode::GreaterEqual, 12, 4, 3},
+      {Opcode::Mov, 14, 40, 0},
+      {Opcode::Cmp, 12, 3, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfPositive, 3, 0, 0},
+      {Opcode::LoadImm, 16, 18, 0},
+      {Opcode::Call, 16, 0, 0},
+      {Opcode::Div, 5, 4, 0},
+      {Opcode::Halt, 0, 0, 0},
+      {Opcode::Inc, 17, 0, 0},
+      {Opcode::Ret, 0, 0, 0},
+  });
+  const auto mixed_module = build(mixed, "mixed");
+  check_all(mixed, mixed_module, 200);
+
+  // A module only runs the program it was built from; anything else takes the
+  // pre-decoded engine and still matches the interpreter.
+  assert(!mixed_module->matches(loop));
+  check(loop, mixed_module, {.trace = vm::TraceLevel::Full}, 50, 400);
+  assert(vm::program_fingerprint(long_loop) != vm::program_fingerprint(loop));
+
+  // Modules are shared: the library stays loaded while a VM still uses it.
+  auto holder = vm::make_vm({.mode = vm::ExecutionMode::Aot, .aot_module = build(loop, "shared")});
+  holder->load_program(loop);
+  assert(holder->run_to_halt(100000).has_value());
+
+  const auto missing = vm::AotModule::open("build/vm_aot_test_missing.so");
+  assert(!missing.ok && missing.module == nullptr && !missing.error.empty());
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns, std::string policy = {}) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  p.axion_policy_text = std::move(policy);
+  return p;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  static_assert(std::is_trivially_copyable_v<vm::AxionEvent>);
+  static_assert(sizeof(vm::AxionEvent) <= 32);
+
+  // Events carry structured fields; reason() renders the stable text on demand.
+  {
+    auto machine = vm::make_interpreter_vm();
+    machine->load_program(make(
+        {
+            {Opcode::LoadImm, 1, -5, 0},
+            {Opcode::AxSet, 2, 1, 0},
+            {Opcode::Store, 300, 1, 0},
+            {Opcode::Load, 3, 99999, 0},
+        },
+        "(policy (tier 2))"));
+    assert(!machine->run_to_halt().has_value());
+    const auto& log = machine->state().axion_log;
+    assert(log.size() == 3);
+
+    assert(log[0].code == vm::AxionReason::Guard);
+    assert(log[0].opcode == Opcode::AxSet);
+    assert(log[0].has_value && log[0].value == -5);
+    assert(!log[0].denied);
+    assert(log[0].reason() == "AxSet guard segment=code addr=0 value=-5 allow");
+
+    assert(log[1].code == vm::AxionReason::SegmentAccess);
+    assert(log[1].segment == vm::MemorySegmentKind::Heap);
+    assert(log[1].reason() == "segment access heap");
+
+    assert(log[2].code == vm::AxionReason::BoundsFault);
+    assert(log[2].action == vm::AxionAction::MemoryLoad);
+    assert(log[2].addr == 99999);
+    assert(log[2].reason() == "bounds fault segment=unknown addr=99999 action=memory load");
+  }
+
+  // NoSegmentAccess drops exactly the per-access events; Off drops everything.
+  const auto program = make({
+      {Opcode::LoadImm, 0, 10, 0},
+      {Opcode::StackAlloc, 1, 4, 0},
+      {Opcode::Store, 300, 0, 0},
+      {Opcode::StackFree, 1, 4, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 1, 0, 0},
+      {Opcode::Pop, 2, 0, 0},
+  });
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    auto all = vm::make_vm({.mode = mode});
+    auto filtered = vm::make_vm({.mode = mode, .axion_log = vm::AxionLogLevel::NoSegmentAccess});
+    auto off = vm::make_vm({.mode = mode, .axion_log = vm::AxionLogLevel::Off});
+    for (auto* machine : {all.get(), filtered.get(), off.get()}) {
+      machine->load_program(program);
+      assert(!machine->run_to_halt().has_value());
+    }
+
+    std::vector<std::string> expected;
+    for (const auto& e : all->state().axion_log) {
+      if (e.code != vm::AxionReason::SegmentAccess) {
+        expected.push_back(e.reason());
+      }
+    }
+    assert(expected.size() < all->state().axion_log.size());
+    assert(expected.back().ends_with("action=stack pop"));
+    assert(filtered->state().axion_log.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      assert(filtered->state().axion_log[i].reason() == expected[i]);
+    }
+    assert(off->state().axion_log.empty());
+
+    // The Axion log is outside STATE_HASH, so every level hashes the same.
+    assert(vm::state_hash(filtered->state()) == vm::state_hash(all->state()));
+    assert(vm::state_hash(off->state()) == vm::state_hash(all->state()));
+  }
+
+  return 0;
+}
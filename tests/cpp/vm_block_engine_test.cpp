@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstddef>
+
+#include "engine_parity.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+int main() {
+  using tisc::Opcode;
+
+  // Both modes, in chunks of `chunk` steps, match after every chunk, so budgets end at
+  // every offset within every block.
+  const auto check_blocks = [](const tisc::Program& program, std::size_t chunk, std::size_t total) {
+    check_against_interpreter(program, {.mode = vm::ExecutionMode::AcceleratedPreview}, chunk, total);
+  };
+
+  // A long straight-line block feeding a self-looping block (the final JumpIfNotZero
+  // targets its own block's leader) and a register-indirect call into mid-block.
+  const auto loops = make({
+      {Opcode::LoadImm, 0, 40, 0},
+      {Opcode::LoadImm, 1, 3, 0},
+      {Opcode::LoadImm, 2, 0, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Mul, 3, 2, 1},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 3, 0, 0},
+      {Opcode::LoadImm, 5, 12, 0},
+      {Opcode::Call, 5, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+      {Opcode::Inc, 4, 0, 0},
+      {Opcode::Inc, 4, 0, 0},
+      {Opcode::LoadImm, 6, 12, 0},
+      {Opcode::Ret, 0, 0, 0},
+  });
+  for (std::size_t chunk = 1; chunk <= 9; ++chunk) {
+    check_blocks(loops, chunk, 400);
+  }
+  check_blocks(loops, 100000, 100000);
+
+  // A trap in the middle of a block stops the block with the reference payload, and a
+  // program that runs off the end traps through the sentinel block.
+  const auto faults = make({
+      {Opcode::LoadImm, 0, 7, 0},
+      {Opcode::LoadImm, 1, 0, 0},
+      {Opcode::Add, 2, 0, 0},
+      {Opcode::Div, 3, 0, 1},
+      {Opcode::Add, 2, 2, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  for (std::size_t chunk = 1; chunk <= 6; ++chunk) {
+    check_blocks(faults, chunk, 12);
+  }
+  check_blocks(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Inc, 0, 0, 0}}), 1, 4);
+  check_blocks(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Inc, 0, 0, 0}}), 10, 10);
+
+  // Single steps interleave with block runs.
+  auto ref = vm::make_vm({.mode = vm::ExecutionMode::Interpreter});
+  auto blocks = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+  ref->load_program(loops);
+  blocks->load_program(loops);
+  for (int i = 0; i < 5; ++i) {
+    assert(ref->step().has_value() && blocks->step().has_value());
+    assert(ref->run_to_halt(7).has_value() == blocks->run_to_halt(7).has_value());
+  }
+  assert(ref->run_to_halt().has_value() && blocks->run_to_halt().has_value());
+  assert(observe(*ref) == observe(*blocks));
+
+  return 0;
+}
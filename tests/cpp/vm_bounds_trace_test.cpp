@@ -8,7 +8,7 @@
 
 static bool contains_reason(const t81::vm::State& state, std::string_view needle) {
   for (const auto& e : state.axion_log) {
-    if (e.reason.find(needle) != std::string::npos) {
+    if (e.reason().find(needle) != std::string::npos) {
       return true;
     }
   }
@@ -0,0 +1,97 @@
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+void assert_same_machine(const vm::State& a, const vm::State& b) {
+  assert(a.pc == b.pc);
+  assert(a.halted == b.halted);
+  assert(a.gc_cycles == b.gc_cycles);
+  assert(a.registers == b.registers);
+  assert(a.register_tags == b.register_tags);
+  assert(a.memory == b.memory);
+  assert(a.sp == b.sp);
+  assert(a.flags.zero == b.flags.zero);
+  assert(a.flags.negative == b.flags.negative);
+  assert(a.flags.positive == b.flags.positive);
+  assert(vm::trap_payload_summary_line(a) == vm::trap_payload_summary_line(b));
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  const auto loop = make({
+      {Opcode::LoadImm, 0, 300, 0},
+      {Opcode::LoadImm, 1, 2, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Store, 400, 2, 0},
+      {Opcode::StackAlloc, 3, 4, 0},
+      {Opcode::StackFree, 3, 4, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  const auto fault = make({
+      {Opcode::LoadImm, 0, 0, 0},
+      {Opcode::Store, 400, 0, 0},
+      {Opcode::Div, 1, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    for (const auto* program : {&loop, &fault}) {
+      auto full = vm::make_vm({.mode = mode});
+      auto no_trace = vm::make_vm({.mode = mode, .trace = vm::TraceLevel::None});
+      auto no_axion = vm::make_vm({.mode = mode, .axion_log = vm::AxionLogLevel::Off});
+      auto bare = vm::make_vm({.mode = mode, .trace = vm::TraceLevel::None, .axion_log = vm::AxionLogLevel::Off});
+
+      full->load_program(*program);
+      no_trace->load_program(*program);
+      no_axion->load_program(*program);
+      bare->load_program(*program);
+      const auto r_full = full->run_to_halt();
+      const auto r_no_trace = no_trace->run_to_halt();
+      const auto r_no_axion = no_axion->run_to_halt();
+      const auto r_bare = bare->run_to_halt();
+      assert(r_full.has_value() == (program == &loop));
+      assert(r_full == r_no_trace && r_full == r_no_axion && r_full == r_bare);
+
+      assert_same_machine(full->state(), no_trace->state());
+      assert_same_machine(full->state(), no_axion->state());
+      assert_same_machine(full->state(), bare->state());
+      assert(full->state().gc_cycles > 0 || program == &fault);
+
+      // Disabling the trace drops trace storage and the published STATE_HASH line.
+      assert(!full->state().trace.empty());
+      assert(no_trace->state().trace.empty());
+      assert(no_trace->state().trace_level == vm::TraceLevel::None);
+      assert(vm::snapshot_summary(full->state()).find("STATE_HASH") != std::string::npos);
+      assert(vm::snapshot_summary(no_trace->state()).find("STATE_HASH") == std::string::npos);
+      assert(no_trace->state().axion_log.size() == full->state().axion_log.size());
+
+      // The Axion log is not part of STATE_HASH, so disabling it keeps the hash stable.
+      assert(!full->state().axion_log.empty());
+      assert(no_axion->state().axion_log.empty());
+      assert(bare->state().axion_log.empty());
+      assert(vm::state_hash(no_axion->state()) == vm::state_hash(full->state()));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  const auto program = make({
+      {Opcode::LoadImm, 0, 200, 0},
+      {Opcode::LoadImm, 1, 3, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Load, 3, 99999, 0},
+  });
+
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    auto full = vm::make_vm({.mode = mode});
+    full->load_program(program);
+    assert(!full->run_to_halt().has_value());
+    const auto& trace = full->state().trace;
+
+    for (const std::size_t depth : {std::size_t{1}, std::size_t{16}, std::size_t{5000}}) {
+      auto recorder = vm::make_vm({.mode = mode, .trace = vm::TraceLevel::FlightRecorder, .flight_recorder_depth = depth});
+      recorder->load_program(program);
+      assert(!recorder->run_to_halt().has_value());
+      const auto& s = recorder->state();
+
+      // The ring holds exactly the tail of the full trace, ending with the trap entry.
+      const auto& ring = s.flight_recorder;
+      assert(s.trace.empty());
+      assert(ring.depth() == depth);
+      assert(ring.recorded() == trace.size());
+      assert(ring.size() == std::min(depth, trace.size()));
+      const std::size_t first = trace.size() - ring.size();
+      for (std::size_t i = 0; i < ring.size(); ++i) {
+        assert(vm::trace_line(ring[i]) == vm::trace_line(trace[first + i]));
+      }
+      assert(ring[ring.size() - 1].trap == vm::Trap::BoundsFault);
+
+      // The digest still covers every step, so STATE_HASH_V2 matches the full run.
+      assert(vm::state_hash(s, vm::StateHashVersion::V2) ==
+             vm::state_hash(full->state(), vm::StateHashVersion::V2));
+      assert(vm::snapshot_summary(s).find("STATE_HASH_V2 0x") != std::string::npos);
+
+      const auto dump = vm::flight_recorder_dump(s);
+      const auto header = "FLIGHT_RECORDER depth=" + std::to_string(depth) + " recorded=" +
+                          std::to_string(trace.size()) + " kept=" + std::to_string(ring.size()) + "\n";
+      assert(dump.rfind(header, 0) == 0);
+      assert(dump.size() > header.size());
+      assert(dump.substr(dump.size() - vm::trace_line(trace.back()).size() - 1) ==
+             vm::trace_line(trace.back()) + "\n");
+
+      // Reloading clears the ring without changing its depth.
+      recorder->load_program(program);
+      assert(recorder->state().flight_recorder.empty());
+      assert(recorder->state().flight_recorder.depth() == depth);
+    }
+  }
+
+  // Other trace levels have no flight-recorder dump.
+  {
+    auto full = vm::make_interpreter_vm();
+    full->load_program(program);
+    assert(!full->run_to_halt().has_value());
+    assert(vm::flight_recorder_dump(full->state()).empty());
+    assert(full->state().flight_recorder.empty());
+  }
+
+  return 0;
+}
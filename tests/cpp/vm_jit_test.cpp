@@ -0,0 +1,151 @@
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "engine_parity.hpp"
+#include "t81/vm/jit.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+namespace {
+
+// Runs `program` under the interpreter and the JIT with the same options, `chunk` steps
+// at a time, with register 40 holding a host-written OptionHandle in both.
+void check(const tisc::Program& program, vm::VmOptions options, std::size_t chunk, std::size_t total) {
+  options.mode = vm::ExecutionMode::Interpreter;
+  auto ref = vm::make_vm(options);
+  options.mode = vm::ExecutionMode::Jit;
+  auto jit = vm::make_vm(options);
+  ref->load_program(program);
+  jit->load_program(program);
+  ref->set_register(40, 9, vm::ValueTag::OptionHandle);
+  jit->set_register(40, 9, vm::ValueTag::OptionHandle);
+  run_lockstep(*ref, *jit, chunk, total);
+}
+
+void check_all(const tisc::Program& program, std::size_t total) {
+  const std::vector<vm::VmOptions> configs = {
+      {.trace = vm::TraceLevel::Full},
+      {.trace = vm::TraceLevel::Digest},
+      {.trace = vm::TraceLevel::None},
+      {.trace = vm::TraceLevel::FlightRecorder, .flight_recorder_depth = 5},
+      {.trace = vm::TraceLevel::None, .axion_log = vm::AxionLogLevel::NoSegmentAccess},
+      {.trace = vm::TraceLevel::Full, .axion_log = vm::AxionLogLevel::Off},
+  };
+  for (const auto& options : configs) {
+    for (std::size_t chunk : {std::size_t{1}, std::size_t{2}, std::size_t{3}, std::size_t{7}, total}) {
+      check(program, options, chunk, total);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  // Scalar arithmetic, ternary logic, comparisons, memory and a tag-copying Mov in one
+  // self-looping block, followed by a Call/Ret pair that runs through the handlers.
+  const auto mixed = make({
+      {Opcode::LoadImm, 0, 6, 0},
+      {Opcode::LoadImm, 1, -3, 0},
+      {Opcode::LoadImm, 2, 5, 0},
+      {Opcode::Add, 3, 3, 2},
+      {Opcode::Mul, 4, 3, 1},
+      {Opcode::Div, 5, 4, 2},
+      {Opcode::Mod, 6, 4, 0},
+      {Opcode::Neg, 7, 6, 0},
+      {Opcode::TAnd, 8, 1, 2},
+      {Opcode::TOr, 9, 7, 0},
+      {Opcode::TXor, 10, 9, 1},
+      {Opcode::TNot, 11, 10, 0},
+      {Opcode::Less, 12, 4, 3},
+      {Opcode::Store, 300, 4, 0},
+      {Opcode::Load, 13, 300, 0},
+      {Opcode::Mov, 14, 40, 0},
+      {Opcode::Push, 3, 0, 0},
+      {Opcode::Pop, 15, 0, 0},
+      {Opcode::Cmp, 15, 3, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 3, 0, 0},
+      {Opcode::LoadImm, 16, 24, 0},
+      {Opcode::Call, 16, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+      {Opcode::Inc, 17, 0, 0},
+      {Opcode::Ret, 0, 0, 0},
+  });
+  check_all(mixed, 200);
+
+  // Faults inside native segments leave before touching state and trap through the
+  // reference path: division by zero, stack overflow from a pushing loop, and
+  // underflow from a Pop on an empty stack.
+  check_all(make({
+                {Opcode::LoadImm, 0, 7, 0},
+                {Opcode::LoadImm, 1, 0, 0},
+                {Opcode::Add, 2, 0, 0},
+                {Opcode::Div, 3, 0, 1},
+                {Opcode::Halt, 0, 0, 0},
+            }),
+            8);
+  check_all(make({
+                {Opcode::Inc, 0, 0, 0},
+                {Opcode::Push, 0, 0, 0},
+                {Opcode::Jump, 0, 0, 0},
+            }),
+            100000);
+  check_all(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Pop, 1, 0, 0}, {Opcode::Halt, 0, 0, 0}}), 4);
+  check_all(make({
+                {Opcode::LoadImm, 1, 4, 0},
+                {Opcode::Jump, 2, 0, 0},
+                {Opcode::Div, 2, 1, 0},
+                {Opcode::Halt, 0, 0, 0},
+            }),
+            6);
+
+  // A program that runs off the end traps after its last native segment.
+  check_all(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Inc, 0, 0, 0}}), 4);
+
+  // A long single-block loop: native passes repeat inside one call while the budget
+  // allows, and the budget cut still lands on the exact instruction.
+  const auto loop = make({
+      {Opcode::LoadImm, 0, 5000, 0},
+      {Opcode::LoadImm, 1, 1, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Store, 400, 2, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  for (std::size_t chunk : {std::size_t{1000}, std::size_t{4097}, std::size_t{100000}}) {
+    check(loop, {.trace = vm::TraceLevel::None}, chunk, 100000);
+    check(loop, {.trace = vm::TraceLevel::Digest}, chunk, 100000);
+  }
+
+  // Single steps interleave with native runs.
+  auto ref = vm::make_vm({.mode = vm::ExecutionMode::Interpreter});
+  auto jit = vm::make_vm({.mode = vm::ExecutionMode::Jit});
+  ref->load_program(mixed);
+  jit->load_program(mixed);
+  for (int i = 0; i < 6; ++i) {
+    assert(ref->step().has_value() && jit->step().has_value());
+    assert(ref->run_to_halt(11).has_value() == jit->run_to_halt(11).has_value());
+  }
+  assert(ref->run_to_halt().has_value() && jit->run_to_halt().has_value());
+  assert(observe(*ref) == observe(*jit));
+
+  // Segments are the compilable runs of each basic block; Halt is left to the handlers.
+  if (vm::jit::available()) {
+    auto probe = vm::make_interpreter_vm();
+    probe->load_program(loop);
+    vm::jit::NativeProgram native;
+    native.compile(loop, probe->state(), false);
+    assert(native.segment_at(0) != nullptr && native.segment_at(0)->length == 2);
+    const auto* body = native.segment_at(2);
+    assert(body != nullptr && body->length == 4 && body->stores);
+    assert(native.segment_at(3) == nullptr && native.segment_at(6) == nullptr);
+    assert(native.max_length() == 4);
+  }
+  return 0;
+}
@@ -0,0 +1,220 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "t81/tisc/opcodes.hpp"
+#include "t81/vm/program_io.hpp"
+
+using namespace t81;
+
+namespace {
+
+// The regex-based TISC JSON V1 loader the tokenizer replaced, kept as the grammar
+// oracle. Opcodes are resolved by the real loader through a one-line Text V1 file.
+struct Reference {
+  bool ok = false;
+  std::string error;
+  std::string policy;
+  std::vector<std::string> opnames;
+  std::vector<std::int64_t> operands;
+};
+
+bool ref_int_field(const std::string& obj, const std::string& key, std::int64_t* out) {
+  const std::regex re("\\\"" + key + "\\\"\\s*:\\s*(-?[0-9]+)");
+  std::smatch m;
+  if (!std::regex_search(obj, m, re) || m.size() < 2) {
+    return false;
+  }
+  try {
+    *out = std::stoll(m[1].str());
+  } catch (const std::out_of_range&) {
+    return false;
+  }
+  return true;
+}
+
+bool ref_string_field(const std::string& obj, const std::string& key, std::string* out) {
+  const std::regex re("\\\"" + key + "\\\"\\s*:\\s*\\\"([^\\\"]*)\\\"");
+  std::smatch m;
+  if (!std::regex_search(obj, m, re) || m.size() < 2) {
+    return false;
+  }
+  *out = m[1].str();
+  return true;
+}
+
+std::size_t ref_close(const std::string& s, std::size_t open, char o, char c) {
+  int depth = 0;
+  for (std::size_t i = open; i < s.size(); ++i) {
+    if (s[i] == o) {
+      ++depth;
+    } else if (s[i] == c && --depth == 0) {
+      return i;
+    }
+  }
+  return std::string::npos;
+}
+
+Reference reference_load(const std::string& s) {
+  Reference out;
+  (void)ref_string_field(s, "axion_policy_text", &out.policy);
+  const auto insns_pos = s.find("\"insns\"");
+  if (insns_pos == std::string::npos) {
+    out.error = "missing insns array";
+    return out;
+  }
+  const auto lb = s.find('[', insns_pos);
+  if (lb == std::string::npos) {
+    out.error = "invalid insns array";
+    return out;
+  }
+  const auto rb = ref_close(s, lb, '[', ']');
+  if (rb == std::string::npos) {
+    out.error = "unterminated insns array";
+    return out;
+  }
+  const std::string body = s.substr(lb + 1, rb - lb - 1);
+  for (std::size_t ob = body.find('{'); ob != std::string::npos; ob = body.find('{', ob)) {
+    const auto cb = ref_close(body, ob, '{', '}');
+    if (cb == std::string::npos) {
+      out.error = "unterminated insn object";
+      return out;
+    }
+    const std::string obj = body.substr(ob, cb - ob + 1);
+    std::string opname;
+    if (!ref_string_field(obj, "opcode", &opname)) {
+      out.error = "missing opcode in insn object";
+      return out;
+    }
+    out.opnames.push_back(opname);
+    std::int64_t a = 0;
+    std::int64_t b = 0;
+    std::int64_t c = 0;
+    if (!ref_int_field(obj, "a", &a) || !ref_int_field(obj, "b", &b) || !ref_int_field(obj, "c", &c)) {
+      out.error = "insn object requires integer fields a,b,c";
+      return out;
+    }
+    out.operands.insert(out.operands.end(), {a, b, c});
+    ob = cb + 1;
+  }
+  if (out.opnames.empty()) {
+    out.error = "insns array is empty";
+    return out;
+  }
+  out.ok = true;
+  return out;
+}
+
+vm::ProgramLoadResult load(const std::filesystem::path& path, const std::string& text) {
+  {
+    std::ofstream out(path, std::ios::binary);
+    assert(out.good());
+    out << text;
+  }
+  return vm::load_program_from_file(path.string());
+}
+
+// Agreement on outcome, message, policy and every decoded instruction. The oracle does
+// not resolve opcode names: each one it read is checked by loading it as Text V1, and an
+// unknown one must be where the loader stopped.
+void expect_same(const std::filesystem::path& dir, const std::string& text) {
+  const auto got = load(dir / "t81_vm_json_loader_test.json", text);
+  const auto want = reference_load(text);
+  assert(got.format == vm::ProgramFormat::TiscJsonV1);
+  assert(got.program.axion_policy_text == want.policy);
+  const std::size_t decoded = got.program.insns.size();
+  assert(decoded <= want.opnames.size());
+  for (std::size_t i = 0; i < decoded; ++i) {
+    const auto& insn = got.program.insns[i];
+    const auto as_text = load(dir / "t81_vm_json_loader_test.t81vm", want.opnames[i] + " 0 0 0\n");
+    assert(as_text.ok && as_text.program.insns[0].opcode == insn.opcode);
+    assert(insn.a == want.operands[3 * i] && insn.b == want.operands[3 * i + 1] && insn.c == want.operands[3 * i + 2]);
+  }
+  if (!got.ok && got.error.rfind("unknown opcode in json program: ", 0) == 0) {
+    assert(decoded < want.opnames.size());
+    assert(got.error == "unknown opcode in json program: " + want.opnames[decoded]);
+    return;
+  }
+  assert(got.ok == want.ok);
+  assert(got.error == want.error);
+  assert(!got.ok || decoded == want.opnames.size());
+}
+
+std::string random_document(std::mt19937_64* rng) {
+  static const std::vector<std::string> kPieces = {
+      "{",  "}",  "[",  "]",  "\"",  ",",  ":",  " ",  "\n", "-",  "0",  "7",  "42", "-13",
+      "\"a\"", "\"b\"", "\"c\"", "\"opcode\"", "\"insns\"", "\"axion_policy_text\"", "\"Halt\"",
+      "\"load_imm\"", "\"JMP\"", "\"Bogus\"", "\"a\": 5", "\"b\" :\t-2", "\"c\":0", "\"opcode\": \"Add\"",
+      "99999999999999999999", "\"note\": \"}\"", "{\"a\": 1}",
+  };
+  std::uniform_int_distribution<int> count_dist(0, 6);
+  std::uniform_int_distribution<std::size_t> piece_dist(0, kPieces.size() - 1);
+  std::uniform_int_distribution<int> insn_dist(1, 5);
+  std::string out = "{\"format_version\": \"tisc-json-v1\", \"axion_policy_text\": \"(policy (tier 1))\", \"insns\": [";
+  const int insns = insn_dist(*rng);
+  for (int i = 0; i < insns; ++i) {
+    out += i == 0 ? "" : ", ";
+    out += "{\"opcode\": \"LoadImm\", \"a\": " + std::to_string(i) + ", \"b\": -" + std::to_string(i * 3) + ", \"c\": 0}";
+  }
+  out += "]}";
+  const int edits = count_dist(*rng);
+  for (int e = 0; e < edits; ++e) {
+    std::uniform_int_distribution<std::size_t> pos_dist(0, out.size());
+    const std::size_t pos = pos_dist(*rng);
+    if ((*rng)() % 3 == 0 && pos < out.size()) {
+      out.erase(pos, 1 + (*rng)() % 4);
+    } else {
+      out.insert(pos, kPieces[piece_dist(*rng)]);
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+int main() {
+  const auto dir = std::filesystem::temp_directory_path();
+
+  // Accepted shapes: fields in any order, spacing, aliases, nested and extra keys.
+  expect_same(dir, R"json({"format_version":"tisc-json-v1","axion_policy_text":"(policy (tier 2))",
+    "insns":[{"opcode":"LoadImm","a":0,"b":10,"c":0},{ "c" : 3 , "b":-4,"a" :1, "opcode" : "jnz" },
+             {"opcode":"Halt","a":0,"b":0,"c":0,"meta":{"a":9}}]})json");
+  const auto ok = load(dir / "t81_vm_json_loader_test.json",
+                       R"({"insns":[{"opcode":"make_enum-variant","a":-9223372036854775808,"b":9223372036854775807,"c":1}]})");
+  assert(ok.ok && ok.program.insns.size() == 1 && ok.program.insns[0].opcode == tisc::Opcode::MakeEnumVariant);
+  assert(ok.program.insns[0].a == INT64_MIN && ok.program.insns[0].b == INT64_MAX);
+
+  // Every error message.
+  for (const auto* text : {
+           R"({"program":[]})",
+           R"({"insns": 5})",
+           R"({"insns":[{"opcode":"Halt","a":0,"b":0,"c":0})",
+           R"({"insns":[{"opcode":"Halt","a":0,"b":0,"c":0]})",
+           R"({"insns":[{"a":0,"b":0,"c":0}]})",
+           R"({"insns":[{"opcode":"Halt","a":0,"b":0}]})",
+           R"({"insns":[{"opcode":"Halt","a":0,"b":"0","c":0}]})",
+           R"({"insns":[{"opcode":"Halt","a":0,"b":0,"c":99999999999999999999}]})",
+           R"({"insns":[]})",
+       }) {
+    expect_same(dir, text);
+  }
+  const auto unknown = load(dir / "t81_vm_json_loader_test.json", R"({"insns":[{"opcode":"Frobnicate","a":0,"b":0,"c":0}]})");
+  assert(!unknown.ok && unknown.error == "unknown opcode in json program: Frobnicate");
+
+  // Randomized agreement with the regex grammar.
+  std::mt19937_64 rng(0x15C0DE5EEDULL);
+  for (int i = 0; i < 400; ++i) {
+    expect_same(dir, random_document(&rng));
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(dir / "t81_vm_json_loader_test.json", ec);
+  std::filesystem::remove(dir / "t81_vm_json_loader_test.t81vm", ec);
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include <cassert>
+#include <cstddef>
+
+#include "engine_parity.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+int main() {
+  using tisc::Opcode;
+
+  // Conditional jumps before any flag setter see the all-clear initial flags; afterwards
+  // they see the last producer, whichever of zero/negative/positive it set. Every engine
+  // exposes the interpreter's flags after each budget chunk.
+  const auto program = make({
+      {Opcode::JumpIfZero, 9, 0, 0},
+      {Opcode::JumpIfNegative, 9, 0, 0},
+      {Opcode::LoadImm, 0, 3, 0},
+      {Opcode::LoadImm, 1, -2, 0},
+      {Opcode::Add, 1, 1, 0},
+      {Opcode::JumpIfNegative, 9, 0, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfPositive, 4, 0, 0},
+      {Opcode::JumpIfNotZero, 9, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  for (const auto mode : {vm::ExecutionMode::AcceleratedPreview, vm::ExecutionMode::Jit, vm::ExecutionMode::Tiered}) {
+    for (std::size_t chunk : {std::size_t{1}, std::size_t{2}, std::size_t{5}, std::size_t{100}}) {
+      check_against_interpreter(program, {.mode = mode, .tier_up_threshold = 2}, chunk, 100);
+    }
+  }
+
+  // step() and run_to_halt() both publish the flags of the last producer.
+  auto m = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+  m->load_program(program);
+  assert(!m->state().flags.zero && !m->state().flags.negative && !m->state().flags.positive);
+  for (int i = 0; i < 4; ++i) {
+    assert(m->step().has_value());
+  }
+  assert(m->state().flags.negative && !m->state().flags.zero);
+  (void)m->run_to_halt(1);
+  assert(m->state().flags.positive);
+  assert(m->run_to_halt().has_value());
+  assert(m->state().flags.zero);
+
+  // Reloading restores the initial flags.
+  m->load_program(program);
+  assert(!m->state().flags.zero && !m->state().flags.negative && !m->state().flags.positive);
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+// Hash of a copy whose page digests are all recomputed from scratch.
+std::uint64_t cold_hash(const vm::State& state) {
+  vm::State copy = state;
+  copy.memory_pages.invalidate_all();
+  return vm::state_hash(copy, vm::StateHashVersion::V2);
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  const auto program = make({
+      {Opcode::LoadImm, 0, 20, 0},
+      {Opcode::LoadImm, 1, 7, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Store, 300, 2, 0},
+      {Opcode::Push, 2, 0, 0},
+      {Opcode::Pop, 3, 0, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Store, 1000, 1, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    auto machine = vm::make_vm({.mode = mode, .trace = vm::TraceLevel::Digest});
+    machine->load_program(program);
+    const auto& s = machine->state();
+    assert(s.memory_pages.dirty_pages() == s.memory_pages.dirty.size());
+
+    // Incremental checkpoint hashes match a from-scratch recomputation at every step.
+    while (!s.halted) {
+      const auto incremental = vm::state_hash(s, vm::StateHashVersion::V2);
+      assert(s.memory_pages.dirty_pages() == 0);
+      assert(incremental == cold_hash(s));
+      assert(machine->step().has_value());
+      assert(s.memory_pages.dirty_pages() <= 1);
+    }
+    assert(vm::state_hash(s, vm::StateHashVersion::V2) == cold_hash(s));
+
+    // A single store dirties exactly the page holding its address.
+    assert(s.memory_pages.dirty_pages() == 0);
+    auto& mutable_state = const_cast<vm::State&>(s);
+    mutable_state.memory[1000] = 5;
+    mutable_state.memory_pages.mark(1000);
+    assert(s.memory_pages.dirty_pages() == 1);
+    assert(s.memory_pages.dirty[1000 / vm::MemoryPages::kPageWords] == 1);
+    assert(vm::state_hash(s, vm::StateHashVersion::V2) == cold_hash(s));
+  }
+
+  // Full-trace and accelerated runs agree on V2 with memory writes in the mix.
+  {
+    auto ref = vm::make_interpreter_vm();
+    auto acc = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+    ref->load_program(program);
+    acc->load_program(program);
+    assert(ref->run_to_halt().has_value());
+    assert(acc->run_to_halt().has_value());
+    assert(vm::state_hash(ref->state(), vm::StateHashVersion::V2) ==
+           vm::state_hash(acc->state(), vm::StateHashVersion::V2));
+    assert(vm::state_hash(ref->state()) == vm::state_hash(acc->state()));
+  }
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "engine_parity.hpp"
+#include "t81/tisc/packed_code.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+namespace {
+
+bool same(const tisc::Insn& x, const tisc::Insn& y) {
+  return x.opcode == y.opcode && x.a == y.a && x.b == y.b && x.c == y.c;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+  constexpr std::int64_t kMax32 = std::numeric_limits<std::int32_t>::max();
+  constexpr std::int64_t kMin32 = std::numeric_limits<std::int32_t>::min();
+
+  // Every operand position can take the 32-bit field; two operands outside a byte, or
+  // one outside int32, go to the side table.
+  const std::vector<tisc::Insn> insns = {
+      {Opcode::Add, 1, 2, 3},
+      {Opcode::LoadImm, 4, -7, 0},
+      {Opcode::LoadImm, 5, kMax32, 0},
+      {Opcode::LoadImm, 6, kMin32, 0},
+      {Opcode::Store, 70000, 9, 0},
+      {Opcode::MakeEnumVariantPayload, 1, 2, 255},
+      {Opcode::EnumIsVariant, 1, 2, 256},
+      {Opcode::LoadImm, 7, kMax32 + 1, 0},
+      {Opcode::Store, 300, 256, 0},
+      {Opcode::LoadImm, 8, std::numeric_limits<std::int64_t>::min(), 0},
+      {Opcode::Halt, 0, 0, 0},
+  };
+  const tisc::PackedCode code(insns);
+  assert(code.size() == insns.size());
+  assert(code.wide_count() == 3);
+  for (std::size_t pc = 0; pc < insns.size(); ++pc) {
+    assert(same(code[pc], insns[pc]));
+    assert(code.opcode(pc) == insns[pc].opcode);
+  }
+
+  // Wide immediates leave their instruction (and any pair it would fuse with) on the
+  // reference path; results match the interpreter in every engine and step budget.
+  tisc::Program program;
+  program.insns = {
+      {Opcode::LoadImm, 0, 3, 0},
+      {Opcode::LoadImm, 1, kMax32 + 5, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::LoadImm, 3, kMin32 - 1, 0},
+      {Opcode::Sub, 2, 2, 3},
+      {Opcode::Store, 600, 2, 0},
+      {Opcode::Load, 4, 600, 0},
+      {Opcode::MakeEnumVariantPayload, 5, 4, kMax32 + 9},
+      {Opcode::EnumIsVariant, 6, 5, kMax32 + 9},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 1, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  };
+  for (const auto mode : {vm::ExecutionMode::AcceleratedPreview, vm::ExecutionMode::Jit, vm::ExecutionMode::Tiered}) {
+    for (const std::size_t chunk : {std::size_t{1}, std::size_t{3}, std::size_t{100}}) {
+      const auto other = check_against_interpreter(program, {.mode = mode, .tier_up_threshold = 1}, chunk, 1000);
+      assert(other->state().halted);
+      assert(other->state().registers[2] == 3 * ((kMax32 + 5) - (kMin32 - 1)));
+      assert(other->state().registers[6] == 1);
+    }
+  }
+  return 0;
+}
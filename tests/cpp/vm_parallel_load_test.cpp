@@ -0,0 +1,140 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/program_io.hpp"
+#include "t81/vm/validator.hpp"
+
+using namespace t81;
+
+namespace {
+
+bool same(const vm::ProgramLoadResult& x, const vm::ProgramLoadResult& y) {
+  if (x.ok != y.ok || x.error != y.error || x.format != y.format ||
+      x.program.axion_policy_text != y.program.axion_policy_text || x.program.insns.size() != y.program.insns.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < x.program.insns.size(); ++i) {
+    const auto& p = x.program.insns[i];
+    const auto& q = y.program.insns[i];
+    if (p.opcode != q.opcode || p.a != q.a || p.b != q.b || p.c != q.c) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Loads `text` on one thread and on several chunkings, which must all agree.
+vm::ProgramLoadResult load_everywhere(const std::filesystem::path& path, const std::string& text) {
+  {
+    std::ofstream out(path, std::ios::binary);
+    assert(out.good());
+    out << text;
+  }
+  const auto serial = vm::load_program_from_file(path.string(), {.threads = 1});
+  for (const std::size_t threads : {2, 3, 7, 16}) {
+    const auto chunked = vm::load_program_from_file(path.string(), {.threads = threads, .min_chunk_bytes = 1});
+    assert(same(chunked, serial));
+  }
+  return serial;
+}
+
+std::string text_program(std::size_t lines, std::optional<std::size_t> bad_line) {
+  std::string out;
+  for (std::size_t i = 0; i < lines; ++i) {
+    if (bad_line == i) {
+      out += "Frobnicate 1 2 3\n";
+    } else if (i % 97 == 0) {
+      out += "POLICY (policy (tier " + std::to_string(i % 5) + "))\r\n";
+    } else if (i % 13 == 0) {
+      out += "  # comment " + std::to_string(i) + "\n\n";
+    } else {
+      out += "LoadImm " + std::to_string(i % 243) + " " + std::to_string(i * 7) + " 0\n";
+    }
+  }
+  return out + "Halt";
+}
+
+std::string json_program(std::size_t objects, std::optional<std::size_t> bad_object, const std::string& bad) {
+  std::string out = "{\"format_version\": \"tisc-json-v1\", \"axion_policy_text\": \"(policy (tier 2))\",\n \"insns\": [\n";
+  for (std::size_t i = 0; i < objects; ++i) {
+    out += i == 0 ? "  " : ",} \n  ";
+    if (bad_object == i) {
+      out += bad;
+    } else {
+      out += "{\"opcode\": \"Add\", \"a\": " + std::to_string(i % 243) + ", \"b\": 1, \"c\": 2, \"meta\": {\"d\": [" +
+             std::to_string(i) + "]}}";
+    }
+  }
+  return out + "\n ]\n}\n";
+}
+
+}  // namespace
+
+int main() {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto text_path = dir / "t81_vm_parallel_load_test.t81vm";
+  const auto json_path = dir / "t81_vm_parallel_load_test.tisc.json";
+
+  // Text V1: chunk seams never split a line, the last POLICY wins and the first bad line
+  // is the reported one, wherever it falls.
+  auto loaded = load_everywhere(text_path, text_program(3000, std::nullopt));
+  assert(loaded.ok && loaded.program.axion_policy_text == "(policy (tier 0))");
+  assert(loaded.program.insns.back().opcode == tisc::Opcode::Halt);
+  for (const std::size_t bad : {0, 1, 96, 1500, 2998, 2999}) {
+    loaded = load_everywhere(text_path, text_program(3000, bad) + "\nAlsoBogus\n");
+    assert(!loaded.ok && loaded.error == "unknown opcode in text program: Frobnicate");
+  }
+  (void)load_everywhere(text_path, "");
+  (void)load_everywhere(text_path, "\n\n\nHalt 0 0 0");
+
+  // TISC JSON V1: each error kind, early and late, before a later different error.
+  loaded = load_everywhere(json_path, json_program(2000, std::nullopt, ""));
+  assert(loaded.ok && loaded.program.insns.size() == 2000);
+  for (const auto& bad : {
+           std::string("{\"a\": 0, \"b\": 0, \"c\": 0}"),
+           std::string("{\"opcode\": \"Bogus\", \"a\": 0, \"b\": 0, \"c\": 0}"),
+           std::string("{\"opcode\": \"Halt\", \"a\": 0, \"b\": 0}"),
+       }) {
+    for (const std::size_t at : {0, 1, 999, 1998, 1999}) {
+      const std::string text = json_program(2000, at, bad);
+      loaded = load_everywhere(json_path, text.substr(0, text.size() - 5) + ", {\"opcode\": \"Halt\" ]}");
+      assert(!loaded.ok && loaded.error != "unterminated insn object");
+    }
+  }
+  loaded = load_everywhere(json_path, json_program(500, std::nullopt, "").substr(0, 400) + "]}");
+  assert(!loaded.ok && loaded.error == "unterminated insn object");
+  loaded = load_everywhere(json_path, json_program(500, std::nullopt, "").substr(0, 400));
+  assert(!loaded.ok && loaded.error == "unterminated insns array");
+  loaded = load_everywhere(json_path, "{\"insns\": [ } ]}");
+  assert(!loaded.ok && loaded.error == "insns array is empty");
+
+  // validate_program: the same verdict for every chunking, wherever the bad insn is.
+  tisc::Program program;
+  for (std::size_t pc = 0; pc < 5000; ++pc) {
+    program.insns.push_back({tisc::Opcode::Add, static_cast<std::int64_t>(pc % 243), 1, 2});
+  }
+  program.insns.push_back({tisc::Opcode::Jump, 0, 0, 0});
+  for (const std::optional<std::size_t> bad : {std::optional<std::size_t>{}, std::optional<std::size_t>{0},
+                                               std::optional<std::size_t>{2500}, std::optional<std::size_t>{5000}}) {
+    auto p = program;
+    if (bad.has_value()) {
+      p.insns[*bad] = {tisc::Opcode::Jump, 5001, 0, 0};
+    }
+    const auto serial = vm::validate_program(p, {.threads = 1});
+    assert(serial.has_value() == bad.has_value());
+    for (const std::size_t threads : {2, 5, 16}) {
+      assert(vm::validate_program(p, {.threads = threads, .min_chunk_insns = 1}) == serial);
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(text_path, ec);
+  std::filesystem::remove(json_path, ec);
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/profile.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/validator.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  // main loops 50 times over a call into fn@6.
+  const auto program = make({
+      {Opcode::LoadImm, 0, 50, 0},
+      {Opcode::LoadImm, 5, 6, 0},
+      {Opcode::Call, 5, 0, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+      {Opcode::Inc, 1, 0, 0},
+      {Opcode::Ret, 0, 0, 0},
+  });
+  assert((vm::basic_block_leaders(program) == std::vector<std::size_t>{0, 2, 3, 5, 6}));
+
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    auto plain = vm::make_vm({.mode = mode});
+    plain->load_program(program);
+    assert(plain->run_to_halt().has_value());
+
+    vm::ProfilingVm profiled(vm::make_vm({.mode = mode}));
+    profiled.load_program(program);
+    assert(profiled.run_to_halt().has_value());
+
+    // Profiling is observation only: same state, trace and hash.
+    assert(vm::state_hash(profiled.state()) == vm::state_hash(plain->state()));
+
+    const auto& p = profiled.profile();
+    assert(p.steps == plain->state().trace.size());
+    assert(p.steps == 253);
+    std::uint64_t pc_cycles = 0;
+    for (std::size_t pc = 0; pc < p.by_pc.size(); ++pc) {
+      std::size_t traced = 0;
+      for (const auto& e : plain->state().trace) {
+        traced += e.pc == pc ? 1 : 0;
+      }
+      assert(p.by_pc[pc].count == traced);
+      pc_cycles += p.by_pc[pc].cycles;
+    }
+    assert(pc_cycles == p.cycles);
+    assert(p.by_opcode[static_cast<std::size_t>(Opcode::Inc)].count == 50);
+    assert(p.by_opcode[static_cast<std::size_t>(Opcode::Halt)].count == 1);
+
+    const std::vector<std::uint64_t> block_counts = {2, 50, 100, 1, 100};
+    assert(p.by_block.size() == block_counts.size());
+    for (std::size_t b = 0; b < block_counts.size(); ++b) {
+      assert(p.by_block[b].count == block_counts[b]);
+    }
+
+    // Call/Ret maintain a shadow stack: one callee path, entered at pc 6 from main.
+    assert(p.paths.size() == 2);
+    assert(p.paths[1].parent == 0 && p.paths[1].entry_pc == 6);
+
+    const auto report = vm::profile_report(p);
+    assert(report.starts_with("PROFILE steps=253 "));
+    assert(report.find("PROFILE_OPCODE Inc count=50 ") != std::string::npos);
+    assert(report.find("PROFILE_PC 6 Inc count=50 ") != std::string::npos);
+    assert(report.find("PROFILE_BLOCK 6-7 count=100 ") != std::string::npos);
+
+    const auto folded = vm::profile_folded(p);
+    for (const auto& line : {"t81vm;main;Call ", "t81vm;main;fn@6;Ret "}) {
+      assert(p.cycles == 0 || folded.find(line) != std::string::npos);
+    }
+  }
+
+  // Budget exhaustion and traps surface exactly as from the wrapped VM.
+  vm::ProfilingVm looping(vm::make_vm({}));
+  looping.load_program(make({{Opcode::Jump, 0, 0, 0}}));
+  auto res = looping.run_to_halt(10);
+  assert(!res.has_value() && res.error() == vm::Trap::TrapInstruction);
+  assert(looping.profile().steps == 10);
+
+  vm::ProfilingVm faulting(vm::make_vm({}));
+  faulting.load_program(make({{Opcode::Load, 0, 99999, 0}}));
+  res = faulting.run_to_halt();
+  assert(!res.has_value() && res.error() == vm::Trap::BoundsFault);
+  assert(faulting.profile().by_pc[0].count == 1);
+
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "t81/vm/program_cache.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+void write_file(const std::filesystem::path& path, const std::string& text) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  assert(out.good());
+  out << text;
+}
+
+bool same_image(const vm::LoadedProgram& x, const vm::LoadedProgram& y) {
+  if (x.program.axion_policy_text != y.program.axion_policy_text || x.program.insns.size() != y.program.insns.size() ||
+      x.preload_trap != y.preload_trap) {
+    return false;
+  }
+  for (std::size_t i = 0; i < x.program.insns.size(); ++i) {
+    const auto& p = x.program.insns[i];
+    const auto& q = y.program.insns[i];
+    if (p.opcode != q.opcode || p.a != q.a || p.b != q.b || p.c != q.c) {
+      return false;
+    }
+  }
+  const auto& s = x.initial_state;
+  const auto& t = y.initial_state;
+  const auto policy_tier = [](const vm::State& state) { return state.policy.has_value() ? state.policy->tier : -1; };
+  return s.layout.code.limit == t.layout.code.limit && s.layout.stack.limit == t.layout.stack.limit &&
+         s.layout.heap.limit == t.layout.heap.limit && s.layout.tensor.limit == t.layout.tensor.limit &&
+         s.layout.meta.start == t.layout.meta.start && s.layout.meta.limit == t.layout.meta.limit &&
+         s.memory.size() == t.memory.size() && s.sp == t.sp && s.heap_ptr == t.heap_ptr &&
+         policy_tier(s) == policy_tier(t);
+}
+
+std::uint64_t run_hash(const vm::LoadedProgram& image) {
+  auto machine = vm::make_interpreter_vm();
+  machine->load_image(image);
+  (void)machine->run_to_halt();
+  return vm::state_hash(machine->state());
+}
+
+std::vector<std::filesystem::path> entries(const std::filesystem::path& dir) {
+  std::vector<std::filesystem::path> out;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    out.push_back(entry.path());
+  }
+  return out;
+}
+
+}  // namespace
+
+int main() {
+  const auto root = std::filesystem::temp_directory_path() / "t81_vm_program_cache_test";
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root);
+  const auto dir = root / "cache";
+  const auto text = root / "program.t81vm";
+  const auto json = root / "program.tisc.json";
+
+  // Miss, then hit: the cached image equals a fresh load and runs to the same state.
+  write_file(text, "POLICY (policy (tier 2))\nLoadImm 0 5 0\nLoadImm 1 7 0\nAdd 2 0 1\nStore 1400 2 0\nHalt\n");
+  vm::ProgramCache cache(dir.string());
+  const auto fresh = vm::load_program_image_from_file(text.string());
+  const auto miss = cache.load(text.string());
+  assert(fresh.ok && miss.ok && !miss.cache_hit && same_image(miss.image, fresh.image));
+  assert(cache.stats().misses == 1 && cache.stats().stores == 1 && cache.stats().hits == 0);
+  assert(entries(dir).size() == 1);
+  const auto hit = cache.load(text.string());
+  assert(hit.ok && hit.cache_hit && hit.format == vm::ProgramFormat::TextV1);
+  assert(same_image(hit.image, fresh.image) && hit.image.initial_state.policy->tier == 2);
+  assert(run_hash(hit.image) == run_hash(fresh.image));
+  auto direct = vm::make_interpreter_vm();
+  direct->load_program(fresh.image.program);
+  (void)direct->run_to_halt();
+  assert(vm::state_hash(direct->state()) == run_hash(hit.image));
+  assert(cache.stats().hits == 1 && cache.stats().misses == 1);
+
+  // A preload trap and an absent policy are cached as such.
+  write_file(json, R"({"insns":[{"opcode":"Jump","a":99,"b":0,"c":0},{"opcode":"Halt","a":0,"b":0,"c":0}]})");
+  const auto trapped = cache.load(json.string());
+  assert(trapped.ok && !trapped.cache_hit && trapped.image.preload_trap.has_value());
+  const auto trapped_hit = vm::ProgramCache(dir.string()).load(json.string());
+  assert(trapped_hit.cache_hit && trapped_hit.format == vm::ProgramFormat::TiscJsonV1);
+  assert(same_image(trapped_hit.image, trapped.image) && !trapped_hit.image.initial_state.policy.has_value());
+  assert(run_hash(trapped_hit.image) == run_hash(trapped.image));
+
+  // The same bytes read as another format get their own entry.
+  const auto json_as_text = root / "program.txt";
+  std::filesystem::copy_file(json, json_as_text);
+  const auto as_text = cache.load(json_as_text.string());
+  assert(!as_text.ok && !as_text.cache_hit && entries(dir).size() == 2);
+
+  // Editing the source misses; load failures are reported and never stored.
+  write_file(text, "LoadImm 0 6 0\nHalt\n");
+  const auto edited = cache.load(text.string());
+  assert(edited.ok && !edited.cache_hit && edited.image.program.insns.size() == 2);
+  assert(cache.stats().stores == 3 && entries(dir).size() == 3);
+  write_file(text, "Frobnicate 1 2 3\n");
+  const auto stats = cache.stats();
+  const auto bad = cache.load(text.string());
+  assert(!bad.ok && bad.error == "unknown opcode in text program: Frobnicate");
+  assert(cache.stats().misses == stats.misses + 1 && cache.stats().stores == stats.stores);
+  const auto missing = cache.load((root / "missing.t81vm").string());
+  assert(!missing.ok && missing.error.rfind("unable to open file: ", 0) == 0);
+  assert(cache.stats().misses == stats.misses + 1);
+
+  // Sources that collided under a 64-bit word-wise FNV key (same size, two bytes apart)
+  // get separate entries, and each runs its own program.
+  const auto a = root / "a.t81vm";
+  const auto b = root / "b.t81vm";
+  write_file(a, "# ab\nLoadImm 0 5 0\nHalt\n# comment xxxxxaxxxxxxxa end\n");
+  write_file(b, "# ab\nLoadImm 0 0 0\nHalt\n# comment xxxxx\"xxxxxxx_ end\n");
+  assert(cache.load(a.string()).ok && cache.load(a.string()).cache_hit);
+  const auto other = cache.load(b.string());
+  assert(other.ok && !other.cache_hit && other.image.program.insns[0].b == 0);
+  assert(cache.load(b.string()).cache_hit && cache.load(b.string()).image.program.insns[0].b == 0);
+  assert(cache.load(a.string()).image.program.insns[0].b == 5);
+
+  // tisc-bin-v1 sources are cached too.
+  const auto bin = root / "program.tiscb";
+  write_file(bin, vm::encode_tisc_bin_v1(fresh.image.program));
+  assert(!cache.load(bin.string()).cache_hit);
+  const auto bin_hit = cache.load(bin.string());
+  assert(bin_hit.ok && bin_hit.cache_hit && bin_hit.format == vm::ProgramFormat::TiscBinV1);
+  assert(same_image(bin_hit.image, fresh.image));
+
+  // Damaged entries (header or instruction table) are rejected, reloaded and rewritten.
+  write_file(text, "LoadImm 0 6 0\nHalt\n");
+  std::filesystem::remove_all(dir);
+  assert(!cache.load(text.string()).cache_hit && entries(dir).size() == 1);
+  const auto entry = entries(dir)[0];
+  for (const std::size_t offset : {std::size_t{60}, vm::kProgramImageHeaderSize + vm::kTiscBinHeaderSize + 8}) {
+    std::string bytes;
+    {
+      std::ifstream in(entry, std::ios::binary);
+      bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bytes[offset] ^= 1;
+    write_file(entry, bytes);
+    const auto before = cache.stats();
+    const auto reloaded = cache.load(text.string());
+    assert(reloaded.ok && !reloaded.cache_hit && reloaded.image.program.insns[0].b == 6);
+    assert(cache.stats().invalid == before.invalid + 1 && cache.stats().stores == before.stores + 1);
+    assert(cache.load(text.string()).cache_hit);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(root, ec);
+  return 0;
+}
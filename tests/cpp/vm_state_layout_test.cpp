@@ -0,0 +1,56 @@
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/state.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+std::size_t offset(const vm::State& s, const void* field) {
+  return static_cast<std::size_t>(static_cast<const char*>(field) - reinterpret_cast<const char*>(&s));
+}
+
+}  // namespace
+
+int main() {
+  static_assert(std::is_base_of_v<vm::ExecContext, vm::State>);
+  static_assert(alignof(vm::State) == 64);
+
+  // The per-step scalars share the first cache line; the register file and its tags
+  // follow directly, ahead of every cold container.
+  const vm::State s;
+  for (const void* field : {static_cast<const void*>(&s.pc), static_cast<const void*>(&s.sp),
+                            static_cast<const void*>(&s.flags), static_cast<const void*>(&s.halted),
+                            static_cast<const void*>(&s.memory)}) {
+    assert(offset(s, field) < 64);
+  }
+  assert(offset(s, &s.registers) < 64);
+  assert(offset(s, &s.register_tags) == offset(s, &s.registers) + sizeof(s.registers));
+  assert(offset(s, &s.memory_pages) >= sizeof(vm::ExecContext));
+  assert(offset(s, &s.axion_log) > offset(s, &s.register_tags));
+
+  // Hosts keep reading and copying one flat State.
+  tisc::Program p;
+  p.insns = {
+      {tisc::Opcode::LoadImm, 0, 7, 0},
+      {tisc::Opcode::Push, 0, 0, 0},
+      {tisc::Opcode::Pop, 1, 0, 0},
+      {tisc::Opcode::Dec, 1, 0, 0},
+      {tisc::Opcode::Halt, 0, 0, 0},
+  };
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview, vm::ExecutionMode::Jit}) {
+    auto m = vm::make_vm({.mode = mode});
+    m->load_program(p);
+    assert(m->run_to_halt().has_value());
+    const vm::State copy = m->state();
+    assert(copy.halted && copy.pc == 5 && copy.registers[1] == 6 && copy.flags.positive);
+    assert(copy.sp == copy.layout.stack.limit && copy.memory.size() == copy.layout.total_size());
+    assert(vm::snapshot_summary(copy) == vm::snapshot_summary(m->state()));
+  }
+  return 0;
+}
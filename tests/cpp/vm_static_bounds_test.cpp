@@ -0,0 +1,66 @@
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine_parity.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+namespace {
+
+// A Store/Load round trip through `addr` (and a neighbouring word), then Halt.
+tisc::Program round_trip(std::int64_t addr) {
+  tisc::Program p;
+  p.insns = {
+      {tisc::Opcode::LoadImm, 0, 42, 0},
+      {tisc::Opcode::Store, addr, 0, 0},
+      {tisc::Opcode::Load, 1, addr, 0},
+      {tisc::Opcode::Store, addr + 1, 1, 0},
+      {tisc::Opcode::Load, 2, addr + 1, 0},
+      {tisc::Opcode::Halt, 0, 0, 0},
+  };
+  return p;
+}
+
+// Every engine resolves the same segment (or the same bounds trap) as the interpreter.
+void check(const tisc::Program& program) {
+  for (const auto axion : {vm::AxionLogLevel::All, vm::AxionLogLevel::Off}) {
+    for (const auto mode : {vm::ExecutionMode::AcceleratedPreview, vm::ExecutionMode::Jit, vm::ExecutionMode::Tiered}) {
+      check_against_interpreter(program, {.mode = mode, .axion_log = axion, .tier_up_threshold = 1}, 100000, 100000);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  // Layout for a 6-instruction program: code [0,6), stack [6,262), heap [262,1030),
+  // tensor [1030,1286), meta [1286,1542).
+  const std::vector<std::int64_t> in_range = {2, 6, 300, 1030, 1290, 1540};
+  const std::vector<std::string> segments = {"code", "stack", "heap", "tensor", "meta", "meta"};
+  for (std::size_t i = 0; i < in_range.size(); ++i) {
+    const auto program = round_trip(in_range[i]);
+    check(program);
+    auto m = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+    m->load_program(program);
+    assert(m->run_to_halt().has_value());
+    assert(m->state().registers[2] == 42);
+    assert(m->state().axion_log.front().reason() == "segment access " + segments[i]);
+  }
+
+  // Provably out-of-range accesses trap with the interpreter's payload and Axion event,
+  // including a round trip whose second Store runs off the end of memory.
+  for (const std::int64_t addr : {std::int64_t{-1}, std::int64_t{1541}, std::int64_t{1542}, std::int64_t{5000}}) {
+    const auto program = round_trip(addr);
+    check(program);
+    auto m = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+    m->load_program(program);
+    const auto res = m->run_to_halt();
+    assert(!res.has_value() && res.error() == vm::Trap::BoundsFault);
+    assert(m->state().axion_log.back().reason().starts_with("bounds fault segment=unknown"));
+  }
+  return 0;
+}
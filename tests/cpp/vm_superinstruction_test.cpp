@@ -0,0 +1,108 @@
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+std::vector<std::string> lines(const vm::State& s) {
+  std::vector<std::string> out;
+  for (const auto& e : s.trace) {
+    out.push_back(vm::trace_line(e));
+  }
+  return out;
+}
+
+// Fused pairs must be indistinguishable from single steps, including when the step
+// budget runs out between the two halves of a pair.
+void check_parity(const tisc::Program& program, std::size_t max_budget) {
+  for (std::size_t budget = 1; budget <= max_budget; ++budget) {
+    auto ref = vm::make_vm({.mode = vm::ExecutionMode::Interpreter});
+    auto fast = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+    ref->load_program(program);
+    fast->load_program(program);
+    const auto ref_res = ref->run_to_halt(budget);
+    const auto fast_res = fast->run_to_halt(budget);
+    assert(ref_res.has_value() == fast_res.has_value());
+    if (!ref_res.has_value()) {
+      assert(ref_res.error() == fast_res.error());
+    }
+    assert(lines(ref->state()) == lines(fast->state()));
+    assert(ref->state().flags.zero == fast->state().flags.zero);
+    assert(ref->state().flags.negative == fast->state().flags.negative);
+    assert(vm::state_hash(ref->state()) == vm::state_hash(fast->state()));
+  }
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  // The perf-check loop: LoadImm; Add and Dec; JumpIfNotZero.
+  check_parity(make({
+                   {Opcode::LoadImm, 0, 5, 0},
+                   {Opcode::LoadImm, 1, 1, 0},
+                   {Opcode::Add, 2, 2, 1},
+                   {Opcode::Dec, 0, 0, 0},
+                   {Opcode::JumpIfNotZero, 2, 0, 0},
+                   {Opcode::Halt, 0, 0, 0},
+               }),
+               24);
+
+  // Compare-and-branch idioms, counting r0 up to r1.
+  check_parity(make({
+                   {Opcode::LoadImm, 1, 4, 0},
+                   {Opcode::Inc, 0, 0, 0},
+                   {Opcode::Less, 2, 0, 1},
+                   {Opcode::JumpIfNotZero, 1, 0, 0},
+                   {Opcode::Cmp, 0, 1, 0},
+                   {Opcode::JumpIfZero, 7, 0, 0},
+                   {Opcode::Trap, 0, 0, 0},
+                   {Opcode::Equal, 3, 0, 1},
+                   {Opcode::JumpIfPositive, 10, 0, 0},
+                   {Opcode::Trap, 0, 0, 0},
+                   {Opcode::Halt, 0, 0, 0},
+               }),
+               24);
+
+  // A jump target on the second half blocks fusion; a register-indirect call into the
+  // second half of a fused pair still runs that instruction on its own.
+  check_parity(make({
+                   {Opcode::LoadImm, 5, 9, 0},
+                   {Opcode::LoadImm, 0, 3, 0},
+                   {Opcode::LoadImm, 1, 2, 0},
+                   {Opcode::Add, 2, 2, 1},
+                   {Opcode::Dec, 0, 0, 0},
+                   {Opcode::JumpIfNotZero, 3, 0, 0},
+                   {Opcode::Call, 5, 0, 0},
+                   {Opcode::Halt, 0, 0, 0},
+                   {Opcode::Dec, 4, 0, 0},
+                   {Opcode::JumpIfNegative, 10, 0, 0},
+                   {Opcode::Ret, 0, 0, 0},
+               }),
+               24);
+
+  // A fused pair whose branch falls off the end traps exactly like the interpreter.
+  check_parity(make({
+                   {Opcode::LoadImm, 0, 2, 0},
+                   {Opcode::Dec, 0, 0, 0},
+                   {Opcode::JumpIfZero, 1, 0, 0},
+               }),
+               8);
+
+  return 0;
+}
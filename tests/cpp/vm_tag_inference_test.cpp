@@ -0,0 +1,113 @@
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "engine_parity.hpp"
+#include "t81/vm/validator.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+namespace {
+
+// Runs `program` to completion under the interpreter and the pre-decoded engine, with
+// `reg` optionally overwritten by the host first, and requires identical results.
+void check_parity(const tisc::Program& program, int reg = -1, vm::ValueTag tag = vm::ValueTag::Int) {
+  auto ref = vm::make_vm({.mode = vm::ExecutionMode::Interpreter});
+  auto fast = vm::make_vm({.mode = vm::ExecutionMode::AcceleratedPreview});
+  ref->load_program(program);
+  fast->load_program(program);
+  if (reg >= 0) {
+    ref->set_register(reg, 7, tag);
+    fast->set_register(reg, 7, tag);
+  }
+  run_lockstep(*ref, *fast, 100000, 100000);
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+  using vm::TagCheck;
+
+  // Straight-line code: constructors fix the tag, Mov copies it, unwraps lose it.
+  const auto straight = make({
+      {Opcode::LoadImm, 0, 5, 0},
+      {Opcode::MakeOptionSome, 1, 0, 0},
+      {Opcode::OptionIsSome, 2, 1, 0},
+      {Opcode::OptionIsSome, 3, 0, 0},
+      {Opcode::Mov, 4, 1, 0},
+      {Opcode::OptionUnwrap, 5, 4, 0},
+      {Opcode::MakeResultOk, 6, 1, 0},
+      {Opcode::ResultUnwrapOk, 7, 6, 0},
+      {Opcode::OptionIsSome, 8, 7, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  const auto straight_checks = vm::infer_tag_checks(straight);
+  assert((straight_checks == std::vector<TagCheck>{TagCheck::None, TagCheck::None, TagCheck::Pass, TagCheck::Fail,
+                                                   TagCheck::None, TagCheck::Pass, TagCheck::None, TagCheck::Pass,
+                                                   TagCheck::Dynamic, TagCheck::None}));
+
+  // A join of Option and Int paths is only known at run time.
+  const auto merge = make({
+      {Opcode::LoadImm, 0, 1, 0},
+      {Opcode::Cmp, 0, 0, 0},
+      {Opcode::JumpIfZero, 4, 0, 0},
+      {Opcode::MakeOptionNone, 1, 0, 0},
+      {Opcode::ResultIsOk, 2, 1, 0},
+      {Opcode::OptionIsSome, 3, 1, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  const auto merge_checks = vm::infer_tag_checks(merge);
+  assert(merge_checks[4] == TagCheck::Fail && merge_checks[5] == TagCheck::Dynamic);
+
+  // Calls through LoadImm constants carry the caller's tags into the callee, whose Ret
+  // carries them back, even when the callee starts mid-block.
+  const auto call = make({
+      {Opcode::MakeEnumVariantPayload, 1, 0, 3},
+      {Opcode::LoadImm, 9, 6, 0},
+      {Opcode::Call, 9, 0, 0},
+      {Opcode::EnumIsVariant, 2, 1, 3},
+      {Opcode::EnumUnwrapPayload, 3, 1, 0},
+      {Opcode::Halt, 0, 0, 0},
+      {Opcode::Nop, 0, 0, 0},
+      {Opcode::EnumIsVariant, 4, 1, 2},
+      {Opcode::Ret, 0, 0, 0},
+  });
+  const auto call_checks = vm::infer_tag_checks(call);
+  assert(call_checks[3] == TagCheck::Pass && call_checks[4] == TagCheck::Pass && call_checks[7] == TagCheck::Pass);
+
+  // A Call through a loaded value cannot be resolved, so nothing is proven.
+  auto unresolved = call;
+  unresolved.insns[1] = {Opcode::Load, 9, 300, 0};
+  for (const auto check : vm::infer_tag_checks(unresolved)) {
+    assert(check == TagCheck::None || check == TagCheck::Dynamic);
+  }
+
+  // Programs without tag-checking instructions skip the pass.
+  assert(vm::infer_tag_checks(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Halt, 0, 0, 0}})) ==
+         (std::vector<TagCheck>{TagCheck::None, TagCheck::None}));
+
+  // Proven handlers are observably identical, including statically failing checks,
+  // missing payloads and host-written registers (which void the proof).
+  check_parity(straight);
+  check_parity(merge);
+  check_parity(call);
+  const auto queries = make({
+      {Opcode::LoadImm, 0, -4, 0},
+      {Opcode::MakeResultErr, 1, 0, 0},
+      {Opcode::ResultIsOk, 2, 1, 0},
+      {Opcode::ResultUnwrapErr, 3, 1, 0},
+      {Opcode::MakeOptionNone, 4, 0, 0},
+      {Opcode::OptionIsSome, 5, 4, 0},
+      {Opcode::OptionUnwrap, 6, 4, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  assert(vm::infer_tag_checks(queries)[6] == TagCheck::Pass);
+  check_parity(queries);
+  check_parity(queries, 4, vm::ValueTag::OptionHandle);
+  check_parity(call, 9, vm::ValueTag::Int);
+  check_parity(straight, 1, vm::ValueTag::EnumHandle);
+  return 0;
+}
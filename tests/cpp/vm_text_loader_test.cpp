@@ -0,0 +1,194 @@
+#include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/opcodes.hpp"
+#include "t81/vm/program_io.hpp"
+
+using namespace t81;
+
+namespace {
+
+std::string normalize(const std::string& raw) {
+  std::string s;
+  for (const char ch : raw) {
+    if (ch != '_' && ch != '-') {
+      s.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(ch))));
+    }
+  }
+  return s;
+}
+
+// Independent of the loader's table: every opcode by its to_string name, plus aliases.
+std::optional<tisc::Opcode> reference_opcode(const std::string& raw) {
+  static const std::vector<std::pair<std::string, tisc::Opcode>> kAliases = {
+      {"JMP", tisc::Opcode::Jump},  {"JZ", tisc::Opcode::JumpIfZero},    {"JNZ", tisc::Opcode::JumpIfNotZero},
+      {"JN", tisc::Opcode::JumpIfNegative}, {"JP", tisc::Opcode::JumpIfPositive}, {"LT", tisc::Opcode::Less},
+      {"LE", tisc::Opcode::LessEqual}, {"GT", tisc::Opcode::Greater}, {"GE", tisc::Opcode::GreaterEqual},
+      {"EQ", tisc::Opcode::Equal}, {"NEQ", tisc::Opcode::NotEqual},
+  };
+  const std::string s = normalize(raw);
+  for (int i = 0; i < 256; ++i) {
+    const auto op = static_cast<tisc::Opcode>(i);
+    if (std::string(tisc::to_string(op)) != "Unknown" && normalize(tisc::to_string(op)) == s) {
+      return op;
+    }
+  }
+  for (const auto& [alias, op] : kAliases) {
+    if (alias == s) {
+      return op;
+    }
+  }
+  return std::nullopt;
+}
+
+std::string trim(const std::string& in) {
+  std::size_t b = 0;
+  std::size_t e = in.size();
+  while (b < e && std::isspace(static_cast<unsigned char>(in[b]))) {
+    ++b;
+  }
+  while (e > b && std::isspace(static_cast<unsigned char>(in[e - 1]))) {
+    --e;
+  }
+  return in.substr(b, e - b);
+}
+
+// The istringstream-based Text V1 loader the scanner replaced, kept as the oracle.
+vm::ProgramLoadResult reference_load(const std::string& text) {
+  vm::ProgramLoadResult out;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    const std::string t = trim(line);
+    if (t.empty() || t[0] == '#') {
+      continue;
+    }
+    std::istringstream iss(t);
+    std::string op;
+    iss >> op;
+    if (op == "POLICY") {
+      std::string rest;
+      std::getline(iss, rest);
+      out.program.axion_policy_text = trim(rest);
+      continue;
+    }
+    std::int64_t a = 0;
+    std::int64_t b = 0;
+    std::int64_t c = 0;
+    iss >> a >> b >> c;
+    const auto opcode = reference_opcode(op);
+    if (!opcode.has_value()) {
+      out.error = "unknown opcode in text program: " + op;
+      return out;
+    }
+    out.program.insns.push_back({*opcode, a, b, c});
+  }
+  out.ok = true;
+  return out;
+}
+
+vm::ProgramLoadResult load(const std::filesystem::path& path, const std::string& text) {
+  {
+    std::ofstream out(path, std::ios::binary);
+    assert(out.good());
+    out << text;
+  }
+  return vm::load_program_from_file(path.string());
+}
+
+void expect_same(const std::filesystem::path& path, const std::string& text) {
+  const auto got = load(path, text);
+  const auto want = reference_load(text);
+  assert(got.format == vm::ProgramFormat::TextV1);
+  assert(got.ok == want.ok && got.error == want.error);
+  assert(got.program.axion_policy_text == want.program.axion_policy_text);
+  assert(got.program.insns.size() == want.program.insns.size());
+  for (std::size_t i = 0; i < want.program.insns.size(); ++i) {
+    const auto& x = got.program.insns[i];
+    const auto& y = want.program.insns[i];
+    assert(x.opcode == y.opcode && x.a == y.a && x.b == y.b && x.c == y.c);
+  }
+}
+
+std::string random_line(std::mt19937_64* rng) {
+  static const std::vector<std::string> kOps = {
+      "LoadImm", "LOAD_IMM", "load-imm", "Halt", "jmp", "JNZ", "j_n_z", "lt", "NEQ", "make_enum_variant_payload",
+      "I2Frac", "tsilu", "Bogus", "LoadImmX", "POLICY", "policy", "#", "MAKEENUMVARIANTPAYLOADX", "",
+  };
+  static const std::vector<std::string> kOperands = {
+      "0", "7", "-13", "+5", "+-5", "-+5", "--1", "-", "+", "5x", "0x10", "007", "abc", "1,2",
+      "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+      "99999999999999999999999", "(tier 2)",
+  };
+  static const std::vector<std::string> kSpaces = {" ", "  ", "\t", " \r", "\v", "\f", ""};
+  auto pick = [rng](const std::vector<std::string>& v) { return v[(*rng)() % v.size()]; };
+  std::string line = pick(kSpaces) + pick(kOps);
+  const int operands = static_cast<int>((*rng)() % 5);
+  for (int i = 0; i < operands; ++i) {
+    line += (i == 0 && (*rng)() % 8 == 0 ? "" : pick(kSpaces) + " ") + pick(kOperands);
+  }
+  return line + pick(kSpaces);
+}
+
+}  // namespace
+
+int main() {
+  const auto path = std::filesystem::temp_directory_path() / "t81_vm_text_loader_test.t81vm";
+
+  // Every opcode loads by its own name in any case/underscore spelling, and the aliases
+  // resolve.
+  for (int i = 0; i < 256; ++i) {
+    const auto op = static_cast<tisc::Opcode>(i);
+    const std::string name = tisc::to_string(op);
+    if (name == "Unknown") {
+      continue;
+    }
+    std::string lower;
+    for (const char ch : name) {
+      lower += std::string(1, static_cast<char>(std::tolower(static_cast<unsigned char>(ch)))) + "_";
+    }
+    const auto loaded = load(path, name + " 1 2 3\n" + lower + "\n");
+    assert(loaded.ok && loaded.program.insns.size() == 2);
+    assert(loaded.program.insns[0].opcode == op && loaded.program.insns[1].opcode == op);
+  }
+  expect_same(path, "JMP 1 0 0\nJZ 1\nJNZ 1\nJN 1\nJP 1\nLT 1 2 3\nLE\nGT\nGE\nEQ\nNEQ\n");
+
+  // Operand, policy and comment handling, and the unknown-opcode message.
+  expect_same(path,
+              "# header\n"
+              "  POLICY   (policy (tier 2))  \r\n"
+              "LoadImm 1 +7 -3 trailing words\n"
+              "LoadImm 2 5x 6\n"
+              "LoadImm 3 9223372036854775808 4 5\n"
+              "LoadImm 4 -9223372036854775809\n"
+              "\n\t\n"
+              "POLICY\n"
+              "Halt");
+  expect_same(path, "Halt 0 0 0\nNotAnOpcode 1 2 3\nHalt\n");
+  expect_same(path, "");
+
+  // Randomized agreement with the stream reader.
+  std::mt19937_64 rng(0x7E47C0DEULL);
+  for (int i = 0; i < 400; ++i) {
+    std::string text;
+    const int lines = 1 + static_cast<int>(rng() % 8);
+    for (int l = 0; l < lines; ++l) {
+      text += random_line(&rng) + (l + 1 < lines || rng() % 2 == 0 ? "\n" : "");
+    }
+    expect_same(path, text);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine_parity.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+using namespace t81::test;
+
+namespace {
+
+// Runs `program` under the interpreter and tiered mode, `chunk` steps at a time, and
+// returns the tier report.
+std::string check(const tisc::Program& program, vm::VmOptions options, std::size_t chunk, std::size_t total) {
+  options.mode = vm::ExecutionMode::Tiered;
+  return vm::tier_report(check_against_interpreter(program, options, chunk, total)->state());
+}
+
+// Every trace level, budget and threshold matches the interpreter, and the counters
+// do not depend on how the budget was split.
+void check_all(const tisc::Program& program, std::size_t total) {
+  const std::vector<vm::VmOptions> configs = {
+      {.trace = vm::TraceLevel::Full},
+      {.trace = vm::TraceLevel::Digest},
+      {.trace = vm::TraceLevel::None},
+      {.trace = vm::TraceLevel::FlightRecorder, .flight_recorder_depth = 5},
+      {.trace = vm::TraceLevel::None, .axion_log = vm::AxionLogLevel::Off},
+  };
+  for (auto options : configs) {
+    for (std::uint64_t threshold : {std::uint64_t{1}, std::uint64_t{2}, std::uint64_t{5}, std::uint64_t{1000}}) {
+      options.tier_up_threshold = threshold;
+      const std::string report = check(program, options, total, total);
+      for (std::size_t chunk : {std::size_t{1}, std::size_t{2}, std::size_t{3}, std::size_t{7}}) {
+        assert(check(program, options, chunk, total) == report);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  const auto loop = make({
+      {Opcode::LoadImm, 0, 6, 0},
+      {Opcode::LoadImm, 1, -3, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Store, 400, 2, 0},
+      {Opcode::Push, 2, 0, 0},
+      {Opcode::Pop, 3, 0, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::LoadImm, 16, 12, 0},
+      {Opcode::Call, 16, 0, 0},
+      {Opcode::Div, 5, 2, 1},
+      {Opcode::Halt, 0, 0, 0},
+      {Opcode::Inc, 17, 0, 0},
+      {Opcode::Ret, 0, 0, 0},
+  });
+  check_all(loop, 100);
+
+  // Faults trap identically whichever tier the faulting block is in.
+  check_all(make({
+                {Opcode::Inc, 0, 0, 0},
+                {Opcode::Push, 0, 0, 0},
+                {Opcode::Jump, 0, 0, 0},
+            }),
+            100000);
+  check_all(make({{Opcode::LoadImm, 0, 1, 0}, {Opcode::Inc, 0, 0, 0}}), 4);
+
+  // The interpreter keeps no tier counters.
+  auto ref = vm::make_vm({.mode = vm::ExecutionMode::Interpreter});
+  ref->load_program(loop);
+  assert(ref->run_to_halt().has_value() && ref->state().block_tiers.empty());
+
+  // The loop body is promoted on its third entry, after 2 + 6 + 6 steps; blocks entered
+  // fewer times stay on the reference path.
+  auto tiered = vm::make_vm({.mode = vm::ExecutionMode::Tiered, .tier_up_threshold = 3});
+  tiered->load_program(loop);
+  assert(tiered->run_to_halt().has_value());
+  const auto& blocks = tiered->state().block_tiers;
+  assert(blocks.size() == 5);
+  assert(blocks[0].begin == 0 && blocks[0].end == 2 && blocks[0].entries == 1 && blocks[0].tier == 0);
+  assert(blocks[1].begin == 2 && blocks[1].end == 8 && blocks[1].entries == 6);
+  assert(blocks[1].tier == 1 && blocks[1].promoted_at_step == 14);
+  assert(blocks[3].begin == 10 && blocks[3].entries == 1 && blocks[3].tier == 0);
+  assert(blocks[4].begin == 12 && blocks[4].entries == 1);
+  assert(vm::tier_report(tiered->state()).starts_with("TIER_REPORT blocks=5 promoted=1\n"));
+
+  // Reloading resets the counters.
+  tiered->load_program(loop);
+  assert(tiered->state().block_tiers[1].entries == 0 && tiered->state().block_tiers[1].tier == 0);
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/program_io.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+void write_file(const std::filesystem::path& path, const std::string& bytes) {
+  std::ofstream out(path, std::ios::binary);
+  assert(out.good());
+  out << bytes;
+}
+
+bool same(const tisc::Program& x, const tisc::Program& y) {
+  if (x.insns.size() != y.insns.size() || x.axion_policy_text != y.axion_policy_text) {
+    return false;
+  }
+  for (std::size_t i = 0; i < x.insns.size(); ++i) {
+    const auto& p = x.insns[i];
+    const auto& q = y.insns[i];
+    if (p.opcode != q.opcode || p.a != q.a || p.b != q.b || p.c != q.c) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string run(const tisc::Program& program) {
+  auto m = vm::make_interpreter_vm();
+  m->load_program(program);
+  (void)m->run_to_halt(10000);
+  return vm::snapshot_summary(m->state()) + vm::trap_payload_summary_line(m->state());
+}
+
+}  // namespace
+
+int main() {
+  const auto tmp_root = std::filesystem::temp_directory_path();
+  const auto text_path = tmp_root / "t81_vm_tisc_bin_test.t81vm";
+  const auto bin_path = tmp_root / "t81_vm_tisc_bin_test.tiscb";
+  // Detection is by magic number, not by extension.
+  const auto odd_path = tmp_root / "t81_vm_tisc_bin_test.t81vm.bak";
+
+  write_file(text_path,
+             "POLICY (policy (tier 2))\n"
+             "LoadImm 0 5 0\n"
+             "LoadImm 1 -3 0\n"
+             "Add 2 2 1\n"
+             "Store 600 2 0\n"
+             "Dec 0 0 0\n"
+             "JumpIfNotZero 2 0 0\n"
+             "Load 3 600 0\n"
+             "Halt 0 0 0\n");
+  const auto source = vm::load_program_from_file(text_path.string());
+  assert(source.ok && source.format == vm::ProgramFormat::TextV1);
+
+  const tisc::Program wide = [&] {
+    tisc::Program p = source.program;
+    p.insns.insert(p.insns.begin(), {tisc::Opcode::LoadImm, 9, std::numeric_limits<std::int64_t>::min(), 0});
+    return p;
+  }();
+
+  for (const auto* program : {&source.program, &wide}) {
+    const std::string bytes = vm::encode_tisc_bin_v1(*program);
+    assert(bytes.size() == vm::kTiscBinHeaderSize + program->insns.size() * vm::kTiscBinInsnSize +
+                               program->axion_policy_text.size());
+    assert(bytes.compare(0, 8, "T81TISCB") == 0);
+    write_file(odd_path, bytes);
+
+    const auto loaded = vm::load_program_from_file(odd_path.string());
+    assert(loaded.ok && loaded.format == vm::ProgramFormat::TiscBinV1);
+    assert(same(loaded.program, *program));
+    assert(vm::encode_tisc_bin_v1(loaded.program) == bytes);
+    assert(run(loaded.program) == run(*program));
+  }
+  assert(run(source.program).find("r3=-15") != std::string::npos);
+
+  // The mapped view reads the table in place and outlives the file's directory entry.
+  write_file(bin_path, vm::encode_tisc_bin_v1(source.program));
+  const auto mapped = vm::MappedProgram::open(bin_path.string());
+  assert(mapped.ok);
+  std::filesystem::remove(bin_path);
+  assert(mapped.program->spec_version() == vm::kTiscSpecVersion);
+  assert(mapped.program->axion_policy_text() == source.program.axion_policy_text);
+  assert(mapped.program->insns().size() == source.program.insns.size());
+  assert(mapped.program->insns()[3].opcode == tisc::Opcode::Store && mapped.program->insns()[3].a == 600);
+  assert(same(mapped.program->to_program(), source.program));
+
+  // Damaged containers are rejected with a reason.
+  const std::string good = vm::encode_tisc_bin_v1(source.program);
+  auto rejects = [&](std::string bytes, const std::string& reason) {
+    write_file(odd_path, bytes);
+    const auto loaded = vm::load_program_from_file(odd_path.string());
+    assert(!loaded.ok && loaded.format == vm::ProgramFormat::TiscBinV1);
+    assert(loaded.error.find(reason) != std::string::npos);
+  };
+  rejects(good.substr(0, 40), "truncated");
+  rejects(good.substr(0, good.size() - 1), "size mismatch");
+  rejects(good + "x", "size mismatch");
+  std::string flipped = good;
+  flipped[vm::kTiscBinHeaderSize + 8] ^= 1;
+  rejects(flipped, "checksum mismatch");
+  std::string bad_spec = good;
+  bad_spec[16 + 6] = '9';
+  rejects(bad_spec, "unsupported spec_version in binary program: tisc-v9");
+  std::string bad_version = good;
+  bad_version[8] = 2;
+  rejects(bad_version, "unsupported tisc-bin container version 2");
+
+  tisc::Program unknown = source.program;
+  unknown.insns[1].opcode = static_cast<tisc::Opcode>(0xFF);
+  rejects(vm::encode_tisc_bin_v1(unknown), "unknown opcode byte 255 at insn 1");
+
+  // Files without the magic keep extension dispatch.
+  write_file(odd_path, "Halt 0 0 0\n");
+  const auto text = vm::load_program_from_file(odd_path.string());
+  assert(text.ok && text.format == vm::ProgramFormat::TextV1 && text.program.insns.size() == 1);
+
+  std::error_code ec;
+  std::filesystem::remove(text_path, ec);
+  std::filesystem::remove(odd_path, ec);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+vm::TraceDigest digest_of(const vm::TraceLog& trace) {
+  vm::TraceDigest d;
+  for (const auto& e : trace) {
+    d.fold(e);
+  }
+  return d;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  const auto loop = make({
+      {Opcode::LoadImm, 0, 100, 0},
+      {Opcode::LoadImm, 1, 3, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Store, 300, 2, 0},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+  const auto fault = make({
+      {Opcode::LoadImm, 0, 4, 0},
+      {Opcode::Load, 1, 99999, 0},
+      {Opcode::Halt, 0, 0, 0},
+  });
+
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    for (const auto* program : {&loop, &fault}) {
+      auto full = vm::make_vm({.mode = mode});
+      auto digest = vm::make_vm({.mode = mode, .trace = vm::TraceLevel::Digest});
+      full->load_program(*program);
+      digest->load_program(*program);
+      const auto r_full = full->run_to_halt();
+      const auto r_digest = digest->run_to_halt();
+      assert(r_full == r_digest);
+
+      // The rolling digest equals a fold over the stored trace, without storing one.
+      const auto& fs = full->state();
+      const auto& ds = digest->state();
+      const auto expected = digest_of(fs.trace);
+      assert(fs.trace_digest.length == fs.trace.size());
+      assert(fs.trace_digest.value == expected.value);
+      assert(ds.trace.empty());
+      assert(ds.trace_digest.length == expected.length);
+      assert(ds.trace_digest.value == expected.value);
+
+      // V2 hashes agree across trace levels; V1 is unchanged for full-trace runs.
+      assert(vm::state_hash(fs, vm::StateHashVersion::V2) == vm::state_hash(ds, vm::StateHashVersion::V2));
+      assert(vm::state_hash(fs, vm::StateHashVersion::V1) == vm::state_hash(fs));
+      assert(vm::state_hash(fs, vm::StateHashVersion::V2) != vm::state_hash(fs));
+
+      const auto summary = vm::snapshot_summary(ds);
+      assert(summary.find("STATE_HASH_V2 0x") != std::string::npos);
+      assert(summary.find("STATE_HASH 0x") == std::string::npos);
+    }
+  }
+
+  // Step-by-step execution folds the same entries as run_to_halt.
+  {
+    auto stepped = vm::make_vm({.trace = vm::TraceLevel::Digest});
+    auto batch = vm::make_vm({.trace = vm::TraceLevel::Digest});
+    stepped->load_program(loop);
+    batch->load_program(loop);
+    while (!stepped->state().halted) {
+      assert(stepped->step().has_value());
+    }
+    assert(batch->run_to_halt().has_value());
+    assert(stepped->state().trace_digest.value == batch->state().trace_digest.value);
+    assert(stepped->state().trace_digest.length == batch->state().trace_digest.length);
+  }
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/trace_format.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+bool same_entry(const vm::TraceEntry& a, const vm::TraceEntry& b) {
+  return a.pc == b.pc && a.opcode == b.opcode && a.write_reg == b.write_reg && a.write_value == b.write_value &&
+         a.write_tag == b.write_tag && a.trap == b.trap;
+}
+
+std::string encode(const std::vector<vm::TraceEntry>& entries) {
+  std::ostringstream out;
+  vm::BinaryTraceWriter writer(out);
+  for (const auto& e : entries) {
+    writer.write(e);
+  }
+  writer.finish();
+  return out.str();
+}
+
+std::vector<vm::TraceEntry> decode(const std::string& bytes, std::string* error) {
+  std::istringstream in(bytes);
+  vm::BinaryTraceReader reader(in);
+  std::vector<vm::TraceEntry> out;
+  while (const auto e = reader.next()) {
+    out.push_back(*e);
+  }
+  *error = reader.error();
+  return out;
+}
+
+vm::TraceEntry entry(std::size_t pc, tisc::Opcode op, std::optional<std::size_t> reg = std::nullopt,
+                     std::optional<std::int64_t> value = std::nullopt, std::optional<vm::Trap> trap = std::nullopt) {
+  return vm::TraceEntry{
+      .pc = pc,
+      .opcode = op,
+      .write_reg = reg,
+      .write_value = value,
+      .write_tag = reg.has_value() ? std::optional<vm::ValueTag>(vm::ValueTag::Int) : std::nullopt,
+      .trap = trap,
+  };
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  // Irregular entries round-trip exactly: jumps, extreme values, the last register, traps.
+  {
+    const std::vector<vm::TraceEntry> entries = {
+        entry(0, Opcode::LoadImm, 0, std::numeric_limits<std::int64_t>::max()),
+        entry(1, Opcode::LoadImm, 0, std::numeric_limits<std::int64_t>::min()),
+        entry(7, Opcode::Nop),
+        entry(3, Opcode::Mov, 242, -1),
+        entry(std::size_t{1} << 40, Opcode::Jump),
+        entry(1, Opcode::Load, std::nullopt, std::nullopt, vm::Trap::BoundsFault),
+    };
+    std::string error;
+    const auto decoded = decode(encode(entries), &error);
+    assert(error.empty());
+    assert(decoded.size() == entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      assert(same_entry(decoded[i], entries[i]));
+    }
+  }
+
+  // A long-running loop collapses into repeat records and converts back to the exact
+  // canonical text the CLI prints with --trace.
+  {
+    tisc::Program p;
+    p.insns = {
+        {Opcode::LoadImm, 0, 5000, 0},
+        {Opcode::LoadImm, 1, 3, 0},
+        {Opcode::Add, 2, 2, 1},
+        {Opcode::Store, 300, 2, 0},
+        {Opcode::Dec, 0, 0, 0},
+        {Opcode::JumpIfNotZero, 2, 0, 0},
+        {Opcode::Div, 3, 1, 0},
+    };
+    auto machine = vm::make_interpreter_vm();
+    machine->load_program(p);
+    assert(!machine->run_to_halt().has_value());
+    const auto& trace = machine->state().trace;
+
+    std::ostringstream bin;
+    std::string text;
+    {
+      vm::BinaryTraceWriter writer(bin);
+      for (const auto& e : trace) {
+        writer.write(e);
+        text += vm::trace_line(e) + "\n";
+      }
+    }
+    assert(bin.str().size() < 128);
+    assert(bin.str().size() * 100 < text.size());
+
+    std::istringstream in(bin.str());
+    std::ostringstream converted;
+    assert(vm::convert_binary_trace_to_text(in, converted).empty());
+    assert(converted.str() == text);
+  }
+
+  // Malformed streams are reported, not misread.
+  {
+    std::string error;
+    assert(decode("not a trace", &error).empty() && error == "bad trace header");
+
+    auto bytes = encode({entry(0, Opcode::Nop)});
+    bytes[6] = 9;
+    assert(decode(bytes, &error).empty() && error == "unsupported trace version 9");
+
+    bytes = encode({entry(0, Opcode::LoadImm, 1, 2)});
+    bytes.pop_back();
+    assert(decode(bytes, &error).empty() && error == "truncated entry");
+
+    bytes = encode({entry(0, Opcode::Nop)});
+    bytes += std::string("\x80\x05\x01", 3);
+    const auto decoded = decode(bytes, &error);
+    assert(decoded.size() == 1 && error == "repeat record out of range");
+
+    // Registers past the register file (2^64 - 1, 2^28) are rejected before a delta is applied.
+    bytes = std::string("T81TRB\x01\x00\x13\x05", 10) + std::string(9, '\xff') + std::string("\x01\x02", 2);
+    assert(decode(bytes, &error).empty() && error == "register out of range");
+    bytes = std::string("T81TRB\x01\x00\x13\x05\x80\x80\x80\x80\x01\x02", 16);
+    assert(decode(bytes, &error).empty() && error == "register out of range");
+  }
+
+  return 0;
+}
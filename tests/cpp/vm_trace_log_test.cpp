@@ -0,0 +1,102 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/state.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+bool same_entry(const vm::TraceEntry& a, const vm::TraceEntry& b) {
+  return a.pc == b.pc && a.opcode == b.opcode && a.write_reg == b.write_reg && a.write_value == b.write_value &&
+         a.write_tag == b.write_tag && a.trap == b.trap;
+}
+
+vm::TraceEntry entry_for(std::size_t i) {
+  vm::TraceEntry e{
+      .pc = i,
+      .opcode = static_cast<tisc::Opcode>(i % 7),
+      .write_reg = std::nullopt,
+      .write_value = std::nullopt,
+      .write_tag = std::nullopt,
+      .trap = std::nullopt,
+  };
+  if (i % 3 != 0) {
+    e.write_reg = i % 243;
+    e.write_value = static_cast<std::int64_t>(i) * -977;
+    e.write_tag = static_cast<vm::ValueTag>(i % 7);
+  }
+  if (i % 10007 == 5) {
+    e.trap = vm::Trap::BoundsFault;
+  }
+  if (i % 30011 == 11) {
+    e.pc = std::size_t{1} << 40;
+  }
+  if (i % 40009 == 13) {
+    e.write_reg = std::size_t{70000};
+  }
+  return e;
+}
+
+}  // namespace
+
+int main() {
+  // Round-trips every logical field, across chunk boundaries and through the side table.
+  {
+    const std::size_t n = vm::TraceLog::kChunkRecords * 2 + 123;
+    vm::TraceLog log;
+    assert(log.empty());
+    for (std::size_t i = 0; i < n; ++i) {
+      log.push_back(entry_for(i));
+    }
+    assert(log.size() == n);
+    assert(same_entry(log.back(), entry_for(n - 1)));
+    std::size_t i = 0;
+    for (const auto& e : log) {
+      assert(same_entry(e, entry_for(i)));
+      ++i;
+    }
+    assert(i == n);
+
+    const vm::TraceLog copy = log;
+    assert(copy.size() == n);
+    assert(same_entry(copy[vm::TraceLog::kChunkRecords], entry_for(vm::TraceLog::kChunkRecords)));
+    assert(same_entry(copy[10007 + 5], entry_for(10007 + 5)));
+
+    log.clear();
+    assert(log.empty());
+    assert(copy.size() == n);
+  }
+
+  // The packed trace keeps STATE_HASH identical to a fold over the logical entries.
+  {
+    tisc::Program p;
+    p.insns = {
+        {tisc::Opcode::LoadImm, 0, 40, 0},
+        {tisc::Opcode::Dec, 0, 0, 0},
+        {tisc::Opcode::JumpIfNotZero, 1, 0, 0},
+        {tisc::Opcode::Load, 1, 99999, 0},
+    };
+    auto machine = vm::make_interpreter_vm();
+    machine->load_program(p);
+    assert(!machine->run_to_halt().has_value());
+    const auto& s = machine->state();
+    assert(s.trace.back().trap == vm::Trap::BoundsFault);
+
+    vm::TraceDigest digest;
+    for (const auto& e : s.trace) {
+      digest.fold(e);
+    }
+    assert(digest.length == s.trace_digest.length);
+    assert(digest.value == s.trace_digest.value);
+  }
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cstddef>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/program.hpp"
+#include "t81/vm/summary.hpp"
+#include "t81/vm/trace_sink.hpp"
+#include "t81/vm/vm.hpp"
+
+using namespace t81;
+
+namespace {
+
+class CollectingSink final : public vm::ITraceSink {
+ public:
+  void on_entries(std::span<const vm::TraceEntry> batch) override {
+    ++batches;
+    entries.insert(entries.end(), batch.begin(), batch.end());
+  }
+
+  std::size_t batches = 0;
+  std::vector<vm::TraceEntry> entries;
+};
+
+tisc::Program make(std::vector<tisc::Insn> insns) {
+  tisc::Program p;
+  p.insns = std::move(insns);
+  return p;
+}
+
+std::string expected_text(const vm::TraceLog& trace) {
+  std::string out;
+  for (const auto& e : trace) {
+    out += vm::trace_line(e) + "\n";
+  }
+  return out;
+}
+
+}  // namespace
+
+int main() {
+  using tisc::Opcode;
+
+  const auto program = make({
+      {Opcode::LoadImm, 0, 500, 0},
+      {Opcode::LoadImm, 1, 3, 0},
+      {Opcode::Add, 2, 2, 1},
+      {Opcode::Dec, 0, 0, 0},
+      {Opcode::JumpIfNotZero, 2, 0, 0},
+      {Opcode::Load, 3, 99999, 0},
+  });
+
+  // Streamed entries match the stored trace for every mode and trace level that records.
+  for (const auto mode : {vm::ExecutionMode::Interpreter, vm::ExecutionMode::AcceleratedPreview}) {
+    auto reference = vm::make_vm({.mode = mode});
+    reference->load_program(program);
+    assert(!reference->run_to_halt().has_value());
+    const auto text = expected_text(reference->state().trace);
+
+    for (const auto level : {vm::TraceLevel::Full, vm::TraceLevel::Digest}) {
+      CollectingSink sink;
+      auto machine = vm::make_vm({.mode = mode, .trace = level});
+      machine->set_trace_sink(&sink);
+      machine->load_program(program);
+      assert(!machine->run_to_halt().has_value());
+      assert(sink.batches > 1);
+      std::string streamed;
+      for (const auto& e : sink.entries) {
+        streamed += vm::trace_line(e) + "\n";
+      }
+      assert(streamed == text);
+      assert(sink.entries.back().trap == vm::Trap::BoundsFault);
+    }
+
+    // No trace level means nothing is produced.
+    CollectingSink silent;
+    auto bare = vm::make_vm({.mode = mode, .trace = vm::TraceLevel::None});
+    bare->set_trace_sink(&silent);
+    bare->load_program(program);
+    assert(!bare->run_to_halt().has_value());
+    assert(silent.entries.empty());
+  }
+
+  // step() delivers its entry before returning; detaching stops delivery.
+  {
+    CollectingSink sink;
+    auto machine = vm::make_interpreter_vm();
+    machine->set_trace_sink(&sink);
+    machine->load_program(program);
+    assert(machine->step().has_value());
+    assert(sink.entries.size() == 1);
+    machine->set_trace_sink(nullptr);
+    assert(machine->step().has_value());
+    assert(sink.entries.size() == 1);
+    assert(machine->state().trace.size() == 2);
+  }
+
+  // The background file sink writes the canonical text, including under ring backpressure.
+  for (const std::size_t capacity : {std::size_t{4}, std::size_t{1} << 16}) {
+    const std::string path = "build/vm_trace_sink_test.trace";
+    auto machine = vm::make_interpreter_vm();
+    machine->load_program(program);
+    {
+      vm::FileTraceSink sink(path, capacity);
+      assert(sink.ok());
+      machine->set_trace_sink(&sink);
+      assert(!machine->run_to_halt().has_value());
+      machine->set_trace_sink(nullptr);
+      sink.flush();
+    }
+    std::ifstream in(path);
+    std::stringstream written;
+    written << in.rdbuf();
+    assert(written.str() == expected_text(machine->state().trace));
+  }
+
+  assert(!vm::FileTraceSink("build/no-such-dir/trace.txt").ok());
+
+  return 0;
+}